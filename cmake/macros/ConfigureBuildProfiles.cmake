@@ -0,0 +1,180 @@
+#
+# This file is part of the WarheadApp Project. See AUTHORS file for Copyright information
+#
+# This file is free software; as a special exception the author gives
+# unlimited permission to copy and/or distribute it, with or without
+# modifications, as long as this notice is preserved.
+#
+# This program is distributed in the hope that it will be useful, but
+# WITHOUT ANY WARRANTY, to the extent permitted by law; without even the
+# implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+#
+
+
+# Build profiles for production binaries: WITH_LTO, WITH_PGO and WITH_NATIVE_ARCH.
+# Everything here must be set up before the dep and src directories are added,
+# so fmt, Poco and our own targets are built the same way.
+#
+# Two stage PGO:
+#   cmake -DWITH_PGO=generate . && cmake --build . && cmake --build . --target pgo-train
+#   cmake -DWITH_PGO=use . && cmake --build .
+# The profile data stays in PGO_PROFILE_DIR between both stages.
+
+include(CheckCXXCompilerFlag)
+include(CheckCXXSourceRuns)
+include(CheckIPOSupported)
+
+# clang-cl takes MSVC style flags
+if(MSVC)
+  set(WH_MSVC_FRONTEND 1)
+else()
+  set(WH_MSVC_FRONTEND 0)
+endif()
+
+if(WITH_LTO)
+  check_ipo_supported(RESULT WH_IPO_SUPPORTED OUTPUT WH_IPO_ERROR LANGUAGES C CXX)
+
+  if(WH_IPO_SUPPORTED)
+    # Applies to every target created from here on
+    set(CMAKE_INTERPROCEDURAL_OPTIMIZATION ON)
+
+    target_compile_definitions(warhead-compile-option-interface
+      INTERFACE
+        -DWH_WITH_LTO)
+
+    message(STATUS "Build profile: link time optimization enabled")
+  else()
+    message(WARNING "Build profile: link time optimization is not supported by this toolchain (${WH_IPO_ERROR})")
+  endif()
+endif()
+
+if(WITH_NATIVE_ARCH)
+  if(WH_MSVC_FRONTEND)
+    # MSVC has no -march=native, use AVX2 when the build machine can run it
+    set(CMAKE_REQUIRED_FLAGS "/arch:AVX2")
+    check_cxx_source_runs("
+      #include <immintrin.h>
+      int main()
+      {
+          __m256i value = _mm256_set1_epi32(1);
+          value = _mm256_add_epi32(value, value);
+          return _mm256_extract_epi32(value, 0) == 2 ? 0 : 1;
+      }" WH_NATIVE_ARCH_AVX2)
+    unset(CMAKE_REQUIRED_FLAGS)
+
+    if(WH_NATIVE_ARCH_AVX2)
+      set(WH_NATIVE_ARCH_FLAG "/arch:AVX2")
+    endif()
+  else()
+    check_cxx_compiler_flag("-march=native" WH_NATIVE_ARCH_MARCH)
+
+    if(WH_NATIVE_ARCH_MARCH)
+      set(WH_NATIVE_ARCH_FLAG "-march=native")
+    endif()
+  endif()
+
+  if(WH_NATIVE_ARCH_FLAG)
+    target_compile_options(warhead-compile-option-interface
+      INTERFACE
+        ${WH_NATIVE_ARCH_FLAG})
+
+    target_compile_definitions(warhead-compile-option-interface
+      INTERFACE
+        -DWH_WITH_NATIVE_ARCH)
+
+    message(STATUS "Build profile: native architecture enabled (${WH_NATIVE_ARCH_FLAG})")
+  else()
+    message(WARNING "Build profile: no native architecture flag available for this compiler and machine")
+  endif()
+endif()
+
+if(WITH_PGO STREQUAL "generate" OR WITH_PGO STREQUAL "use")
+  file(MAKE_DIRECTORY ${PGO_PROFILE_DIR})
+
+  if(WH_MSVC_FRONTEND AND CMAKE_CXX_COMPILER_ID STREQUAL "MSVC")
+    # The profile is collected per image, /GL is required for both stages
+    target_compile_options(warhead-compile-option-interface
+      INTERFACE
+        /GL)
+
+    if(WITH_PGO STREQUAL "generate")
+      add_link_options(/LTCG /GENPROFILE:PGD=${PGO_PROFILE_DIR}/$<TARGET_PROPERTY:NAME>.pgd)
+    else()
+      add_link_options(/LTCG /USEPROFILE:PGD=${PGO_PROFILE_DIR}/$<TARGET_PROPERTY:NAME>.pgd)
+    endif()
+  elseif(CMAKE_CXX_COMPILER_ID MATCHES "Clang")
+    if(WITH_PGO STREQUAL "generate")
+      set(WH_PGO_FLAGS "-fprofile-instr-generate=${PGO_PROFILE_DIR}/%p.profraw")
+    else()
+      set(WH_PGO_FLAGS "-fprofile-instr-use=${PGO_PROFILE_DIR}/default.profdata")
+    endif()
+
+    find_program(LLVM_PROFDATA_EXECUTABLE llvm-profdata)
+  else()
+    if(WITH_PGO STREQUAL "generate")
+      # Atomic counters, the workloads are multithreaded
+      set(WH_PGO_FLAGS -fprofile-generate=${PGO_PROFILE_DIR} -fprofile-update=atomic)
+    else()
+      set(WH_PGO_FLAGS -fprofile-use=${PGO_PROFILE_DIR} -fprofile-correction -Wno-missing-profile)
+    endif()
+  endif()
+
+  if(WH_PGO_FLAGS)
+    target_compile_options(warhead-compile-option-interface
+      INTERFACE
+        ${WH_PGO_FLAGS})
+
+    # clang-cl objects pull in the profile runtime themselves, link.exe does not take these flags
+    if(NOT WH_MSVC_FRONTEND)
+      target_link_options(warhead-compile-option-interface
+        INTERFACE
+          ${WH_PGO_FLAGS})
+    endif()
+  endif()
+
+  if(WITH_PGO STREQUAL "generate")
+    target_compile_definitions(warhead-compile-option-interface
+      INTERFACE
+        -DWH_WITH_PGO_GENERATE)
+  else()
+    target_compile_definitions(warhead-compile-option-interface
+      INTERFACE
+        -DWH_WITH_PGO_USE)
+  endif()
+
+  message(STATUS "Build profile: profile guided optimization, stage '${WITH_PGO}' (${PGO_PROFILE_DIR})")
+elseif(NOT WITH_PGO STREQUAL "off")
+  message(FATAL_ERROR "WITH_PGO must be off, generate or use (got '${WITH_PGO}')")
+endif()
+
+# Runs a training workload of an instrumented build, the profile lands in PGO_PROFILE_DIR.
+# Clang profiles are merged into the file the use stage reads.
+#
+# Use it like:
+# AddPGOTrainingTarget(Lab)
+#
+function(AddPGOTrainingTarget targetName)
+  if(NOT WITH_PGO STREQUAL "generate")
+    return()
+  endif()
+
+  if(NOT TARGET pgo-train)
+    add_custom_target(pgo-train
+      COMMENT "Running PGO training workloads")
+  endif()
+
+  add_custom_target(pgo-train-${targetName}
+    COMMAND $<TARGET_FILE:${targetName}>
+    WORKING_DIRECTORY ${PGO_PROFILE_DIR}
+    DEPENDS ${targetName}
+    COMMENT "PGO training run of ${targetName}")
+
+  add_dependencies(pgo-train pgo-train-${targetName})
+
+  if(LLVM_PROFDATA_EXECUTABLE AND NOT TARGET pgo-merge)
+    add_custom_target(pgo-merge
+      COMMAND ${LLVM_PROFDATA_EXECUTABLE} merge -output=${PGO_PROFILE_DIR}/default.profdata ${PGO_PROFILE_DIR}
+      DEPENDS pgo-train
+      COMMENT "Merging PGO profiles")
+  endif()
+endfunction()
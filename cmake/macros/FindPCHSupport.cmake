@@ -0,0 +1,26 @@
+#
+# This file is part of the WarheadApp Project. See AUTHORS file for Copyright information
+#
+# This file is free software; as a special exception the author gives
+# unlimited permission to copy and/or distribute it, with or without
+# modifications, as long as this notice is preserved.
+#
+# This program is distributed in the hope that it will be useful, but
+# WITHOUT ANY WARRANTY, to the extent permitted by law; without even the
+# implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+#
+
+
+# Adds a precompiled header to every target in the list.
+# The header is force included into each C++ source of the target.
+#
+# Use it like:
+# add_cxx_pch(common PrecompiledHeaders/commonPCH.h)
+#
+function(ADD_CXX_PCH TARGET_NAME_LIST PCH_HEADER)
+  foreach(TARGET_NAME ${TARGET_NAME_LIST})
+    target_precompile_headers(${TARGET_NAME}
+      PRIVATE
+        ${PCH_HEADER})
+  endforeach()
+endfunction()
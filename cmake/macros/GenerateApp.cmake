@@ -45,5 +45,14 @@ macro(GenerateApp dir appName)
       FOLDER
         ${appName})
 
+  # Apps may bring their own PrecompiledHeaders/<app>PCH.h, otherwise the common one is used
+  if(USE_COREPCH)
+    if(EXISTS ${dir}/PrecompiledHeaders/${appName}PCH.h)
+      add_cxx_pch(${appName} ${dir}/PrecompiledHeaders/${appName}PCH.h)
+    else()
+      add_cxx_pch(${appName} ${CMAKE_SOURCE_DIR}/src/common/PrecompiledHeaders/commonPCH.h)
+    endif()
+  endif()
+
   install(TARGETS ${appName} DESTINATION "${CMAKE_INSTALL_PREFIX}")
 endmacro()
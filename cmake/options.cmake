@@ -12,6 +12,19 @@
 
 option(WITH_DYNAMIC_LINKING "Enable dynamic library linking."   0)
 option(WITH_WARNINGS        "Show all warnings during compile"  0)
+option(USE_COREPCH          "Use precompiled headers when compiling common and apps" 1)
+option(USE_POCO_UNITY_BUILD "Build Poco Foundation as a unity build (experimental, exclusion list not validated with MSVC)" 0)
+option(WITH_LTO             "Enable link time optimization for all targets" 0)
+option(WITH_NATIVE_ARCH     "Optimize for the CPU of the build machine, binaries may not run elsewhere" 0)
+option(WITH_TESTS           "Build the Tests app and register it with CTest" 1)
+
+set(WITH_PGO                "off" CACHE STRING "Profile guided optimization stage: off, generate (instrument) or use (optimize)")
+set_property(CACHE WITH_PGO PROPERTY STRINGS off generate use)
+set(PGO_PROFILE_DIR         "${CMAKE_BINARY_DIR}/pgo" CACHE PATH "Directory of the PGO profile data")
+
+set(WITH_ALLOCATOR          "system" CACHE STRING "Global operator new/delete: system (CRT malloc) or builtin (thread caching size classes)")
+set_property(CACHE WITH_ALLOCATOR PROPERTY STRINGS system builtin)
+option(WITH_ALLOCATION_STATS "Count allocations per thread and per tag, the report is printed at exit" 0)
 
 if (WITH_DYNAMIC_LINKING)
   set(BUILD_SHARED_LIBS ON)
@@ -10,6 +10,54 @@ else()
   message("* Show compile-warnings  : No  (default)")
 endif()
 
+if( USE_COREPCH )
+  message("* Build with PCH         : Yes (default)")
+else()
+  message("* Build with PCH         : No")
+endif()
+
+if( USE_POCO_UNITY_BUILD )
+  message("* Poco unity build       : Yes (experimental)")
+else()
+  message("* Poco unity build       : No  (default)")
+endif()
+
+if( WITH_LTO )
+  message("* Link time optimization : Yes")
+else()
+  message("* Link time optimization : No  (default)")
+endif()
+
+if( NOT WITH_PGO STREQUAL "off" )
+  message("* PGO stage              : ${WITH_PGO} (${PGO_PROFILE_DIR})")
+else()
+  message("* PGO stage              : off (default)")
+endif()
+
+if( WITH_NATIVE_ARCH )
+  message("* Native architecture    : Yes")
+else()
+  message("* Native architecture    : No  (default)")
+endif()
+
+if( WITH_TESTS )
+  message("* Build tests            : Yes (default)")
+else()
+  message("* Build tests            : No")
+endif()
+
+if( WITH_ALLOCATOR STREQUAL "builtin" )
+  message("* Allocator              : builtin")
+else()
+  message("* Allocator              : system (default)")
+endif()
+
+if( WITH_ALLOCATION_STATS )
+  message("* Allocation stats       : Yes")
+else()
+  message("* Allocation stats       : No  (default)")
+endif()
+
 if( NOT WITH_SOURCE_TREE STREQUAL "no" )
   message("* Show source tree       : Yes (${WITH_SOURCE_TREE})")
 else()
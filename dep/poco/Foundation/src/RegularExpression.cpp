@@ -41,14 +41,21 @@ RegularExpression::RegularExpression(const std::string& pattern, int options, bo
 		throw RegularExpressionException(msg.str());
 	}
 	if (study)
-		_extra = pcre_study(reinterpret_cast<pcre*>(_pcre), 0, &error);
+	{
+		// use the JIT compiler if the PCRE build supports it
+		int jit = 0;
+		int studyOptions = 0;
+		if (pcre_config(PCRE_CONFIG_JIT, &jit) == 0 && jit)
+			studyOptions |= PCRE_STUDY_JIT_COMPILE;
+		_extra = pcre_study(reinterpret_cast<pcre*>(_pcre), studyOptions, &error);
+	}
 }
 
 
 RegularExpression::~RegularExpression()
 {
 	if (_pcre)  pcre_free(reinterpret_cast<pcre*>(_pcre));
-	if (_extra) pcre_free(reinterpret_cast<struct pcre_extra*>(_extra));
+	if (_extra) pcre_free_study(reinterpret_cast<struct pcre_extra*>(_extra));
 }
 
 
@@ -1,16 +1,50 @@
+#include "Allocator.h"
+#include "Arena.h"
+#include "AsyncIO.h"
+#include "CachedMemoryPool.h"
 #include "Common.h"
+#include "ConcurrentCache.h"
+#include "ConcurrentObjectPool.h"
+#include "CryptoHash.h"
+#include "Encoding.h"
+#include "FlatHashMap.h"
+#include "FileView.h"
+#include "GitRevision.h"
+#include "MPMCNotificationQueue.h"
 #include "StringConvert.h"
 #include "StringFormat.h"
+#include "TaskScheduler.h"
 #include "Timer.h"
+#include "TimerWheel.h"
+#include "XXHash.h"
 #include "Log.h"
+#include <Poco/Base64Decoder.h>
+#include <Poco/Base64Encoder.h>
+#include <Poco/HashMap.h>
+#include <Poco/HexBinaryEncoder.h>
+#include <Poco/LRUCache.h>
+#include <Poco/MemoryPool.h>
+#include <Poco/NotificationQueue.h>
+#include <Poco/ObjectPool.h>
+#include <Poco/TimedNotificationQueue.h>
 #include <iostream>
+#include <map>
+#include <unordered_map>
 #include <fstream>
+#include <sstream>
 #include <filesystem>
 #include <random>
 #include <vector>
 #include <algorithm>
+#include <atomic>
+#include <mutex>
 #include <thread>
 
+#if WH_PLATFORM == WH_PLATFORM_WINDOWS
+#include <Windows.h>
+#include <psapi.h>
+#endif
+
 namespace fs = std::filesystem;
 
 namespace
@@ -27,12 +61,10 @@ namespace
     constexpr auto numbersMax = 2000;
 }
 
-inline auto GetTimeDiff(SystemTimePoint timePoint)
+// Microseconds elapsed since startTime (Warhead::Time::Now() value)
+inline uint64 GetTimeDiff(uint64 startTime)
 {
-    using namespace std::chrono;
-    // Get End Time
-    auto end = system_clock::now();
-    return duration_cast<Microseconds>(end - timePoint).count();
+    return (Warhead::Time::Now() - startTime) / 1000;
 }
 
 void GenerateFile()
@@ -42,7 +74,7 @@ void GenerateFile()
     std::ofstream file(path);
 
     // Get start time
-    auto startTime = std::chrono::system_clock::now();
+    auto startTime = Warhead::Time::Now();
     std::random_device random_device; // Source of entropy
     std::mt19937 generator(random_device()); // ГСЧ
 
@@ -60,31 +92,222 @@ void GenerateFile()
     fmt::print("# -- File created in {}\n", Warhead::Time::ToTimeString<Microseconds>(GetTimeDiff(startTime), TimeOutput::Microseconds));
 }
 
+void HashFile()
+{
+    using Warhead::Crypto::HashAlgorithm;
+
+    std::pair<HashAlgorithm, std::string_view> const algorithms[] =
+    {
+        { HashAlgorithm::MD5,    "MD5"    },
+        { HashAlgorithm::SHA1,   "SHA1"   },
+        { HashAlgorithm::SHA256, "SHA256" },
+        { HashAlgorithm::XXH64,  "XXH64"  },
+        { HashAlgorithm::XXH3,   "XXH3"   }
+    };
+
+    double fileSize = double(Warhead::File::GetFileSize(FILE_PATH));
+
+    for (auto const& [algorithm, name] : algorithms)
+    {
+        auto startTime = Warhead::Time::Now();
+        auto hash = Warhead::Crypto::GetHashFromFile(FILE_PATH, algorithm);
+        auto elapsed = Warhead::Time::Now() - startTime;
+
+        fmt::print("# -- {:<6} {} in {} ({:.2f} GB/s)\n", name, hash,
+            Warhead::Time::ToTimeString<Microseconds>(elapsed / 1000, TimeOutput::Microseconds), fileSize / double(elapsed));
+    }
+
+    // The file reads above bound the non-cryptographic hashes, measure them on a cached buffer too
+    constexpr std::size_t SIZE = 1024 * 1024;
+    constexpr uint32 ROUNDS = 256;
+
+    std::vector<uint8> data(SIZE);
+    std::mt19937 generator(1);
+    for (auto& byte : data)
+        byte = uint8(generator());
+
+    auto measure = [&](auto&& hash)
+    {
+        uint64 result = 0;
+        auto startTime = Warhead::Time::Now();
+
+        for (uint32 i = 0; i < ROUNDS; ++i)
+            result ^= hash(data.data(), data.size());
+
+        double speed = double(SIZE) * ROUNDS / double(Warhead::Time::Now() - startTime);
+        return std::make_pair(speed, result);
+    };
+
+    auto [xxh64, xxh64Result] = measure([](void const* input, std::size_t size) { return Warhead::Crypto::XXH64::Hash(input, size); });
+    auto [xxh3, xxh3Result] = measure([](void const* input, std::size_t size) { return Warhead::Crypto::XXH3::Hash(input, size); });
+
+    fmt::print("# -- In memory: XXH64 {:.2f} GB/s, XXH3 {:.2f} GB/s ({:x}, {:x})\n", xxh64, xxh3, xxh64Result, xxh3Result);
+}
+
+// Bytes in the process working set, 0 where it can't be read
+std::size_t GetWorkingSetSize()
+{
+#if WH_PLATFORM == WH_PLATFORM_WINDOWS
+    PROCESS_MEMORY_COUNTERS counters{};
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        return counters.WorkingSetSize;
+#endif
+    return 0;
+}
+
+void ReadFile()
+{
+    // The old GetFileText: stream into a growing stringbuf, then copy it out
+    auto readStream = [](std::string const& path)
+    {
+        std::ifstream in(path);
+        std::ostringstream ss;
+        ss << in.rdbuf();
+        return ss.str();
+    };
+
+    std::size_t sizes[4] = {};
+    uint64 times[4] = {};
+    std::size_t peaks[4] = {};
+    uint64 allocated[4] = {};
+
+    auto measure = [&](std::size_t index, auto&& read)
+    {
+        auto startTime = Warhead::Time::Now();
+        sizes[index] = read();
+        times[index] = Warhead::Time::Now() - startTime;
+
+        // Second run for memory. PeakWorkingSetSize can't be reset between cases,
+        // so the working set is sampled from another thread while the read runs.
+        std::size_t const baseline = GetWorkingSetSize();
+        std::size_t peak = baseline;
+        std::atomic<bool> done = false;
+
+        std::thread sampler([&]()
+        {
+            do
+            {
+                peak = std::max(peak, GetWorkingSetSize());
+                std::this_thread::yield();
+            } while (!done.load(std::memory_order_acquire));
+        });
+
+        uint64 const allocatedBefore = Warhead::Memory::GetAllocationStats().BytesAllocated;
+        read();
+        allocated[index] = Warhead::Memory::GetAllocationStats().BytesAllocated - allocatedBefore;
+
+        done.store(true, std::memory_order_release);
+        sampler.join();
+        peaks[index] = peak - baseline;
+    };
+
+    measure(0, [&]() { return readStream(FILE_PATH).size(); });
+    measure(1, [&]() { return Warhead::File::GetFileText(FILE_PATH).size(); });
+    measure(2, [&]() { return Warhead::File::GetFileText(FILE_PATH, true).size(); });
+    measure(3, [&]()
+    {
+        Warhead::IO::FileView view;
+        return view.Open(FILE_PATH) ? view.GetText().size() : 0;
+    });
+
+    std::string_view const names[] = { "stream", "text", "binary", "view" };
+    bool const allocationStats = Warhead::Memory::GetAllocationStats().Enabled;
+
+    for (std::size_t i = 0; i < 4; ++i)
+    {
+        fmt::print("# -- Read {:<6} {} bytes in {} ({:.2f}x), working set peak +{:.1f} MB", names[i], sizes[i],
+            Warhead::Time::ToTimeString<Microseconds>(times[i] / 1000, TimeOutput::Microseconds), double(times[0]) / double(std::max<uint64>(times[i], 1)),
+            double(peaks[i]) / (1024 * 1024));
+
+        // FileView pages count in the working set but are not heap allocations
+        if (allocationStats)
+            fmt::print(", {:.1f} MB allocated", double(allocated[i]) / (1024 * 1024));
+
+        fmt::print("\n");
+    }
+}
+
+void AddNumber(std::string_view str)
+{
+    auto number = Warhead::StringTo<uint32>(str);
+    if (!number)
+    {
+        fmt::print("> Number {} is incorrect!", str);
+        return;
+    }
+
+    _numbers.emplace_back(*number);
+}
+
 void GetNumbers()
 {
-    auto fileText = Warhead::File::GetFileText(FILE_PATH);
-    auto found = fileText.find_first_of('\n');
+    constexpr std::size_t BLOCK_SIZE = 1024 * 1024;
 
-    if (found != std::string::npos)
-        fileText = fileText.substr(found + 2LL);
-    else
+    Warhead::IO::FileHandle file;
+    if (!file.Open(FILE_PATH))
     {
-        fmt::print("> In file {} no found array\n", FILE_PATH);
+        fmt::print("> Failed to open file {}\n", FILE_PATH);
         return;
     }
 
-    for (auto str : Warhead::Tokenize(fileText, ' ', false))
+    auto startTime = Warhead::Time::Now();
+
+    // Parse one block while the next one is read on the I/O threads
+    std::unique_ptr<char[]> blocks[2] = { std::make_unique<char[]>(BLOCK_SIZE), std::make_unique<char[]>(BLOCK_SIZE) };
+    std::string partial; // Number cut by the end of the previous block
+    Warhead::Arena arena(BLOCK_SIZE); // Tokens of one block, reused for every block
+    bool skipHeader = true;
+    uint64 offset = 0;
+
+    int64 size = file.ReadAt(offset, blocks[0].get(), BLOCK_SIZE);
+
+    for (std::size_t current = 0; size > 0; current ^= 1)
     {
-        auto number = Warhead::StringTo<uint32>(str);
-        if (!number)
+        offset += uint64(size);
+        auto next = Warhead::IO::ReadAsync(file, offset, blocks[current ^ 1].get(), BLOCK_SIZE);
+
+        std::string_view text(blocks[current].get(), std::size_t(size));
+
+        if (skipHeader)
+        {
+            auto found = text.find_first_of('\n');
+            if (found == std::string_view::npos)
+            {
+                fmt::print("> In file {} no found array\n", FILE_PATH);
+                next.wait();
+                return;
+            }
+
+            text.remove_prefix(found + 1);
+            skipHeader = false;
+        }
+
+        auto last = text.find_last_of(' ');
+        if (last == std::string_view::npos)
         {
-            fmt::print("> Number {} is incorrect!", str);
+            partial.append(text);
+            size = next.get();
             continue;
         }
 
-        _numbers.emplace_back(*number);
+        partial.append(text.substr(0, last));
+
+        {
+            Warhead::ArenaScope scope(arena);
+
+            for (auto str : Warhead::Tokenize(partial, ' ', false, arena.GetResource()))
+                AddNumber(str);
+        }
+
+        partial.assign(text.substr(last + 1));
+        size = next.get();
     }
 
+    if (!partial.empty())
+        AddNumber(partial);
+
+    fmt::print("# -- Numbers loaded in {}\n", Warhead::Time::ToTimeString<Microseconds>(GetTimeDiff(startTime), TimeOutput::Microseconds));
+
     uint32 count = 0;
 
     for (auto const& itr : _numbers)
@@ -127,18 +350,528 @@ void CheckFile2()
     fmt::print("> Min element at: {}. Count: {}\n", minElement, minCount);
 }
 
+void CheckFileTasks()
+{
+    constexpr std::size_t GRAIN = 64 * 1024;
+
+    std::mutex lock;
+    uint32 minElement = UINT32_MAX;
+    std::size_t minCount = 0;
+
+    // Each chunk reduces on its own, only the chunk results are merged under the lock
+    Warhead::Threading::ParallelFor(0, _numbers.size(), GRAIN, [&](std::size_t begin, std::size_t end)
+    {
+        uint32 chunkMin = UINT32_MAX;
+        std::size_t chunkCount = 0;
+
+        for (std::size_t i = begin; i < end; ++i)
+        {
+            if (_numbers[i] < chunkMin)
+            {
+                chunkMin = _numbers[i];
+                chunkCount = 0;
+            }
+
+            if (_numbers[i] == chunkMin)
+                ++chunkCount;
+        }
+
+        std::lock_guard<std::mutex> guard(lock);
+
+        if (chunkMin < minElement)
+        {
+            minElement = chunkMin;
+            minCount = 0;
+        }
+
+        if (chunkMin == minElement)
+            minCount += chunkCount;
+    });
+
+    fmt::print("> Min element at: {}. Count: {}\n", minElement, minCount);
+}
+
+namespace
+{
+    struct NumberNotification : Poco::Notification
+    {
+        explicit NumberNotification(uint32 number) : Number(number) { }
+
+        uint32 Number;
+    };
+
+    // Million notifications per second through the queue with the given number of producers and as many consumers
+    template<class Queue>
+    double MeasureQueue(Queue& queue, uint32 threads)
+    {
+        constexpr uint32 NOTIFICATIONS = 200000;
+
+        uint32 perProducer = NOTIFICATIONS / threads;
+        uint32 total = perProducer * threads;
+
+        // Created up front, so the allocator is not what we measure
+        std::vector<std::vector<Poco::Notification::Ptr>> notifications(threads);
+        for (auto& list : notifications)
+            for (uint32 i = 0; i < perProducer; ++i)
+                list.emplace_back(new NumberNotification(i));
+
+        std::atomic<uint32> received{ 0 };
+        std::vector<std::thread> workers;
+
+        auto startTime = Warhead::Time::Now();
+
+        for (uint32 i = 0; i < threads; ++i)
+        {
+            workers.emplace_back([&queue, &list = notifications[i]]()
+            {
+                for (auto const& notification : list)
+                    queue.enqueueNotification(notification);
+            });
+
+            workers.emplace_back([&queue, &received, total]()
+            {
+                while (received.load() < total)
+                {
+                    if (Poco::Notification* notification = queue.waitDequeueNotification(5))
+                    {
+                        notification->release();
+                        ++received;
+                    }
+                }
+            });
+        }
+
+        for (auto& worker : workers)
+            worker.join();
+
+        return double(total) / double(Warhead::Time::Now() - startTime) * 1000.0;
+    }
+}
+
+void BenchmarkNotificationQueues()
+{
+    // Results only say something about the default queue with more than one core
+    fmt::print("# Notification queues on {} hardware threads\n", std::thread::hardware_concurrency());
+
+    for (uint32 threads : { 1, 2, 4, 8, 16, 32, 64 })
+    {
+        Poco::NotificationQueue pocoQueue;
+        Warhead::Threading::MPMCNotificationQueue mpmcQueue(1024);
+
+        double poco = MeasureQueue(pocoQueue, threads);
+        double mpmc = MeasureQueue(mpmcQueue, threads);
+
+        fmt::print("# Notification queue {:>2} producers/consumers: Poco {:.2f} M/s, MPMC {:.2f} M/s\n", threads, poco, mpmc);
+    }
+}
+
+namespace
+{
+    // Million operations per second, 90% lookups and 10% adds over a key space larger than the cache
+    template<class Cache>
+    double MeasureCache(Cache& cache, uint32 threads)
+    {
+        constexpr uint32 OPERATIONS = 1000000;
+        constexpr uint32 KEYS = 100000;
+
+        uint32 perThread = OPERATIONS / threads;
+        std::vector<std::thread> workers;
+
+        auto startTime = Warhead::Time::Now();
+
+        for (uint32 i = 0; i < threads; ++i)
+        {
+            workers.emplace_back([&cache, perThread, i]()
+            {
+                std::mt19937 generator(i);
+
+                for (uint32 j = 0; j < perThread; ++j)
+                {
+                    uint32 key = generator() % KEYS;
+
+                    if (j % 10 == 0)
+                        cache.add(key, key);
+                    else
+                        cache.get(key);
+                }
+            });
+        }
+
+        for (auto& worker : workers)
+            worker.join();
+
+        return double(perThread * threads) / double(Warhead::Time::Now() - startTime) * 1000.0;
+    }
+}
+
+void BenchmarkCaches()
+{
+    for (uint32 threads : { 1, 2, 4, 8, 16 })
+    {
+        Poco::LRUCache<uint32, uint32> pocoCache(65536);
+        Warhead::ConcurrentCache<uint32, uint32> concurrentCache(65536);
+
+        double poco = MeasureCache(pocoCache, threads);
+        double concurrent = MeasureCache(concurrentCache, threads);
+
+        fmt::print("# Cache {:>2} threads: Poco::LRUCache {:.2f} M/s, ConcurrentCache {:.2f} M/s\n", threads, poco, concurrent);
+    }
+}
+
+namespace
+{
+    // Nanoseconds per operation: add all keys, then look each one up twice and miss once
+    template<class Map, class Lookup>
+    std::pair<double, double> MeasureMap(std::vector<std::string> const& keys, std::vector<std::string> const& missing, Lookup const& lookup)
+    {
+        Map map;
+        uint64 found = 0;
+
+        auto startTime = Warhead::Time::Now();
+        for (uint32 i = 0; i < keys.size(); ++i)
+            map[keys[i]] = i;
+        double insert = double(Warhead::Time::Now() - startTime) / double(keys.size());
+
+        startTime = Warhead::Time::Now();
+        for (uint32 round = 0; round < 2; ++round)
+            for (std::string const& key : keys)
+                found += lookup(map, key);
+
+        for (std::string const& key : missing)
+            found += lookup(map, key);
+        double find = double(Warhead::Time::Now() - startTime) / double(keys.size() * 3);
+
+        if (found != keys.size() * 2)
+            fmt::print("> Hash map benchmark: found {} of {} keys\n", found, keys.size() * 2);
+
+        return { insert, find };
+    }
+}
+
+void BenchmarkHashMaps()
+{
+    for (uint32 count : { 100, 10000, 1000000 })
+    {
+        std::vector<std::string> keys;
+        std::vector<std::string> missing;
+
+        for (uint32 i = 0; i < count; ++i)
+        {
+            keys.emplace_back(Warhead::StringFormat("Config.Option.Name.%u", i));
+            missing.emplace_back(Warhead::StringFormat("Config.Option.Missing.%u", i));
+        }
+
+        std::mt19937 generator(7);
+        std::shuffle(keys.begin(), keys.end(), generator);
+
+        auto flat = MeasureMap<Warhead::FlatHashMap<std::string, uint32>>(keys, missing, [](auto const& map, std::string const& key)
+        {
+            return map.contains(std::string_view(key));
+        });
+
+        auto unordered = MeasureMap<std::unordered_map<std::string, uint32>>(keys, missing, [](auto const& map, std::string const& key)
+        {
+            return map.find(key) != map.end();
+        });
+
+        auto ordered = MeasureMap<std::map<std::string, uint32>>(keys, missing, [](auto const& map, std::string const& key)
+        {
+            return map.find(key) != map.end();
+        });
+
+        auto poco = MeasureMap<Poco::HashMap<std::string, uint32>>(keys, missing, [](auto const& map, std::string const& key)
+        {
+            return map.find(key) != map.end();
+        });
+
+        fmt::print("# Hash maps {:>7} keys, insert/find ns: FlatHashMap {:.1f}/{:.1f}, std::unordered_map {:.1f}/{:.1f}, std::map {:.1f}/{:.1f}, Poco::HashMap {:.1f}/{:.1f}\n",
+            count, flat.first, flat.second, unordered.first, unordered.second, ordered.first, ordered.second, poco.first, poco.second);
+    }
+}
+
+namespace
+{
+    // Million get/release pairs per second over all threads, every thread keeps a few blocks in flight
+    template<class Pool>
+    double MeasurePool(Pool& pool, uint32 threads)
+    {
+        constexpr uint32 perThread = 1000000;
+        std::vector<std::thread> workers;
+
+        auto startTime = Warhead::Time::Now();
+
+        for (uint32 i = 0; i < threads; ++i)
+        {
+            workers.emplace_back([&pool]()
+            {
+                void* blocks[8];
+
+                for (void*& block : blocks)
+                    block = pool.get();
+
+                for (uint32 j = 0; j < perThread; ++j)
+                {
+                    void*& block = blocks[j & 7];
+                    pool.release(block);
+                    block = pool.get();
+                }
+
+                for (void* block : blocks)
+                    pool.release(block);
+            });
+        }
+
+        for (auto& worker : workers)
+            worker.join();
+
+        return double(perThread * threads) / double(Warhead::Time::Now() - startTime) * 1000.0;
+    }
+}
+
+void BenchmarkMemoryPools()
+{
+    for (uint32 threads : { 1, 2, 4, 8, 16 })
+    {
+        Poco::MemoryPool pocoPool(4096);
+        Warhead::Memory::CachedMemoryPool cachedPool(4096);
+
+        double poco = MeasurePool(pocoPool, threads);
+        double cached = MeasurePool(cachedPool, threads);
+
+        fmt::print("# Memory pool {:>2} threads: Poco::MemoryPool {:.2f} M/s, CachedMemoryPool {:.2f} M/s\n", threads, poco, cached);
+    }
+}
+
+namespace
+{
+    // Million borrow/return pairs per second over all threads, every thread keeps a few objects borrowed
+    template<class Pool>
+    double MeasureObjectPool(Pool& pool, uint32 threads)
+    {
+        constexpr uint32 perThread = 1000000;
+        std::vector<std::thread> workers;
+
+        auto startTime = Warhead::Time::Now();
+
+        for (uint32 i = 0; i < threads; ++i)
+        {
+            workers.emplace_back([&pool]()
+            {
+                std::string* objects[4];
+
+                for (auto& object : objects)
+                    object = pool.borrowObject(1000);
+
+                for (uint32 j = 0; j < perThread; ++j)
+                {
+                    std::string*& object = objects[j & 3];
+                    pool.returnObject(object);
+                    object = pool.borrowObject(1000);
+                }
+
+                for (auto object : objects)
+                    pool.returnObject(object);
+            });
+        }
+
+        for (auto& worker : workers)
+            worker.join();
+
+        return double(perThread * threads) / double(Warhead::Time::Now() - startTime) * 1000.0;
+    }
+}
+
+void BenchmarkObjectPools()
+{
+    for (uint32 threads : { 1, 2, 4, 8, 16 })
+    {
+        Poco::ObjectPool<std::string> pocoPool(64, 128);
+        Warhead::ConcurrentObjectPool<std::string> concurrentPool(64, 128);
+
+        double poco = MeasureObjectPool(pocoPool, threads);
+        double concurrent = MeasureObjectPool(concurrentPool, threads);
+
+        auto stats = concurrentPool.stats();
+
+        fmt::print("# Object pool {:>2} threads: Poco::ObjectPool {:.2f} M/s, ConcurrentObjectPool {:.2f} M/s, hit rate {:.4f}, created {}\n",
+            threads, poco, concurrent, stats.GetHitRate(), stats.Creations);
+    }
+}
+
+// MB/s of input over a 1 MiB random buffer, Poco's stream filters against the buffer codecs
+void BenchmarkEncoding()
+{
+    constexpr std::size_t SIZE = 1024 * 1024;
+    constexpr uint32 ROUNDS = 64;
+
+    std::vector<uint8> data(SIZE);
+    std::mt19937 generator(1);
+    for (auto& byte : data)
+        byte = uint8(generator());
+
+    auto measure = [](auto&& func, uint32 rounds)
+    {
+        auto startTime = Warhead::Time::Now();
+
+        for (uint32 i = 0; i < rounds; ++i)
+            func();
+
+        return double(SIZE) * rounds / double(Warhead::Time::Now() - startTime) * 1000.0;
+    };
+
+    std::string base64;
+    std::string hex;
+
+    double pocoBase64 = measure([&]()
+    {
+        std::ostringstream stream;
+        Poco::Base64Encoder encoder(stream);
+        encoder.write(reinterpret_cast<char const*>(data.data()), data.size());
+        encoder.close();
+        base64 = stream.str();
+    }, 4);
+
+    double pocoBase64Decode = measure([&]()
+    {
+        std::istringstream stream(base64);
+        Poco::Base64Decoder decoder(stream);
+        std::vector<char> decoded(SIZE);
+        decoder.read(decoded.data(), decoded.size());
+    }, 4);
+
+    double pocoHex = measure([&]()
+    {
+        std::ostringstream stream;
+        Poco::HexBinaryEncoder encoder(stream);
+        encoder.write(reinterpret_cast<char const*>(data.data()), data.size());
+        encoder.close();
+    }, 4);
+
+    double encodeBase64 = measure([&]() { base64 = Warhead::Encoding::Base64Encode(data.data(), data.size()); }, ROUNDS);
+    double decodeBase64 = measure([&]() { Warhead::Encoding::Base64Decode(base64); }, ROUNDS);
+    double encodeHex = measure([&]() { hex = Warhead::Encoding::HexEncode(data.data(), data.size()); }, ROUNDS);
+    double decodeHex = measure([&]() { Warhead::Encoding::HexDecode(hex); }, ROUNDS);
+
+    fmt::print("# Base64 encode: Poco::Base64Encoder {:.0f} MB/s, Base64Encode {:.0f} MB/s\n", pocoBase64, encodeBase64);
+    fmt::print("# Base64 decode: Poco::Base64Decoder {:.0f} MB/s, Base64Decode {:.0f} MB/s\n", pocoBase64Decode, decodeBase64);
+    fmt::print("# Hex encode: Poco::HexBinaryEncoder {:.0f} MB/s, HexEncode {:.0f} MB/s, HexDecode {:.0f} MB/s\n", pocoHex, encodeHex, decodeHex);
+}
+
+// 1M active timers spread over a minute, half of them cancelled, the rest expired on simulated time
+void BenchmarkTimers()
+{
+    constexpr uint32 TIMERS = 1000000;
+    constexpr uint64 SPAN_MS = 60000;
+
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<uint32> distribution(1, SPAN_MS);
+
+    std::vector<uint32> delays(TIMERS);
+    for (uint32& delay : delays)
+        delay = distribution(generator);
+
+    auto perTimer = [](uint64 startTime, uint32 count)
+    {
+        return double(Warhead::Time::Now() - startTime) / double(count);
+    };
+
+    uint64 fired = 0;
+
+    {
+        uint64 const start = Warhead::Time::Now();
+        Warhead::Time::TimerWheel wheel(1ms, start);
+        wheel.Reserve(TIMERS);
+
+        std::vector<Warhead::Time::TimerId> ids(TIMERS);
+
+        auto startTime = Warhead::Time::Now();
+        for (uint32 i = 0; i < TIMERS; ++i)
+            ids[i] = wheel.Schedule(Milliseconds(delays[i]), [&fired]() { ++fired; });
+        double schedule = perTimer(startTime, TIMERS);
+
+        startTime = Warhead::Time::Now();
+        for (uint32 i = 0; i < TIMERS; i += 2)
+            wheel.Cancel(ids[i]);
+        double cancel = perTimer(startTime, TIMERS / 2);
+
+        startTime = Warhead::Time::Now();
+        for (uint64 tick = 1; tick <= SPAN_MS; ++tick)
+            wheel.Advance(start + tick * 1000000);
+        double expire = perTimer(startTime, TIMERS / 2);
+
+        fmt::print("# Timer wheel, {} timers: schedule {:.1f} ns, cancel {:.1f} ns, expire {:.1f} ns per timer, fired {}\n", TIMERS, schedule, cancel, expire, fired);
+    }
+
+    fired = 0;
+
+    {
+        // What TimedNotificationQueue and Util::Timer keep internally
+        using Timers = std::multimap<uint64, std::function<void()>>;
+
+        Timers timers;
+        std::vector<Timers::iterator> ids(TIMERS);
+
+        auto startTime = Warhead::Time::Now();
+        for (uint32 i = 0; i < TIMERS; ++i)
+            ids[i] = timers.emplace(delays[i], [&fired]() { ++fired; });
+        double schedule = perTimer(startTime, TIMERS);
+
+        startTime = Warhead::Time::Now();
+        for (uint32 i = 0; i < TIMERS; i += 2)
+            timers.erase(ids[i]);
+        double cancel = perTimer(startTime, TIMERS / 2);
+
+        startTime = Warhead::Time::Now();
+        for (uint64 tick = 1; tick <= SPAN_MS; ++tick)
+        {
+            while (!timers.empty() && timers.begin()->first <= tick)
+            {
+                timers.begin()->second();
+                timers.erase(timers.begin());
+            }
+        }
+        double expire = perTimer(startTime, TIMERS / 2);
+
+        fmt::print("# std::multimap, {} timers: schedule {:.1f} ns, cancel {:.1f} ns, expire {:.1f} ns per timer, fired {}\n", TIMERS, schedule, cancel, expire, fired);
+    }
+
+    {
+        // No cancel and expiry follows the real clock, only scheduling is comparable
+        Poco::TimedNotificationQueue queue;
+        Poco::Notification::Ptr notification(new NumberNotification(0));
+
+        auto startTime = Warhead::Time::Now();
+        for (uint32 i = 0; i < TIMERS; ++i)
+        {
+            Poco::Clock clock;
+            clock += Poco::Clock::ClockDiff(delays[i]) * 1000;
+            queue.enqueueNotification(notification, clock);
+        }
+        double schedule = perTimer(startTime, TIMERS);
+
+        queue.clear();
+
+        fmt::print("# Poco::TimedNotificationQueue, {} timers: schedule {:.1f} ns per timer\n", TIMERS, schedule);
+    }
+}
+
 int main()
 {
+    fmt::print("# {}\n", GitRevision::GetFullVersion());
+    fmt::print("# CPU: {}\n", GitRevision::GetCpuInfo());
+
     GenerateFile();
+    HashFile();
+    ReadFile();
     GetNumbers();
 
     // Get start time
-    auto startTime = std::chrono::system_clock::now();
+    auto startTime = Warhead::Time::Now();
     CheckFile(); //1 thread
     uint64 time1 = GetTimeDiff(startTime);
     fmt::print("# CheckFile done with 1 thread in {}\n", Warhead::Time::ToTimeString<Microseconds>(time1, TimeOutput::Microseconds));
 
-    startTime = std::chrono::system_clock::now();
+    startTime = Warhead::Time::Now();
     std::thread thread1(CheckFile1);
     std::thread thread2(CheckFile2);
 
@@ -154,5 +887,22 @@ int main()
     else if (time2 > time1)
         fmt::print("> 1 thread faster 2 in: {}. \n", float(time2) / float(time1));
 
+    // Start the workers outside the measurement
+    Warhead::Threading::TaskScheduler& scheduler = Warhead::Threading::TaskScheduler::Instance();
+
+    startTime = Warhead::Time::Now();
+    CheckFileTasks();
+    uint64 time3 = GetTimeDiff(startTime);
+    fmt::print("# CheckFile done with {} task workers in {}\n", scheduler.GetWorkerCount(),
+        Warhead::Time::ToTimeString<Microseconds>(time3, TimeOutput::Microseconds));
+
+    BenchmarkNotificationQueues();
+    BenchmarkTimers();
+    BenchmarkCaches();
+    BenchmarkHashMaps();
+    BenchmarkMemoryPools();
+    BenchmarkObjectPools();
+    BenchmarkEncoding();
+
     return 0;
 }
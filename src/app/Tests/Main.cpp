@@ -0,0 +1,21 @@
+#include "GitRevision.h"
+#include "TestCheck.h"
+
+int main()
+{
+    fmt::print("# {}\n", GitRevision::GetFullVersion());
+
+    TestTimeStrings();
+    TestTreeHash();
+    TestXXHash();
+
+    uint32 failures = Warhead::Test::GetFailureCount();
+    if (failures)
+    {
+        fmt::print("> {} checks failed\n", failures);
+        return 1;
+    }
+
+    fmt::print("# All checks passed\n");
+    return 0;
+}
@@ -0,0 +1,36 @@
+/*
+ * This file is part of the WarheadApp Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "TestCheck.h"
+#include <atomic>
+
+namespace
+{
+    std::atomic<uint32> _failures{ 0 };
+}
+
+uint32 Warhead::Test::GetFailureCount()
+{
+    return _failures.load();
+}
+
+void Warhead::Test::ReportFailure(std::string_view message, char const* file, int line)
+{
+    ++_failures;
+    fmt::print("> FAILED {}:{}: {}\n", file, line, message);
+}
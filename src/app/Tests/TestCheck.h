@@ -0,0 +1,52 @@
+/*
+ * This file is part of the WarheadApp Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef _WARHEAD_TEST_CHECK_H_
+#define _WARHEAD_TEST_CHECK_H_
+
+#include "Define.h"
+#include <fmt/format.h>
+#include <string_view>
+
+namespace Warhead::Test
+{
+    /// Failed checks of the whole run
+    uint32 GetFailureCount();
+
+    void ReportFailure(std::string_view message, char const* file, int line);
+
+    template<class Actual, class Expected>
+    void CheckEqual(Actual const& actual, Expected const& expected, std::string_view context, char const* file, int line)
+    {
+        if (!(actual == expected))
+            ReportFailure(fmt::format("{}: got \"{}\", expected \"{}\"", context, actual, expected), file, line);
+    }
+}
+
+#define TEST_CHECK(expression) \
+    do { if (!(expression)) Warhead::Test::ReportFailure(#expression, __FILE__, __LINE__); } while (0)
+
+#define TEST_CHECK_EQUAL(actual, expected, context) \
+    Warhead::Test::CheckEqual((actual), (expected), (context), __FILE__, __LINE__)
+
+// Suites, one file each
+void TestTimeStrings();
+void TestTreeHash();
+void TestXXHash();
+
+#endif // _WARHEAD_TEST_CHECK_H_
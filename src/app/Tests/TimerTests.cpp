@@ -0,0 +1,387 @@
+/*
+ * This file is part of the WarheadApp Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "TestCheck.h"
+#include "Timer.h"
+
+namespace
+{
+    constexpr uint64 US = 1;
+    constexpr uint64 MS = 1000 * US;
+    constexpr uint64 S = 1000 * MS;
+    constexpr uint64 M = 60 * S;
+    constexpr uint64 H = 60 * M;
+    constexpr uint64 D = 24 * H;
+
+    struct TimeStringCase
+    {
+        uint64 Duration; // Microseconds
+        TimeOutput Output;
+        TimeFormat Format;
+        std::string_view Expected;
+    };
+
+    // Pinned output of ToTimeString<Microseconds>, every TimeOutput and TimeFormat for each duration.
+    // TimeOutput::Microseconds used to print the microseconds only when the milliseconds were non zero,
+    // the rows marked "was" changed when that was fixed.
+    TimeStringCase const TimeStringCases[] =
+    {
+        { 0, TimeOutput::Days, TimeFormat::FullText, "0 Days" },
+        { 0, TimeOutput::Hours, TimeFormat::FullText, "0 Hours" },
+        { 0, TimeOutput::Minutes, TimeFormat::FullText, "0 Minutes" },
+        { 0, TimeOutput::Seconds, TimeFormat::FullText, "0 Seconds" },
+        { 0, TimeOutput::Milliseconds, TimeFormat::FullText, "0 Milliseconds" },
+        { 0, TimeOutput::Microseconds, TimeFormat::FullText, "0 Microseconds" }, // was ""
+        { 0, TimeOutput::Days, TimeFormat::ShortText, "0d" },
+        { 0, TimeOutput::Hours, TimeFormat::ShortText, "0h" },
+        { 0, TimeOutput::Minutes, TimeFormat::ShortText, "0m" },
+        { 0, TimeOutput::Seconds, TimeFormat::ShortText, "0s" },
+        { 0, TimeOutput::Milliseconds, TimeFormat::ShortText, "0ms" },
+        { 0, TimeOutput::Microseconds, TimeFormat::ShortText, "0us" }, // was ""
+        { 0, TimeOutput::Days, TimeFormat::Numeric, "0" },
+        { 0, TimeOutput::Hours, TimeFormat::Numeric, "0" },
+        { 0, TimeOutput::Minutes, TimeFormat::Numeric, "0" },
+        { 0, TimeOutput::Seconds, TimeFormat::Numeric, "0" },
+        { 0, TimeOutput::Milliseconds, TimeFormat::Numeric, "0" },
+        { 0, TimeOutput::Microseconds, TimeFormat::Numeric, "0" },
+
+        { 1 * US, TimeOutput::Days, TimeFormat::FullText, "0 Days" },
+        { 1 * US, TimeOutput::Hours, TimeFormat::FullText, "0 Hours" },
+        { 1 * US, TimeOutput::Minutes, TimeFormat::FullText, "0 Minutes" },
+        { 1 * US, TimeOutput::Seconds, TimeFormat::FullText, "0 Seconds" },
+        { 1 * US, TimeOutput::Milliseconds, TimeFormat::FullText, "0 Milliseconds" },
+        { 1 * US, TimeOutput::Microseconds, TimeFormat::FullText, "1 Microsecond" }, // was ""
+        { 1 * US, TimeOutput::Days, TimeFormat::ShortText, "0d" },
+        { 1 * US, TimeOutput::Hours, TimeFormat::ShortText, "0h" },
+        { 1 * US, TimeOutput::Minutes, TimeFormat::ShortText, "0m" },
+        { 1 * US, TimeOutput::Seconds, TimeFormat::ShortText, "0s" },
+        { 1 * US, TimeOutput::Milliseconds, TimeFormat::ShortText, "0ms" },
+        { 1 * US, TimeOutput::Microseconds, TimeFormat::ShortText, "1us" }, // was ""
+        { 1 * US, TimeOutput::Days, TimeFormat::Numeric, "0" },
+        { 1 * US, TimeOutput::Hours, TimeFormat::Numeric, "0" },
+        { 1 * US, TimeOutput::Minutes, TimeFormat::Numeric, "0" },
+        { 1 * US, TimeOutput::Seconds, TimeFormat::Numeric, "0" },
+        { 1 * US, TimeOutput::Milliseconds, TimeFormat::Numeric, "0" },
+        { 1 * US, TimeOutput::Microseconds, TimeFormat::Numeric, "0" },
+
+        { 7 * US, TimeOutput::Days, TimeFormat::FullText, "0 Days" },
+        { 7 * US, TimeOutput::Hours, TimeFormat::FullText, "0 Hours" },
+        { 7 * US, TimeOutput::Minutes, TimeFormat::FullText, "0 Minutes" },
+        { 7 * US, TimeOutput::Seconds, TimeFormat::FullText, "0 Seconds" },
+        { 7 * US, TimeOutput::Milliseconds, TimeFormat::FullText, "0 Milliseconds" },
+        { 7 * US, TimeOutput::Microseconds, TimeFormat::FullText, "7 Microseconds" }, // was ""
+        { 7 * US, TimeOutput::Days, TimeFormat::ShortText, "0d" },
+        { 7 * US, TimeOutput::Hours, TimeFormat::ShortText, "0h" },
+        { 7 * US, TimeOutput::Minutes, TimeFormat::ShortText, "0m" },
+        { 7 * US, TimeOutput::Seconds, TimeFormat::ShortText, "0s" },
+        { 7 * US, TimeOutput::Milliseconds, TimeFormat::ShortText, "0ms" },
+        { 7 * US, TimeOutput::Microseconds, TimeFormat::ShortText, "7us" }, // was ""
+        { 7 * US, TimeOutput::Days, TimeFormat::Numeric, "0" },
+        { 7 * US, TimeOutput::Hours, TimeFormat::Numeric, "0" },
+        { 7 * US, TimeOutput::Minutes, TimeFormat::Numeric, "0" },
+        { 7 * US, TimeOutput::Seconds, TimeFormat::Numeric, "0" },
+        { 7 * US, TimeOutput::Milliseconds, TimeFormat::Numeric, "0" },
+        { 7 * US, TimeOutput::Microseconds, TimeFormat::Numeric, "0" },
+
+        { 1 * MS, TimeOutput::Days, TimeFormat::FullText, "0 Days" },
+        { 1 * MS, TimeOutput::Hours, TimeFormat::FullText, "0 Hours" },
+        { 1 * MS, TimeOutput::Minutes, TimeFormat::FullText, "0 Minutes" },
+        { 1 * MS, TimeOutput::Seconds, TimeFormat::FullText, "0 Seconds" },
+        { 1 * MS, TimeOutput::Milliseconds, TimeFormat::FullText, "1 Millisecond" },
+        { 1 * MS, TimeOutput::Microseconds, TimeFormat::FullText, "1 Millisecond 0 Microseconds" },
+        { 1 * MS, TimeOutput::Days, TimeFormat::ShortText, "0d" },
+        { 1 * MS, TimeOutput::Hours, TimeFormat::ShortText, "0h" },
+        { 1 * MS, TimeOutput::Minutes, TimeFormat::ShortText, "0m" },
+        { 1 * MS, TimeOutput::Seconds, TimeFormat::ShortText, "0s" },
+        { 1 * MS, TimeOutput::Milliseconds, TimeFormat::ShortText, "1ms" },
+        { 1 * MS, TimeOutput::Microseconds, TimeFormat::ShortText, "1ms 0us" },
+        { 1 * MS, TimeOutput::Days, TimeFormat::Numeric, "1" },
+        { 1 * MS, TimeOutput::Hours, TimeFormat::Numeric, "1" },
+        { 1 * MS, TimeOutput::Minutes, TimeFormat::Numeric, "1" },
+        { 1 * MS, TimeOutput::Seconds, TimeFormat::Numeric, "1" },
+        { 1 * MS, TimeOutput::Milliseconds, TimeFormat::Numeric, "1" },
+        { 1 * MS, TimeOutput::Microseconds, TimeFormat::Numeric, "1" },
+
+        { 1 * MS + 1 * US, TimeOutput::Days, TimeFormat::FullText, "0 Days" },
+        { 1 * MS + 1 * US, TimeOutput::Hours, TimeFormat::FullText, "0 Hours" },
+        { 1 * MS + 1 * US, TimeOutput::Minutes, TimeFormat::FullText, "0 Minutes" },
+        { 1 * MS + 1 * US, TimeOutput::Seconds, TimeFormat::FullText, "0 Seconds" },
+        { 1 * MS + 1 * US, TimeOutput::Milliseconds, TimeFormat::FullText, "1 Millisecond" },
+        { 1 * MS + 1 * US, TimeOutput::Microseconds, TimeFormat::FullText, "1 Millisecond 1 Microsecond" },
+        { 1 * MS + 1 * US, TimeOutput::Days, TimeFormat::ShortText, "0d" },
+        { 1 * MS + 1 * US, TimeOutput::Hours, TimeFormat::ShortText, "0h" },
+        { 1 * MS + 1 * US, TimeOutput::Minutes, TimeFormat::ShortText, "0m" },
+        { 1 * MS + 1 * US, TimeOutput::Seconds, TimeFormat::ShortText, "0s" },
+        { 1 * MS + 1 * US, TimeOutput::Milliseconds, TimeFormat::ShortText, "1ms" },
+        { 1 * MS + 1 * US, TimeOutput::Microseconds, TimeFormat::ShortText, "1ms 1us" },
+        { 1 * MS + 1 * US, TimeOutput::Days, TimeFormat::Numeric, "1" },
+        { 1 * MS + 1 * US, TimeOutput::Hours, TimeFormat::Numeric, "1" },
+        { 1 * MS + 1 * US, TimeOutput::Minutes, TimeFormat::Numeric, "1" },
+        { 1 * MS + 1 * US, TimeOutput::Seconds, TimeFormat::Numeric, "1" },
+        { 1 * MS + 1 * US, TimeOutput::Milliseconds, TimeFormat::Numeric, "1" },
+        { 1 * MS + 1 * US, TimeOutput::Microseconds, TimeFormat::Numeric, "1" },
+
+        { 250 * MS + 40 * US, TimeOutput::Days, TimeFormat::FullText, "0 Days" },
+        { 250 * MS + 40 * US, TimeOutput::Hours, TimeFormat::FullText, "0 Hours" },
+        { 250 * MS + 40 * US, TimeOutput::Minutes, TimeFormat::FullText, "0 Minutes" },
+        { 250 * MS + 40 * US, TimeOutput::Seconds, TimeFormat::FullText, "0 Seconds" },
+        { 250 * MS + 40 * US, TimeOutput::Milliseconds, TimeFormat::FullText, "250 Milliseconds" },
+        { 250 * MS + 40 * US, TimeOutput::Microseconds, TimeFormat::FullText, "250 Milliseconds 40 Microseconds" },
+        { 250 * MS + 40 * US, TimeOutput::Days, TimeFormat::ShortText, "0d" },
+        { 250 * MS + 40 * US, TimeOutput::Hours, TimeFormat::ShortText, "0h" },
+        { 250 * MS + 40 * US, TimeOutput::Minutes, TimeFormat::ShortText, "0m" },
+        { 250 * MS + 40 * US, TimeOutput::Seconds, TimeFormat::ShortText, "0s" },
+        { 250 * MS + 40 * US, TimeOutput::Milliseconds, TimeFormat::ShortText, "250ms" },
+        { 250 * MS + 40 * US, TimeOutput::Microseconds, TimeFormat::ShortText, "250ms 40us" },
+        { 250 * MS + 40 * US, TimeOutput::Days, TimeFormat::Numeric, "250" },
+        { 250 * MS + 40 * US, TimeOutput::Hours, TimeFormat::Numeric, "250" },
+        { 250 * MS + 40 * US, TimeOutput::Minutes, TimeFormat::Numeric, "250" },
+        { 250 * MS + 40 * US, TimeOutput::Seconds, TimeFormat::Numeric, "250" },
+        { 250 * MS + 40 * US, TimeOutput::Milliseconds, TimeFormat::Numeric, "250" },
+        { 250 * MS + 40 * US, TimeOutput::Microseconds, TimeFormat::Numeric, "250" },
+
+        { 1 * S, TimeOutput::Days, TimeFormat::FullText, "0 Days" },
+        { 1 * S, TimeOutput::Hours, TimeFormat::FullText, "0 Hours" },
+        { 1 * S, TimeOutput::Minutes, TimeFormat::FullText, "0 Minutes" },
+        { 1 * S, TimeOutput::Seconds, TimeFormat::FullText, "1 Second" },
+        { 1 * S, TimeOutput::Milliseconds, TimeFormat::FullText, "1 Second 0 Milliseconds" },
+        { 1 * S, TimeOutput::Microseconds, TimeFormat::FullText, "1 Second 0 Microseconds" }, // was "1 Second"
+        { 1 * S, TimeOutput::Days, TimeFormat::ShortText, "0d" },
+        { 1 * S, TimeOutput::Hours, TimeFormat::ShortText, "0h" },
+        { 1 * S, TimeOutput::Minutes, TimeFormat::ShortText, "0m" },
+        { 1 * S, TimeOutput::Seconds, TimeFormat::ShortText, "1s" },
+        { 1 * S, TimeOutput::Milliseconds, TimeFormat::ShortText, "1s 0ms" },
+        { 1 * S, TimeOutput::Microseconds, TimeFormat::ShortText, "1s 0us" }, // was "1s"
+        { 1 * S, TimeOutput::Days, TimeFormat::Numeric, "1:00" },
+        { 1 * S, TimeOutput::Hours, TimeFormat::Numeric, "1:00" },
+        { 1 * S, TimeOutput::Minutes, TimeFormat::Numeric, "1:00" },
+        { 1 * S, TimeOutput::Seconds, TimeFormat::Numeric, "1:00" },
+        { 1 * S, TimeOutput::Milliseconds, TimeFormat::Numeric, "1:00" },
+        { 1 * S, TimeOutput::Microseconds, TimeFormat::Numeric, "1:00" },
+
+        { 2 * S + 5 * US, TimeOutput::Days, TimeFormat::FullText, "0 Days" },
+        { 2 * S + 5 * US, TimeOutput::Hours, TimeFormat::FullText, "0 Hours" },
+        { 2 * S + 5 * US, TimeOutput::Minutes, TimeFormat::FullText, "0 Minutes" },
+        { 2 * S + 5 * US, TimeOutput::Seconds, TimeFormat::FullText, "2 Seconds" },
+        { 2 * S + 5 * US, TimeOutput::Milliseconds, TimeFormat::FullText, "2 Seconds 0 Milliseconds" },
+        { 2 * S + 5 * US, TimeOutput::Microseconds, TimeFormat::FullText, "2 Seconds 5 Microseconds" }, // was "2 Seconds"
+        { 2 * S + 5 * US, TimeOutput::Days, TimeFormat::ShortText, "0d" },
+        { 2 * S + 5 * US, TimeOutput::Hours, TimeFormat::ShortText, "0h" },
+        { 2 * S + 5 * US, TimeOutput::Minutes, TimeFormat::ShortText, "0m" },
+        { 2 * S + 5 * US, TimeOutput::Seconds, TimeFormat::ShortText, "2s" },
+        { 2 * S + 5 * US, TimeOutput::Milliseconds, TimeFormat::ShortText, "2s 0ms" },
+        { 2 * S + 5 * US, TimeOutput::Microseconds, TimeFormat::ShortText, "2s 5us" }, // was "2s"
+        { 2 * S + 5 * US, TimeOutput::Days, TimeFormat::Numeric, "2:00" },
+        { 2 * S + 5 * US, TimeOutput::Hours, TimeFormat::Numeric, "2:00" },
+        { 2 * S + 5 * US, TimeOutput::Minutes, TimeFormat::Numeric, "2:00" },
+        { 2 * S + 5 * US, TimeOutput::Seconds, TimeFormat::Numeric, "2:00" },
+        { 2 * S + 5 * US, TimeOutput::Milliseconds, TimeFormat::Numeric, "2:00" },
+        { 2 * S + 5 * US, TimeOutput::Microseconds, TimeFormat::Numeric, "2:00" },
+
+        { 59 * S + 999 * MS + 999 * US, TimeOutput::Days, TimeFormat::FullText, "0 Days" },
+        { 59 * S + 999 * MS + 999 * US, TimeOutput::Hours, TimeFormat::FullText, "0 Hours" },
+        { 59 * S + 999 * MS + 999 * US, TimeOutput::Minutes, TimeFormat::FullText, "0 Minutes" },
+        { 59 * S + 999 * MS + 999 * US, TimeOutput::Seconds, TimeFormat::FullText, "59 Seconds" },
+        { 59 * S + 999 * MS + 999 * US, TimeOutput::Milliseconds, TimeFormat::FullText, "59 Seconds 999 Milliseconds" },
+        { 59 * S + 999 * MS + 999 * US, TimeOutput::Microseconds, TimeFormat::FullText, "59 Seconds 999 Milliseconds 999 Microseconds" },
+        { 59 * S + 999 * MS + 999 * US, TimeOutput::Days, TimeFormat::ShortText, "0d" },
+        { 59 * S + 999 * MS + 999 * US, TimeOutput::Hours, TimeFormat::ShortText, "0h" },
+        { 59 * S + 999 * MS + 999 * US, TimeOutput::Minutes, TimeFormat::ShortText, "0m" },
+        { 59 * S + 999 * MS + 999 * US, TimeOutput::Seconds, TimeFormat::ShortText, "59s" },
+        { 59 * S + 999 * MS + 999 * US, TimeOutput::Milliseconds, TimeFormat::ShortText, "59s 999ms" },
+        { 59 * S + 999 * MS + 999 * US, TimeOutput::Microseconds, TimeFormat::ShortText, "59s 999ms 999us" },
+        { 59 * S + 999 * MS + 999 * US, TimeOutput::Days, TimeFormat::Numeric, "59:999" },
+        { 59 * S + 999 * MS + 999 * US, TimeOutput::Hours, TimeFormat::Numeric, "59:999" },
+        { 59 * S + 999 * MS + 999 * US, TimeOutput::Minutes, TimeFormat::Numeric, "59:999" },
+        { 59 * S + 999 * MS + 999 * US, TimeOutput::Seconds, TimeFormat::Numeric, "59:999" },
+        { 59 * S + 999 * MS + 999 * US, TimeOutput::Milliseconds, TimeFormat::Numeric, "59:999" },
+        { 59 * S + 999 * MS + 999 * US, TimeOutput::Microseconds, TimeFormat::Numeric, "59:999" },
+
+        { 1 * M, TimeOutput::Days, TimeFormat::FullText, "0 Days" },
+        { 1 * M, TimeOutput::Hours, TimeFormat::FullText, "0 Hours" },
+        { 1 * M, TimeOutput::Minutes, TimeFormat::FullText, "1 Minute" },
+        { 1 * M, TimeOutput::Seconds, TimeFormat::FullText, "1 Minute 0 Seconds" },
+        { 1 * M, TimeOutput::Milliseconds, TimeFormat::FullText, "1 Minute 0 Milliseconds" },
+        { 1 * M, TimeOutput::Microseconds, TimeFormat::FullText, "1 Minute 0 Microseconds" }, // was "1 Minute"
+        { 1 * M, TimeOutput::Days, TimeFormat::ShortText, "0d" },
+        { 1 * M, TimeOutput::Hours, TimeFormat::ShortText, "0h" },
+        { 1 * M, TimeOutput::Minutes, TimeFormat::ShortText, "1m" },
+        { 1 * M, TimeOutput::Seconds, TimeFormat::ShortText, "1m 0s" },
+        { 1 * M, TimeOutput::Milliseconds, TimeFormat::ShortText, "1m 0ms" },
+        { 1 * M, TimeOutput::Microseconds, TimeFormat::ShortText, "1m 0us" }, // was "1m"
+        { 1 * M, TimeOutput::Days, TimeFormat::Numeric, "1:00:00" },
+        { 1 * M, TimeOutput::Hours, TimeFormat::Numeric, "1:00:00" },
+        { 1 * M, TimeOutput::Minutes, TimeFormat::Numeric, "1:00:00" },
+        { 1 * M, TimeOutput::Seconds, TimeFormat::Numeric, "1:00:00" },
+        { 1 * M, TimeOutput::Milliseconds, TimeFormat::Numeric, "1:00:00" },
+        { 1 * M, TimeOutput::Microseconds, TimeFormat::Numeric, "1:00:00" },
+
+        { 1 * H + 1 * S, TimeOutput::Days, TimeFormat::FullText, "0 Days" },
+        { 1 * H + 1 * S, TimeOutput::Hours, TimeFormat::FullText, "1 Hour" },
+        { 1 * H + 1 * S, TimeOutput::Minutes, TimeFormat::FullText, "1 Hour 0 Minutes" },
+        { 1 * H + 1 * S, TimeOutput::Seconds, TimeFormat::FullText, "1 Hour 1 Second" },
+        { 1 * H + 1 * S, TimeOutput::Milliseconds, TimeFormat::FullText, "1 Hour 1 Second 0 Milliseconds" },
+        { 1 * H + 1 * S, TimeOutput::Microseconds, TimeFormat::FullText, "1 Hour 1 Second 0 Microseconds" }, // was "1 Hour 1 Second"
+        { 1 * H + 1 * S, TimeOutput::Days, TimeFormat::ShortText, "0d" },
+        { 1 * H + 1 * S, TimeOutput::Hours, TimeFormat::ShortText, "1h" },
+        { 1 * H + 1 * S, TimeOutput::Minutes, TimeFormat::ShortText, "1h 0m" },
+        { 1 * H + 1 * S, TimeOutput::Seconds, TimeFormat::ShortText, "1h 1s" },
+        { 1 * H + 1 * S, TimeOutput::Milliseconds, TimeFormat::ShortText, "1h 1s 0ms" },
+        { 1 * H + 1 * S, TimeOutput::Microseconds, TimeFormat::ShortText, "1h 1s 0us" }, // was "1h 1s"
+        { 1 * H + 1 * S, TimeOutput::Days, TimeFormat::Numeric, "1:00:01:00" },
+        { 1 * H + 1 * S, TimeOutput::Hours, TimeFormat::Numeric, "1:00:01:00" },
+        { 1 * H + 1 * S, TimeOutput::Minutes, TimeFormat::Numeric, "1:00:01:00" },
+        { 1 * H + 1 * S, TimeOutput::Seconds, TimeFormat::Numeric, "1:00:01:00" },
+        { 1 * H + 1 * S, TimeOutput::Milliseconds, TimeFormat::Numeric, "1:00:01:00" },
+        { 1 * H + 1 * S, TimeOutput::Microseconds, TimeFormat::Numeric, "1:00:01:00" },
+
+        { 3 * H + 2 * M, TimeOutput::Days, TimeFormat::FullText, "0 Days" },
+        { 3 * H + 2 * M, TimeOutput::Hours, TimeFormat::FullText, "3 Hours" },
+        { 3 * H + 2 * M, TimeOutput::Minutes, TimeFormat::FullText, "3 Hours 2 Minutes" },
+        { 3 * H + 2 * M, TimeOutput::Seconds, TimeFormat::FullText, "3 Hours 2 Minutes 0 Seconds" },
+        { 3 * H + 2 * M, TimeOutput::Milliseconds, TimeFormat::FullText, "3 Hours 2 Minutes 0 Milliseconds" },
+        { 3 * H + 2 * M, TimeOutput::Microseconds, TimeFormat::FullText, "3 Hours 2 Minutes 0 Microseconds" }, // was "3 Hours 2 Minutes"
+        { 3 * H + 2 * M, TimeOutput::Days, TimeFormat::ShortText, "0d" },
+        { 3 * H + 2 * M, TimeOutput::Hours, TimeFormat::ShortText, "3h" },
+        { 3 * H + 2 * M, TimeOutput::Minutes, TimeFormat::ShortText, "3h 2m" },
+        { 3 * H + 2 * M, TimeOutput::Seconds, TimeFormat::ShortText, "3h 2m 0s" },
+        { 3 * H + 2 * M, TimeOutput::Milliseconds, TimeFormat::ShortText, "3h 2m 0ms" },
+        { 3 * H + 2 * M, TimeOutput::Microseconds, TimeFormat::ShortText, "3h 2m 0us" }, // was "3h 2m"
+        { 3 * H + 2 * M, TimeOutput::Days, TimeFormat::Numeric, "3:02:00:00" },
+        { 3 * H + 2 * M, TimeOutput::Hours, TimeFormat::Numeric, "3:02:00:00" },
+        { 3 * H + 2 * M, TimeOutput::Minutes, TimeFormat::Numeric, "3:02:00:00" },
+        { 3 * H + 2 * M, TimeOutput::Seconds, TimeFormat::Numeric, "3:02:00:00" },
+        { 3 * H + 2 * M, TimeOutput::Milliseconds, TimeFormat::Numeric, "3:02:00:00" },
+        { 3 * H + 2 * M, TimeOutput::Microseconds, TimeFormat::Numeric, "3:02:00:00" },
+
+        { 1 * D, TimeOutput::Days, TimeFormat::FullText, "1 Day" },
+        { 1 * D, TimeOutput::Hours, TimeFormat::FullText, "1 Day 0 Hours" },
+        { 1 * D, TimeOutput::Minutes, TimeFormat::FullText, "1 Day 0 Minutes" },
+        { 1 * D, TimeOutput::Seconds, TimeFormat::FullText, "1 Day 0 Seconds" },
+        { 1 * D, TimeOutput::Milliseconds, TimeFormat::FullText, "1 Day 0 Milliseconds" },
+        { 1 * D, TimeOutput::Microseconds, TimeFormat::FullText, "1 Day 0 Microseconds" }, // was "1 Day"
+        { 1 * D, TimeOutput::Days, TimeFormat::ShortText, "1d" },
+        { 1 * D, TimeOutput::Hours, TimeFormat::ShortText, "1d 0h" },
+        { 1 * D, TimeOutput::Minutes, TimeFormat::ShortText, "1d 0m" },
+        { 1 * D, TimeOutput::Seconds, TimeFormat::ShortText, "1d 0s" },
+        { 1 * D, TimeOutput::Milliseconds, TimeFormat::ShortText, "1d 0ms" },
+        { 1 * D, TimeOutput::Microseconds, TimeFormat::ShortText, "1d 0us" }, // was "1d"
+        { 1 * D, TimeOutput::Days, TimeFormat::Numeric, "1:00:00:00:00" },
+        { 1 * D, TimeOutput::Hours, TimeFormat::Numeric, "1:00:00:00:00" },
+        { 1 * D, TimeOutput::Minutes, TimeFormat::Numeric, "1:00:00:00:00" },
+        { 1 * D, TimeOutput::Seconds, TimeFormat::Numeric, "1:00:00:00:00" },
+        { 1 * D, TimeOutput::Milliseconds, TimeFormat::Numeric, "1:00:00:00:00" },
+        { 1 * D, TimeOutput::Microseconds, TimeFormat::Numeric, "1:00:00:00:00" },
+
+        { 2 * D + 1 * H + 1 * M + 1 * S + 1 * MS + 1 * US, TimeOutput::Days, TimeFormat::FullText, "2 Days" },
+        { 2 * D + 1 * H + 1 * M + 1 * S + 1 * MS + 1 * US, TimeOutput::Hours, TimeFormat::FullText, "2 Days 1 Hour" },
+        { 2 * D + 1 * H + 1 * M + 1 * S + 1 * MS + 1 * US, TimeOutput::Minutes, TimeFormat::FullText, "2 Days 1 Hour 1 Minute" },
+        { 2 * D + 1 * H + 1 * M + 1 * S + 1 * MS + 1 * US, TimeOutput::Seconds, TimeFormat::FullText, "2 Days 1 Hour 1 Minute 1 Second" },
+        { 2 * D + 1 * H + 1 * M + 1 * S + 1 * MS + 1 * US, TimeOutput::Milliseconds, TimeFormat::FullText, "2 Days 1 Hour 1 Minute 1 Second 1 Millisecond" },
+        { 2 * D + 1 * H + 1 * M + 1 * S + 1 * MS + 1 * US, TimeOutput::Microseconds, TimeFormat::FullText, "2 Days 1 Hour 1 Minute 1 Second 1 Millisecond 1 Microsecond" },
+        { 2 * D + 1 * H + 1 * M + 1 * S + 1 * MS + 1 * US, TimeOutput::Days, TimeFormat::ShortText, "2d" },
+        { 2 * D + 1 * H + 1 * M + 1 * S + 1 * MS + 1 * US, TimeOutput::Hours, TimeFormat::ShortText, "2d 1h" },
+        { 2 * D + 1 * H + 1 * M + 1 * S + 1 * MS + 1 * US, TimeOutput::Minutes, TimeFormat::ShortText, "2d 1h 1m" },
+        { 2 * D + 1 * H + 1 * M + 1 * S + 1 * MS + 1 * US, TimeOutput::Seconds, TimeFormat::ShortText, "2d 1h 1m 1s" },
+        { 2 * D + 1 * H + 1 * M + 1 * S + 1 * MS + 1 * US, TimeOutput::Milliseconds, TimeFormat::ShortText, "2d 1h 1m 1s 1ms" },
+        { 2 * D + 1 * H + 1 * M + 1 * S + 1 * MS + 1 * US, TimeOutput::Microseconds, TimeFormat::ShortText, "2d 1h 1m 1s 1ms 1us" },
+        { 2 * D + 1 * H + 1 * M + 1 * S + 1 * MS + 1 * US, TimeOutput::Days, TimeFormat::Numeric, "2:01:01:01:01" },
+        { 2 * D + 1 * H + 1 * M + 1 * S + 1 * MS + 1 * US, TimeOutput::Hours, TimeFormat::Numeric, "2:01:01:01:01" },
+        { 2 * D + 1 * H + 1 * M + 1 * S + 1 * MS + 1 * US, TimeOutput::Minutes, TimeFormat::Numeric, "2:01:01:01:01" },
+        { 2 * D + 1 * H + 1 * M + 1 * S + 1 * MS + 1 * US, TimeOutput::Seconds, TimeFormat::Numeric, "2:01:01:01:01" },
+        { 2 * D + 1 * H + 1 * M + 1 * S + 1 * MS + 1 * US, TimeOutput::Milliseconds, TimeFormat::Numeric, "2:01:01:01:01" },
+        { 2 * D + 1 * H + 1 * M + 1 * S + 1 * MS + 1 * US, TimeOutput::Microseconds, TimeFormat::Numeric, "2:01:01:01:01" },
+
+        { 40 * D + 23 * H + 59 * M + 59 * S + 999 * MS + 999 * US, TimeOutput::Days, TimeFormat::FullText, "40 Days" },
+        { 40 * D + 23 * H + 59 * M + 59 * S + 999 * MS + 999 * US, TimeOutput::Hours, TimeFormat::FullText, "40 Days 23 Hours" },
+        { 40 * D + 23 * H + 59 * M + 59 * S + 999 * MS + 999 * US, TimeOutput::Minutes, TimeFormat::FullText, "40 Days 23 Hours 59 Minutes" },
+        { 40 * D + 23 * H + 59 * M + 59 * S + 999 * MS + 999 * US, TimeOutput::Seconds, TimeFormat::FullText, "40 Days 23 Hours 59 Minutes 59 Seconds" },
+        { 40 * D + 23 * H + 59 * M + 59 * S + 999 * MS + 999 * US, TimeOutput::Milliseconds, TimeFormat::FullText, "40 Days 23 Hours 59 Minutes 59 Seconds 999 Milliseconds" },
+        { 40 * D + 23 * H + 59 * M + 59 * S + 999 * MS + 999 * US, TimeOutput::Microseconds, TimeFormat::FullText, "40 Days 23 Hours 59 Minutes 59 Seconds 999 Milliseconds 999 Microseconds" },
+        { 40 * D + 23 * H + 59 * M + 59 * S + 999 * MS + 999 * US, TimeOutput::Days, TimeFormat::ShortText, "40d" },
+        { 40 * D + 23 * H + 59 * M + 59 * S + 999 * MS + 999 * US, TimeOutput::Hours, TimeFormat::ShortText, "40d 23h" },
+        { 40 * D + 23 * H + 59 * M + 59 * S + 999 * MS + 999 * US, TimeOutput::Minutes, TimeFormat::ShortText, "40d 23h 59m" },
+        { 40 * D + 23 * H + 59 * M + 59 * S + 999 * MS + 999 * US, TimeOutput::Seconds, TimeFormat::ShortText, "40d 23h 59m 59s" },
+        { 40 * D + 23 * H + 59 * M + 59 * S + 999 * MS + 999 * US, TimeOutput::Milliseconds, TimeFormat::ShortText, "40d 23h 59m 59s 999ms" },
+        { 40 * D + 23 * H + 59 * M + 59 * S + 999 * MS + 999 * US, TimeOutput::Microseconds, TimeFormat::ShortText, "40d 23h 59m 59s 999ms 999us" },
+        { 40 * D + 23 * H + 59 * M + 59 * S + 999 * MS + 999 * US, TimeOutput::Days, TimeFormat::Numeric, "40:23:59:59:999" },
+        { 40 * D + 23 * H + 59 * M + 59 * S + 999 * MS + 999 * US, TimeOutput::Hours, TimeFormat::Numeric, "40:23:59:59:999" },
+        { 40 * D + 23 * H + 59 * M + 59 * S + 999 * MS + 999 * US, TimeOutput::Minutes, TimeFormat::Numeric, "40:23:59:59:999" },
+        { 40 * D + 23 * H + 59 * M + 59 * S + 999 * MS + 999 * US, TimeOutput::Seconds, TimeFormat::Numeric, "40:23:59:59:999" },
+        { 40 * D + 23 * H + 59 * M + 59 * S + 999 * MS + 999 * US, TimeOutput::Milliseconds, TimeFormat::Numeric, "40:23:59:59:999" },
+        { 40 * D + 23 * H + 59 * M + 59 * S + 999 * MS + 999 * US, TimeOutput::Microseconds, TimeFormat::Numeric, "40:23:59:59:999" },
+    };
+
+    std::string_view GetName(TimeOutput output)
+    {
+        switch (output)
+        {
+            case TimeOutput::Days: return "Days";
+            case TimeOutput::Hours: return "Hours";
+            case TimeOutput::Minutes: return "Minutes";
+            case TimeOutput::Seconds: return "Seconds";
+            case TimeOutput::Milliseconds: return "Milliseconds";
+            case TimeOutput::Microseconds: return "Microseconds";
+            default: return "Unknown";
+        }
+    }
+
+    std::string_view GetName(TimeFormat format)
+    {
+        switch (format)
+        {
+            case TimeFormat::FullText: return "FullText";
+            case TimeFormat::ShortText: return "ShortText";
+            case TimeFormat::Numeric: return "Numeric";
+            default: return "Unknown";
+        }
+    }
+}
+
+void TestTimeStrings()
+{
+    using namespace Warhead::Time;
+
+    for (TimeStringCase const& test : TimeStringCases)
+    {
+        std::string context = fmt::format("{}us {} {}", test.Duration, GetName(test.Output), GetName(test.Format));
+
+        TEST_CHECK_EQUAL(ToTimeString<Microseconds>(test.Duration, test.Output, test.Format), test.Expected, context);
+        TEST_CHECK_EQUAL(ToTimeString(Microseconds(test.Duration), test.Output, test.Format), test.Expected, context);
+
+        // Appends behind what the buffer already holds
+        fmt::memory_buffer buffer;
+        buffer.append(std::string_view("> "));
+        AppendTimeString(buffer, test.Duration, test.Output, test.Format);
+        TEST_CHECK_EQUAL(fmt::to_string(buffer), fmt::format("> {}", test.Expected), context);
+
+        // The coarser units only scale their input
+        if (test.Duration % MS == 0)
+            TEST_CHECK_EQUAL(ToTimeString<Milliseconds>(test.Duration / MS, test.Output, test.Format), test.Expected, context);
+
+        if (test.Duration % S == 0)
+            TEST_CHECK_EQUAL(ToTimeString<Seconds>(test.Duration / S, test.Output, test.Format), test.Expected, context);
+
+        if (test.Duration % M == 0)
+            TEST_CHECK_EQUAL(ToTimeString<Minutes>(test.Duration / M, test.Output, test.Format), test.Expected, context);
+    }
+
+    TEST_CHECK_EQUAL(ToTimeString<Seconds>(std::string_view("1d2h3m4s")), "1d 2h 3m 4s", "time string input");
+    TEST_CHECK_EQUAL(TimeStringTo<Seconds>("1d2h3m4s"), uint32(D / S + 2 * H / S + 3 * M / S + 4), "TimeStringTo");
+    TEST_CHECK_EQUAL(TimeStringTo<Seconds>("5x"), uint32(0), "TimeStringTo bad format");
+}
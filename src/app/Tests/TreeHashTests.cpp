@@ -0,0 +1,130 @@
+/*
+ * This file is part of the WarheadApp Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "TestCheck.h"
+#include "TreeHash.h"
+#include <filesystem>
+#include <fstream>
+
+namespace
+{
+    using Warhead::Crypto::TreeHash;
+
+    constexpr std::size_t LEAF_SIZE = 4;
+
+    // The vectors documented in TreeHash.h, SHA256 with 4 byte leaves
+    struct TreeHashVector
+    {
+        std::string Data;
+        std::string_view Root;
+    };
+
+    std::string GetPattern(std::size_t repeats)
+    {
+        std::string data;
+        data.reserve(256 * repeats);
+
+        for (std::size_t i = 0; i < repeats; ++i)
+            for (uint32 byte = 0; byte < 256; ++byte)
+                data.push_back(char(byte));
+
+        return data;
+    }
+
+    std::string ToHex(TreeHash::Digest const& digest)
+    {
+        return Warhead::Crypto::DigestToHex(digest.data(), digest.size());
+    }
+
+    void WriteFile(std::filesystem::path const& path, std::string_view data, bool append)
+    {
+        std::ofstream file(path, std::ios::binary | (append ? std::ios::app : std::ios::trunc));
+        file.write(data.data(), std::streamsize(data.size()));
+    }
+}
+
+void TestTreeHash()
+{
+    TreeHashVector const vectors[] =
+    {
+        { "",           "6e340b9cffb37a989ca544e6bb780a2c78901d3fb33738768511a30617afa01d" },
+        { "abc",        "609f6e36d2405585188d5cfd761f407c7cc46a7d3f314c88270469dde315fcd1" },
+        { "abcdefghij", "2a5b33d54d89d05737a7dd798d9862d55951564aafb5460691ad8a7a9ab6c678" },
+        { GetPattern(40), "8762bb7808aef80a3db7969d45a6ede19fd3e5e497ceab46873f284225aadae6" }
+    };
+
+    for (TreeHashVector const& vector : vectors)
+    {
+        std::string context = fmt::format("Hash() of {} bytes", vector.Data.size());
+        TEST_CHECK_EQUAL(ToHex(TreeHash::Hash(vector.Data.data(), vector.Data.size(), Warhead::Crypto::HashAlgorithm::SHA256, LEAF_SIZE)), vector.Root, context);
+    }
+
+    std::filesystem::path path = std::filesystem::temp_directory_path() / "WarheadTreeHashTest.bin";
+
+    // Appending only rehashes the last partial leaf and the new ones
+    {
+        TreeHash tree(Warhead::Crypto::HashAlgorithm::SHA256, LEAF_SIZE);
+
+        WriteFile(path, "abc", false);
+        TEST_CHECK(tree.Update(path.string(), 1));
+        TEST_CHECK_EQUAL(tree.GetRootHex(), vectors[1].Root, "Update() of abc");
+
+        WriteFile(path, "defghij", true);
+        TEST_CHECK(tree.Update(path.string(), 2));
+        TEST_CHECK_EQUAL(tree.GetRootHex(), vectors[2].Root, "Update() after appending defghij");
+        TEST_CHECK_EQUAL(tree.GetLeaves().size(), std::size_t(3), "leaves of abcdefghij");
+        TEST_CHECK_EQUAL(tree.GetSize(), uint64(10), "size of abcdefghij");
+        TEST_CHECK_EQUAL(ToHex(tree.GetLeaves()[0]), ToHex(TreeHash::Hash("abcd", 4, Warhead::Crypto::HashAlgorithm::SHA256, LEAF_SIZE)), "partial leaf rehashed");
+
+        // A shrunk file is hashed from scratch
+        WriteFile(path, "abc", false);
+        TEST_CHECK(tree.Update(path.string()));
+        TEST_CHECK_EQUAL(tree.GetRootHex(), vectors[1].Root, "Update() after truncating");
+    }
+
+    // Parallel leaves and several appends of odd sizes give the same root as one pass
+    {
+        std::string const& data = vectors[3].Data;
+        TreeHash tree(Warhead::Crypto::HashAlgorithm::SHA256, LEAF_SIZE);
+
+        WriteFile(path, {}, false);
+
+        for (std::size_t offset = 0; offset < data.size();)
+        {
+            std::size_t size = std::min<std::size_t>(data.size() - offset, 1 + offset % 1531);
+            WriteFile(path, std::string_view(data).substr(offset, size), true);
+            offset += size;
+
+            TEST_CHECK(tree.Update(path.string(), 4));
+            TEST_CHECK_EQUAL(tree.GetRootHex(), ToHex(TreeHash::Hash(data.data(), offset, Warhead::Crypto::HashAlgorithm::SHA256, LEAF_SIZE)),
+                fmt::format("Update() after appending up to {} bytes", offset));
+        }
+
+        TEST_CHECK_EQUAL(tree.GetRootHex(), vectors[3].Root, "Update() of the pattern");
+
+        TreeHash fresh(Warhead::Crypto::HashAlgorithm::SHA256, LEAF_SIZE);
+        TEST_CHECK(fresh.Update(path.string(), 3));
+        TEST_CHECK_EQUAL(fresh.GetRootHex(), vectors[3].Root, "Update() of the whole pattern");
+    }
+
+    std::error_code error;
+    std::filesystem::remove(path, error);
+
+    TreeHash missing;
+    TEST_CHECK(!missing.Update(path.string()));
+}
@@ -0,0 +1,140 @@
+/*
+ * This file is part of the WarheadApp Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "TestCheck.h"
+#include "CryptoHash.h"
+#include "XXHash.h"
+#include <algorithm>
+#include <vector>
+
+namespace
+{
+    constexpr uint64 SEED = UI64LIT(0x9E3779B185EBCA8D);
+
+    // Reference xxHash 0.8 results over bytes 0, 1, 2, ... 255, 0, 1, ...
+    struct XXHashVector
+    {
+        std::size_t Size;
+        uint64 Seed;
+        uint64 XXH64;
+        uint64 XXH3;
+    };
+
+    // Streams the input in pieces of 'chunk' bytes
+    template<class Engine>
+    uint64 HashInChunks(std::vector<uint8> const& data, std::size_t size, uint64 seed, std::size_t chunk)
+    {
+        Engine engine(seed);
+
+        for (std::size_t offset = 0; offset < size; offset += chunk)
+            engine.Update(data.data() + offset, std::min(chunk, size - offset));
+
+        // Empty updates must not change anything
+        engine.Update(nullptr, 0);
+        return engine.Digest();
+    }
+}
+
+void TestXXHash()
+{
+    XXHashVector const vectors[] =
+    {
+        {    0, 0   , UI64LIT(0xEF46DB3751D8E999), UI64LIT(0x2D06800538D394C2) },
+        {    1, 0   , UI64LIT(0xE934A84ADB052768), UI64LIT(0xC44BDFF4074EECDB) },
+        {    3, 0   , UI64LIT(0xE5C7BB4533BC65DD), UI64LIT(0x5F4299FC161C9CBB) },
+        {    4, 0   , UI64LIT(0xFFCED8604453CC1E), UI64LIT(0x60DAB036A58211F2) },
+        {    8, 0   , UI64LIT(0x884A173614B81B8D), UI64LIT(0x3A1C2D7C85AF88F8) },
+        {    9, 0   , UI64LIT(0x67D85784A7C78C5B), UI64LIT(0xE9612598145BB9DC) },
+        {   16, 0   , UI64LIT(0x44B6EF2FB84169F7), UI64LIT(0x8355E3A6F61770DB) },
+        {   17, 0   , UI64LIT(0x5603E60C527599B6), UI64LIT(0x9EF341A99DE37328) },
+        {   32, 0   , UI64LIT(0xCBF59C5116FF32B4), UI64LIT(0x3523581FE96E4C05) },
+        {   33, 0   , UI64LIT(0x0C535D1ACAFB8EAD), UI64LIT(0xE68C56BA88991E58) },
+        {   64, 0   , UI64LIT(0xF7C67301DB6713F0), UI64LIT(0x6187EB9089B0ED55) },
+        {   65, 0   , UI64LIT(0xC31EB63B2AE4465B), UI64LIT(0x6928C76CE90422D0) },
+        {   96, 0   , UI64LIT(0x450BAA11F6739216), UI64LIT(0x278A3E12EA046DFB) },
+        {   97, 0   , UI64LIT(0xC93EC3DB0DD47E34), UI64LIT(0xE7220282DC4E14F4) },
+        {  128, 0   , UI64LIT(0x7A7FE14647B9AB92), UI64LIT(0x85C6174C7FF4C46B) },
+        {  129, 0   , UI64LIT(0x0BA25DFD6E891FCF), UI64LIT(0xEC7642B431BA3E5A) },
+        {  240, 0   , UI64LIT(0x012947F0DA6A27B1), UI64LIT(0x375A384D957FE865) },
+        {  241, 0   , UI64LIT(0x8D643F23BF2808E1), UI64LIT(0x02E8CD95421C6D02) },
+        {  256, 0   , UI64LIT(0x1FACBE8406CD904B), UI64LIT(0x9408A4433B952D71) },
+        {  257, 0   , UI64LIT(0x80381162756D40E6), UI64LIT(0xD02C25704C5CEE8A) },
+        { 1024, 0   , UI64LIT(0x6F3914F18FE4DF57), UI64LIT(0xA870F92984398D22) },
+        { 1088, 0   , UI64LIT(0x102B0C9DA10903A6), UI64LIT(0x280D4E7CB6579EB6) },
+        { 2048, 0   , UI64LIT(0x68534A48B7BF5F4D), UI64LIT(0xDD420471FF96BD00) },
+        { 4096, 0   , UI64LIT(0x0F6E64BE186AF6A4), UI64LIT(0xEB4B7C3707879151) },
+        {    0, SEED, UI64LIT(0x0B303D920EC349DF), UI64LIT(0xA8A6B918B2F0364A) },
+        {    1, SEED, UI64LIT(0x9C6678669FCD2E6D), UI64LIT(0x032BE332DD766EF8) },
+        {    3, SEED, UI64LIT(0xF465322E2768434F), UI64LIT(0x1A6E223BE5F46239) },
+        {    4, SEED, UI64LIT(0x6105C2E67219DEC8), UI64LIT(0x305FB4C44F8D6951) },
+        {    8, SEED, UI64LIT(0xB55F66AFFCC24E70), UI64LIT(0xCE514ADFB5603640) },
+        {    9, SEED, UI64LIT(0x458FBF0E5D7D5A33), UI64LIT(0xDEFB5A4D8E24DA5B) },
+        {   16, SEED, UI64LIT(0x21E52D46A74045EB), UI64LIT(0x39B05B5E53840A8F) },
+        {   17, SEED, UI64LIT(0xEB5E58DC671EE52D), UI64LIT(0x290132B0798B2853) },
+        {   32, SEED, UI64LIT(0xBC9B546AB584ABD0), UI64LIT(0x17EB748080355380) },
+        {   33, SEED, UI64LIT(0xA11BD47EF728DA75), UI64LIT(0x37FA4B8BC3970FD4) },
+        {   64, SEED, UI64LIT(0x6517F78C897AD8FE), UI64LIT(0x4823512B5372DF55) },
+        {   65, SEED, UI64LIT(0xCD74B96651A657AA), UI64LIT(0x1EB2DF4234B42692) },
+        {   96, SEED, UI64LIT(0x2EA4B2014C1B1C0B), UI64LIT(0x4147D44873BFC5D7) },
+        {   97, SEED, UI64LIT(0x2CBD6A6536FACD0B), UI64LIT(0x3220FCCF6B55D943) },
+        {  128, SEED, UI64LIT(0xCC8EBE10F200FC4C), UI64LIT(0x3B87A094E01C19EE) },
+        {  129, SEED, UI64LIT(0xDB72AFD0AFF74F5E), UI64LIT(0x7D07BA727C76F7BA) },
+        {  240, SEED, UI64LIT(0x3683612828068F5E), UI64LIT(0x331D5D4AF197FB6B) },
+        {  241, SEED, UI64LIT(0xAB50D06EE665DCC2), UI64LIT(0x1F049462CA4EDF9A) },
+        {  256, SEED, UI64LIT(0x47088F71BEBD771A), UI64LIT(0xE3C7145603756908) },
+        {  257, SEED, UI64LIT(0x282FA56915D49603), UI64LIT(0xE335F2BFE0DF93CF) },
+        { 1024, SEED, UI64LIT(0x23481C869EFF426A), UI64LIT(0xECF7B854027D0608) },
+        { 1088, SEED, UI64LIT(0xCAC590F00285ED8E), UI64LIT(0xBDB6343796B4CC02) },
+        { 2048, SEED, UI64LIT(0xAF6F17553844B4FE), UI64LIT(0x9A14800004A41EC3) },
+        { 4096, SEED, UI64LIT(0xACB1A099A130EC08), UI64LIT(0x32858C850E714A75) }
+    };
+
+    std::vector<uint8> data(4096);
+    for (std::size_t i = 0; i < data.size(); ++i)
+        data[i] = uint8(i);
+
+    for (auto const& vector : vectors)
+    {
+        std::string context = fmt::format("{} bytes, seed {:x}", vector.Size, vector.Seed);
+
+        TEST_CHECK_EQUAL(Warhead::Crypto::XXH64::Hash(data.data(), vector.Size, vector.Seed), vector.XXH64, "XXH64::Hash " + context);
+        TEST_CHECK_EQUAL(Warhead::Crypto::XXH3::Hash(data.data(), vector.Size, vector.Seed), vector.XXH3, "XXH3::Hash " + context);
+
+        // Chunks around the 32 byte XXH64 stripe, the 64 byte XXH3 stripe and the 256 byte XXH3 buffer
+        for (std::size_t chunk : { 1, 7, 64, 255, 1000 })
+        {
+            std::string chunkContext = fmt::format("{} in {} byte chunks", context, chunk);
+
+            TEST_CHECK_EQUAL(HashInChunks<Warhead::Crypto::XXH64>(data, vector.Size, vector.Seed, chunk), vector.XXH64, "XXH64::Update " + chunkContext);
+            TEST_CHECK_EQUAL(HashInChunks<Warhead::Crypto::XXH3>(data, vector.Size, vector.Seed, chunk), vector.XXH3, "XXH3::Update " + chunkContext);
+        }
+    }
+
+    // Digest leaves the state alone, Reset starts over
+    Warhead::Crypto::XXH3 xxh3;
+    xxh3.Update(data.data(), 1000);
+    TEST_CHECK_EQUAL(xxh3.Digest(), xxh3.Digest(), "XXH3::Digest twice");
+    xxh3.Reset(SEED);
+    xxh3.Update(data.data(), 241);
+    TEST_CHECK_EQUAL(xxh3.Digest(), UI64LIT(0x1F049462CA4EDF9A), "XXH3::Reset with seed");
+
+    // Canonical big endian hex, as xxhsum prints it
+    Warhead::Crypto::Hasher hasher(Warhead::Crypto::HashAlgorithm::XXH3);
+    hasher.Update("abc", 3);
+    TEST_CHECK_EQUAL(hasher.HexDigest(), "78af5f94892f3950", "Hasher XXH3 \"abc\"");
+}
@@ -16,20 +16,24 @@
  */
 
 #include "Config.h"
+#include "Allocator.h"
+#include "Arena.h"
+#include "FlatHashMap.h"
 #include "Log.h"
 #include "StringConvert.h"
 #include "StringFormat.h"
 #include "Util.h"
+#include <algorithm>
 #include <mutex>
 #include <fstream>
-#include <unordered_map>
+#include <unordered_set>
 
 namespace
 {
     std::string _filename;
     std::vector<std::string> _additonalFiles;
     std::vector<std::string> _args;
-    std::unordered_map<std::string /*name*/, std::string /*value*/> _configOptions;
+    Warhead::FlatHashMap<std::string /*name*/, std::string /*value*/> _configOptions;
     std::mutex _configLock;
 
     // Check system configs like *server.conf*
@@ -54,24 +58,22 @@ namespace
         LOG_ERROR("%s", message.c_str());
     }
 
-    void AddKey(std::string const& optionName, std::string const& optionKey, bool replace = true)
+    void AddKey(std::string_view optionName, std::string_view optionKey, bool replace = true)
     {
         auto const& itr = _configOptions.find(optionName);
         if (itr != _configOptions.end())
         {
             if (!replace)
             {
-                LOG_ERROR("server", "> Config: Option '%s' is exist! Option key - '%s'", optionName.c_str(), itr->second.c_str());
+                LOG_ERROR("server", "> Config: Option '%s' is exist! Option key - '%s'", std::string(optionName).c_str(), itr->second.c_str());
                 return;
             }
-
-            _configOptions.erase(optionName);
         }
 
-        _configOptions.emplace(optionName, optionKey);
+        _configOptions.insert_or_assign(std::string(optionName), std::string(optionKey));
     }
 
-    void ParseFile(std::string const& file)
+    void ParseFile(std::string const& file, Warhead::Arena& arena)
     {
         std::ifstream in(file);
 
@@ -80,12 +82,15 @@ namespace
 
         uint32 count = 0;
         uint32 lineNumber = 0;
-        std::unordered_map<std::string /*name*/, std::string /*value*/> fileConfigs;
 
-        auto IsDuplicateOption = [&](std::string const& confOption)
+        // Names and values point into the arena until the whole file is read, in file order
+        std::pmr::memory_resource* resource = arena.GetResource();
+        std::pmr::vector<std::pair<std::string_view /*name*/, std::string_view /*value*/>> fileConfigs(resource);
+        std::pmr::unordered_set<std::string_view> fileNames(resource);
+
+        auto IsDuplicateOption = [&](std::string_view confOption)
         {
-            auto const& itr = fileConfigs.find(confOption);
-            if (itr != fileConfigs.end())
+            if (!fileNames.emplace(confOption).second)
             {
                 PrintError(file, "> Config::LoadFile: Dublicate key name '%s' in config file '%s'", std::string(confOption).c_str(), file.c_str());
                 return true;
@@ -94,10 +99,11 @@ namespace
             return false;
         };
 
+        std::pmr::string line(resource);
+
         while (in.good())
         {
             lineNumber++;
-            std::string line;
             std::getline(in, line);
 
             // read line error
@@ -105,44 +111,45 @@ namespace
                 throw ConfigException(Warhead::StringFormat("> Config::LoadFile: Failure to read line number %u in file '%s'", lineNumber, file.c_str()));
 
             // remove whitespace in line
-            line = Warhead::String::Trim(line, in.getloc());
+            std::string_view lineView = Warhead::String::TrimView(line);
 
-            if (line.empty())
+            if (lineView.empty())
             {
                 continue;
             }
 
             // comments
-            if (line[0] == '#' || line[0] == '[')
+            if (lineView[0] == '#' || lineView[0] == '[')
             {
                 continue;
             }
 
-            size_t found = line.find_first_of('#');
-            if (found != std::string::npos)
+            size_t found = lineView.find_first_of('#');
+            if (found != std::string_view::npos)
             {
-                line = line.substr(0, found);
+                lineView = lineView.substr(0, found);
             }
 
-            auto const equal_pos = line.find('=');
+            auto const equal_pos = lineView.find('=');
 
-            if (equal_pos == std::string::npos || equal_pos == line.length())
+            if (equal_pos == std::string_view::npos || equal_pos == lineView.length())
             {
                 PrintError(file, "> Config::LoadFile: Failure to read line number %u in file '%s'. Skip this line", lineNumber, file.c_str());
                 continue;
             }
 
-            auto entry = Warhead::String::Trim(line.substr(0, equal_pos), in.getloc());
-            auto value = Warhead::String::Trim(line.substr(equal_pos + 1, std::string::npos), in.getloc());
-
-            value.erase(std::remove(value.begin(), value.end(), '"'), value.end());
+            std::string_view entry = arena.CopyString(Warhead::String::TrimView(lineView.substr(0, equal_pos)));
+            std::string_view rawValue = Warhead::String::TrimView(lineView.substr(equal_pos + 1));
 
             // Skip if 2+ same options in one config file
             if (IsDuplicateOption(entry))
                 continue;
 
+            char* value = arena.AllocateArray<char>(rawValue.size());
+            char* valueEnd = std::remove_copy(rawValue.begin(), rawValue.end(), value, '"');
+
             // Add to temp container
-            fileConfigs.emplace(entry, value);
+            fileConfigs.emplace_back(entry, std::string_view(value, std::size_t(valueEnd - value)));
             count++;
         }
 
@@ -157,9 +164,15 @@ namespace
 
     bool LoadFile(std::string const& file)
     {
+        static Warhead::Memory::AllocationTag const allocationTag("Config");
+        Warhead::Memory::AllocationScope allocationScope(allocationTag);
+
+        // Every temporary of the file goes at once when it is done
+        Warhead::Arena arena(64 * 1024);
+
         try
         {
-            ParseFile(file);
+            ParseFile(file, arena);
             return true;
         }
         catch (const std::exception& e)
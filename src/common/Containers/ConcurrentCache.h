@@ -0,0 +1,383 @@
+/*
+ * This file is part of the WarheadApp Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef _WARHEAD_CONCURRENT_CACHE_H_
+#define _WARHEAD_CONCURRENT_CACHE_H_
+
+#include "Define.h"
+#include "Duration.h"
+#include "Timer.h"
+#include <atomic>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <shared_mutex>
+#include <vector>
+
+namespace Warhead
+{
+    /// Thread safe replacement for Poco::LRUCache and Poco::ExpireLRUCache.
+    ///
+    /// Keys are split over shards, each shard is an open addressing table (linear probing,
+    /// backward shift delete) under its own reader/writer lock, so lookups of different keys
+    /// rarely meet and lookups of the same key only share a read lock.
+    /// Eviction is CLOCK instead of exact LRU: a lookup sets the entry's reference bit,
+    /// the clock hand clears it and evicts the first entry found without one. New entries start
+    /// unreferenced, so keys that are only ever added once go first.
+    ///
+    /// It keeps Poco's method names so users can switch by changing the member type.
+    /// Differences: there are no Add/Remove/Get events, values are std::shared_ptr,
+    /// the size limit is enforced per shard (capacity / shards each).
+    template<class TKey, class TValue, class THash = std::hash<TKey>, class TKeyEqual = std::equal_to<TKey>>
+    class ConcurrentCache
+    {
+    public:
+        using ValuePtr = std::shared_ptr<TValue>;
+
+        /// expire: time to live of an entry since it was added, 0 = forever. shards: 0 = chosen from the capacity.
+        explicit ConcurrentCache(std::size_t capacity = 1024, Milliseconds expire = 0ms, uint32 shards = 0) :
+            _expire(uint64(std::max<int64>(expire.count(), 0)) * 1000000)
+        {
+            if (!shards)
+            {
+                // Enough entries per shard that the per shard limit stays close to the global one
+                shards = 16;
+                while (shards > 1 && capacity / shards < 64)
+                    shards >>= 1;
+            }
+
+            std::size_t count = 1;
+            while (count < shards)
+                count <<= 1;
+
+            _shardMask = count - 1;
+            _shards = std::make_unique<Shard[]>(count);
+
+            for (std::size_t i = 0; i < count; ++i)
+                _shards[i].Init(std::max<std::size_t>((capacity + count - 1) / count, 1));
+        }
+
+        ConcurrentCache(ConcurrentCache const&) = delete;
+        ConcurrentCache& operator=(ConcurrentCache const&) = delete;
+
+        /// Adds or replaces, restarts the time to live
+        void add(TKey const& key, TValue const& value)
+        {
+            add(key, std::make_shared<TValue>(value));
+        }
+
+        void add(TKey const& key, ValuePtr value)
+        {
+            std::size_t hash = Hash(key);
+            GetShard(hash).Insert(key, hash, std::move(value), _expire ? Warhead::Time::Now() + _expire : 0);
+        }
+
+        /// Same as add(), there are no events to tell them apart
+        void update(TKey const& key, TValue const& value) { add(key, value); }
+        void update(TKey const& key, ValuePtr value) { add(key, std::move(value)); }
+
+        /// Null if the key is missing or expired
+        ValuePtr get(TKey const& key) const
+        {
+            std::size_t hash = Hash(key);
+            return GetShard(hash).Get(key, hash, _expire ? Warhead::Time::Now() : 0);
+        }
+
+        bool has(TKey const& key) const { return get(key) != nullptr; }
+
+        void remove(TKey const& key)
+        {
+            std::size_t hash = Hash(key);
+            GetShard(hash).Remove(key, hash);
+        }
+
+        void clear()
+        {
+            for (std::size_t i = 0; i <= _shardMask; ++i)
+                _shards[i].Clear();
+        }
+
+        /// Expired entries are dropped lazily, they count until the next forceReplace() or eviction
+        std::size_t size() const
+        {
+            std::size_t size = 0;
+
+            for (std::size_t i = 0; i <= _shardMask; ++i)
+                size += _shards[i].GetSize();
+
+            return size;
+        }
+
+        /// Drops expired entries
+        void forceReplace()
+        {
+            if (!_expire)
+                return;
+
+            uint64 now = Warhead::Time::Now();
+
+            for (std::size_t i = 0; i <= _shardMask; ++i)
+                _shards[i].Purge(now);
+        }
+
+        std::set<TKey> getAllKeys() const
+        {
+            std::set<TKey> keys;
+            uint64 now = _expire ? Warhead::Time::Now() : 0;
+
+            for (std::size_t i = 0; i <= _shardMask; ++i)
+                _shards[i].GetKeys(keys, now);
+
+            return keys;
+        }
+
+    private:
+        struct Slot
+        {
+            TKey Key{};
+            ValuePtr Value;
+            uint64 Expiry = 0;
+            std::size_t Hash = 0;
+            std::atomic<bool> Referenced{ false };
+            bool Occupied = false;
+        };
+
+        class Shard
+        {
+        public:
+            void Init(std::size_t capacity)
+            {
+                // Load factor of at most 1/2 keeps the probe sequences short
+                std::size_t size = 4;
+                while (size < capacity * 2)
+                    size <<= 1;
+
+                _slots = std::make_unique<Slot[]>(size);
+                _mask = size - 1;
+                _capacity = capacity;
+            }
+
+            ValuePtr Get(TKey const& key, std::size_t hash, uint64 now) const
+            {
+                std::shared_lock<std::shared_mutex> lock(_lock);
+
+                std::size_t index = Find(key, hash);
+                if (index == NOT_FOUND)
+                    return nullptr;
+
+                Slot& slot = _slots[index];
+
+                if (now && slot.Expiry <= now)
+                    return nullptr;
+
+                // Checked first, so hot entries don't bounce the cache line between readers
+                if (!slot.Referenced.load(std::memory_order_relaxed))
+                    slot.Referenced.store(true, std::memory_order_relaxed);
+
+                return slot.Value;
+            }
+
+            void Insert(TKey const& key, std::size_t hash, ValuePtr&& value, uint64 expiry)
+            {
+                std::lock_guard<std::shared_mutex> guard(_lock);
+
+                std::size_t index = Find(key, hash);
+
+                if (index == NOT_FOUND)
+                {
+                    if (_size >= _capacity)
+                        Evict(expiry ? Warhead::Time::Now() : 0);
+
+                    index = hash & _mask;
+                    while (_slots[index].Occupied)
+                        index = (index + 1) & _mask;
+
+                    Slot& slot = _slots[index];
+                    slot.Key = key;
+                    slot.Hash = hash;
+                    slot.Occupied = true;
+                    slot.Referenced.store(false, std::memory_order_relaxed);
+                    ++_size;
+                }
+
+                Slot& slot = _slots[index];
+                slot.Value = std::move(value);
+                slot.Expiry = expiry;
+            }
+
+            void Remove(TKey const& key, std::size_t hash)
+            {
+                std::lock_guard<std::shared_mutex> guard(_lock);
+
+                std::size_t index = Find(key, hash);
+                if (index != NOT_FOUND)
+                    Erase(index);
+            }
+
+            void Clear()
+            {
+                std::lock_guard<std::shared_mutex> guard(_lock);
+
+                for (std::size_t i = 0; i <= _mask; ++i)
+                {
+                    if (_slots[i].Occupied)
+                        Reset(_slots[i]);
+                }
+
+                _size = 0;
+                _hand = 0;
+            }
+
+            void Purge(uint64 now)
+            {
+                std::lock_guard<std::shared_mutex> guard(_lock);
+
+                for (std::size_t i = 0; i <= _mask;)
+                {
+                    // Erase() may shift the next entry into this slot
+                    if (_slots[i].Occupied && _slots[i].Expiry <= now)
+                        Erase(i);
+                    else
+                        ++i;
+                }
+            }
+
+            std::size_t GetSize() const
+            {
+                std::shared_lock<std::shared_mutex> lock(_lock);
+                return _size;
+            }
+
+            void GetKeys(std::set<TKey>& keys, uint64 now) const
+            {
+                std::shared_lock<std::shared_mutex> lock(_lock);
+
+                for (std::size_t i = 0; i <= _mask; ++i)
+                {
+                    Slot const& slot = _slots[i];
+
+                    if (slot.Occupied && (!now || slot.Expiry > now))
+                        keys.insert(slot.Key);
+                }
+            }
+
+        private:
+            static constexpr std::size_t NOT_FOUND = std::size_t(-1);
+
+            std::size_t Find(TKey const& key, std::size_t hash) const
+            {
+                for (std::size_t index = hash & _mask; _slots[index].Occupied; index = (index + 1) & _mask)
+                {
+                    Slot const& slot = _slots[index];
+
+                    if (slot.Hash == hash && TKeyEqual()(slot.Key, key))
+                        return index;
+                }
+
+                return NOT_FOUND;
+            }
+
+            static void Reset(Slot& slot)
+            {
+                slot.Key = TKey();
+                slot.Value.reset();
+                slot.Occupied = false;
+            }
+
+            /// Backward shift instead of tombstones, later entries of the probe sequence move into the gap
+            void Erase(std::size_t index)
+            {
+                Reset(_slots[index]);
+                --_size;
+
+                for (std::size_t next = (index + 1) & _mask; _slots[next].Occupied; next = (next + 1) & _mask)
+                {
+                    Slot& slot = _slots[next];
+                    std::size_t home = slot.Hash & _mask;
+
+                    // Stays if its home lies cyclically in (index, next]
+                    if (((next - home) & _mask) < ((next - index) & _mask))
+                        continue;
+
+                    Slot& gap = _slots[index];
+                    gap.Key = std::move(slot.Key);
+                    gap.Value = std::move(slot.Value);
+                    gap.Expiry = slot.Expiry;
+                    gap.Hash = slot.Hash;
+                    gap.Referenced.store(slot.Referenced.load(std::memory_order_relaxed), std::memory_order_relaxed);
+                    gap.Occupied = true;
+
+                    Reset(slot);
+                    index = next;
+                }
+            }
+
+            /// CLOCK: expired or unreferenced entries go, referenced ones get a second chance
+            void Evict(uint64 now)
+            {
+                for (;;)
+                {
+                    Slot& slot = _slots[_hand];
+
+                    if (slot.Occupied)
+                    {
+                        if ((now && slot.Expiry <= now) || !slot.Referenced.exchange(false, std::memory_order_relaxed))
+                        {
+                            // The hand stays, the slot may hold a shifted entry now
+                            Erase(_hand);
+                            return;
+                        }
+                    }
+
+                    _hand = (_hand + 1) & _mask;
+                }
+            }
+
+            mutable std::shared_mutex _lock;
+            std::unique_ptr<Slot[]> _slots;
+            std::size_t _mask = 0;
+            std::size_t _capacity = 0;
+            std::size_t _size = 0;
+            std::size_t _hand = 0;
+        };
+
+        /// std::hash is the identity for integers, mix it so both the shard and the slot bits are usable
+        static std::size_t Hash(TKey const& key)
+        {
+            uint64 hash = uint64(THash()(key));
+            hash ^= hash >> 33;
+            hash *= 0xFF51AFD7ED558CCDull;
+            hash ^= hash >> 33;
+            return std::size_t(hash);
+        }
+
+        Shard& GetShard(std::size_t hash) const
+        {
+            // Top bits pick the shard, the slot index uses the low ones
+            return _shards[(hash >> (std::numeric_limits<std::size_t>::digits - 16)) & _shardMask];
+        }
+
+        std::unique_ptr<Shard[]> _shards;
+        std::size_t _shardMask = 0;
+        uint64 _expire;
+    };
+}
+
+#endif // _WARHEAD_CONCURRENT_CACHE_H_
@@ -0,0 +1,602 @@
+/*
+ * This file is part of the WarheadApp Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef _WARHEAD_CONCURRENT_OBJECT_POOL_H_
+#define _WARHEAD_CONCURRENT_OBJECT_POOL_H_
+
+#include "Define.h"
+#include "Duration.h"
+#include "MPMCNotificationQueue.h"
+#include <Poco/Bugcheck.h>
+#include <Poco/ObjectPool.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Warhead
+{
+    struct ObjectPoolStats
+    {
+        uint64 Borrows = 0;
+        uint64 ThreadCacheHits = 0;   // Served from the borrowing thread's cache
+        uint64 StackHits = 0;         // Served from the shared stack
+        uint64 Steals = 0;            // Served from another thread's cache at peak capacity
+        uint64 Creations = 0;         // Growth, objects made by the factory
+        uint64 Destructions = 0;      // Invalid, over capacity or left when the pool was destroyed
+        uint64 Failures = 0;          // Null returned, peak capacity reached
+        std::size_t PeakSize = 0;     // Most objects alive at once
+
+        double GetHitRate() const { return Borrows ? double(ThreadCacheHits + StackHits + Steals) / double(Borrows) : 0.0; }
+    };
+
+    /// Lock-free replacement for Poco::ObjectPool.
+    ///
+    /// Every thread keeps up to threadCacheSize idle objects per pool, borrowing and returning
+    /// on the same thread only touches them. Behind them idle objects sit in a Treiber stack of
+    /// capacity nodes. The stack head packs the node index with a tag that changes on every
+    /// update, so a node popped and pushed again in between cannot fool the CAS (ABA).
+    /// A second stack holds the free nodes, a full pool has none left and destroys what comes back.
+    ///
+    /// The factory is used like Poco does: activateObject() on every borrow, validateObject() and
+    /// deactivateObject() on every return, destroyObject() for invalid objects and the overflow.
+    /// They are called without any lock held and must be safe to call from several threads.
+    ///
+    /// It keeps Poco's method names so users can switch by changing the member type.
+    /// Differences: capacity only limits the shared stack, each thread may hold threadCacheSize
+    /// more idle objects. A borrower at peak capacity takes them from the other threads' caches
+    /// under the shared lock, which is why each cache has a lock of its own. Only the owning
+    /// thread and such borrowers take it, it is uncontended otherwise.
+    template<class C, class P = C*, class F = Poco::PoolableObjectFactory<C, P>>
+    class ConcurrentObjectPool
+    {
+    public:
+        ConcurrentObjectPool(std::size_t capacity, std::size_t peakCapacity, uint32 threadCacheSize = 8) :
+            ConcurrentObjectPool(F(), capacity, peakCapacity, threadCacheSize) { }
+
+        ConcurrentObjectPool(F const& factory, std::size_t capacity, std::size_t peakCapacity, uint32 threadCacheSize = 8) :
+            _factory(factory),
+            _capacity(capacity),
+            _peakCapacity(peakCapacity),
+            _threadCacheSize(threadCacheSize),
+            _nodes(std::make_unique<Node[]>(capacity)),
+            _shared(std::make_shared<Shared>())
+        {
+            poco_assert(capacity <= peakCapacity && capacity < INVALID_NODE);
+
+            _shared->Pool = this;
+
+            for (std::size_t i = capacity; i > 0; --i)
+                _freeNodes.Push(_nodes.get(), uint32(i - 1));
+        }
+
+        /// Destroys the idle objects, borrowed ones are left to their owners like Poco does
+        ~ConcurrentObjectPool()
+        {
+            std::lock_guard<std::mutex> guard(_shared->Lock);
+
+            try
+            {
+                for (ThreadCache* cache : _shared->Caches)
+                {
+                    for (uint32 i = cache->Count.load(std::memory_order_relaxed); i > 0; --i)
+                        DestroyObject(std::move(cache->Objects[i - 1]), _shared->ExitedStats);
+
+                    cache->Count.store(0, std::memory_order_relaxed);
+                }
+
+                for (uint32 index; (index = _idleNodes.Pop(_nodes.get())) != INVALID_NODE;)
+                    DestroyObject(std::move(_nodes[index].Object), _shared->ExitedStats);
+            }
+            catch (...)
+            {
+                poco_unexpected();
+            }
+
+            _shared->Caches.clear();
+            _shared->Pool = nullptr;
+        }
+
+        ConcurrentObjectPool(ConcurrentObjectPool const&) = delete;
+        ConcurrentObjectPool& operator=(ConcurrentObjectPool const&) = delete;
+
+        /// Null if the peak capacity is reached and no object came back within the timeout.
+        /// If activating the object fails it is destroyed and the exception passed on.
+        P borrowObject(long timeoutMilliseconds = 0)
+        {
+            ThreadCache& cache = GetThreadCache();
+            Increment(cache.Stats.Borrows);
+
+            P object{};
+            bool cached = false;
+
+            {
+                CacheGuard guard(cache);
+
+                if (uint32 count = cache.Count.load(std::memory_order_relaxed))
+                {
+                    object = std::move(cache.Objects[--count]);
+                    cache.Count.store(count, std::memory_order_relaxed);
+                    cached = true;
+                }
+            }
+
+            if (cached)
+            {
+                Increment(cache.Stats.ThreadCacheHits);
+                return ActivateObject(std::move(object), cache);
+            }
+
+            if (TryAcquire(object, cache) || Steal(object, cache))
+                return ActivateObject(std::move(object), cache);
+
+            if (timeoutMilliseconds > 0)
+            {
+                using namespace std::chrono;
+
+                steady_clock::time_point deadline = steady_clock::now() + Milliseconds(timeoutMilliseconds);
+
+                for (;;)
+                {
+                    uint32 ticket = _returned.Prepare();
+
+                    // Registered as waiter first, returns from now on go to the stack
+                    if (TryAcquire(object, cache) || Steal(object, cache))
+                    {
+                        _returned.Cancel();
+                        return ActivateObject(std::move(object), cache);
+                    }
+
+                    long remaining = long(duration_cast<Milliseconds>(deadline - steady_clock::now()).count());
+                    if (remaining <= 0)
+                    {
+                        _returned.Cancel();
+                        break;
+                    }
+
+                    _returned.Wait(ticket, remaining);
+                }
+            }
+
+            Increment(cache.Stats.Failures);
+            return P{};
+        }
+
+        void returnObject(P object)
+        {
+            ThreadCache& cache = GetThreadCache();
+
+            if (!_factory.validateObject(object))
+            {
+                DestroyObject(std::move(object), cache.Stats);
+                _returned.Notify();
+                return;
+            }
+
+            _factory.deactivateObject(object);
+
+            {
+                CacheGuard guard(cache);
+
+                // Checked under the cache lock: a waiter registered before is seen here,
+                // a later one looks into this cache once we released it
+                if (!_returned.HasWaiters())
+                {
+                    uint32 count = cache.Count.load(std::memory_order_relaxed);
+
+                    if (count == _threadCacheSize)
+                    {
+                        // Half stays, so alternating borrows and returns don't flush every time
+                        for (uint32 i = count / 2; i < count; ++i)
+                            PushOrDestroy(std::move(cache.Objects[i]), cache.Stats);
+
+                        count /= 2;
+                    }
+
+                    if (count < _threadCacheSize)
+                    {
+                        cache.Objects[count] = std::move(object);
+                        cache.Count.store(count + 1, std::memory_order_relaxed);
+                        return;
+                    }
+                }
+            }
+
+            PushOrDestroy(std::move(object), cache.Stats);
+            _returned.Notify();
+        }
+
+        std::size_t capacity() const { return _capacity; }
+        std::size_t peakCapacity() const { return _peakCapacity; }
+
+        /// Objects alive, borrowed or idle
+        std::size_t size() const { return _size.load(std::memory_order_relaxed); }
+
+        /// Idle objects plus the ones that may still be created, a snapshot
+        std::size_t available() const
+        {
+            std::size_t cached = 0;
+
+            {
+                std::lock_guard<std::mutex> guard(_shared->Lock);
+
+                for (ThreadCache const* cache : _shared->Caches)
+                    cached += cache->Count.load(std::memory_order_relaxed);
+            }
+
+            std::size_t size = _size.load(std::memory_order_relaxed);
+            return _idleCount.load(std::memory_order_relaxed) + cached + (_peakCapacity > size ? _peakCapacity - size : 0);
+        }
+
+        /// Counters of all threads, exited ones included
+        ObjectPoolStats stats() const
+        {
+            std::lock_guard<std::mutex> guard(_shared->Lock);
+
+            ObjectPoolStats stats = _shared->ExitedStats.Get();
+
+            for (ThreadCache const* cache : _shared->Caches)
+                cache->Stats.AddTo(stats);
+
+            stats.PeakSize = _peakSize.load(std::memory_order_relaxed);
+            return stats;
+        }
+
+    private:
+        static constexpr uint32 INVALID_NODE = UINT32_MAX;
+
+        struct Node
+        {
+            P Object{};
+            std::atomic<uint32> Next{ INVALID_NODE };
+        };
+
+        /// Treiber stack of node indices, the upper half of the head is the ABA tag
+        class NodeStack
+        {
+        public:
+            void Push(Node* nodes, uint32 index)
+            {
+                uint64 head = _head.load(std::memory_order_relaxed);
+
+                do
+                {
+                    nodes[index].Next.store(uint32(head), std::memory_order_relaxed);
+                } while (!_head.compare_exchange_weak(head, MakeHead(head, index), std::memory_order_release, std::memory_order_relaxed));
+            }
+
+            uint32 Pop(Node* nodes)
+            {
+                uint64 head = _head.load(std::memory_order_acquire);
+
+                for (;;)
+                {
+                    uint32 index = uint32(head);
+                    if (index == INVALID_NODE)
+                        return INVALID_NODE;
+
+                    // May be stale if the node was taken meanwhile, the tag makes the CAS fail then
+                    uint32 next = nodes[index].Next.load(std::memory_order_relaxed);
+
+                    if (_head.compare_exchange_weak(head, MakeHead(head, next), std::memory_order_acquire, std::memory_order_acquire))
+                        return index;
+                }
+            }
+
+        private:
+            static uint64 MakeHead(uint64 previous, uint32 index)
+            {
+                return (((previous >> 32) + 1) << 32) | index;
+            }
+
+            std::atomic<uint64> _head{ INVALID_NODE };
+        };
+
+        /// Owned by one thread, atomic so stats() may read them meanwhile
+        struct Counters
+        {
+            std::atomic<uint64> Borrows{ 0 };
+            std::atomic<uint64> ThreadCacheHits{ 0 };
+            std::atomic<uint64> StackHits{ 0 };
+            std::atomic<uint64> Steals{ 0 };
+            std::atomic<uint64> Creations{ 0 };
+            std::atomic<uint64> Destructions{ 0 };
+            std::atomic<uint64> Failures{ 0 };
+
+            void AddTo(ObjectPoolStats& stats) const
+            {
+                stats.Borrows += Borrows.load(std::memory_order_relaxed);
+                stats.ThreadCacheHits += ThreadCacheHits.load(std::memory_order_relaxed);
+                stats.StackHits += StackHits.load(std::memory_order_relaxed);
+                stats.Steals += Steals.load(std::memory_order_relaxed);
+                stats.Creations += Creations.load(std::memory_order_relaxed);
+                stats.Destructions += Destructions.load(std::memory_order_relaxed);
+                stats.Failures += Failures.load(std::memory_order_relaxed);
+            }
+
+            ObjectPoolStats Get() const
+            {
+                ObjectPoolStats stats;
+                AddTo(stats);
+                return stats;
+            }
+        };
+
+        struct ThreadCache;
+
+        /// Outlives the pool while threads still have caches of it
+        struct Shared
+        {
+            std::mutex Lock;
+            ConcurrentObjectPool* Pool = nullptr; // Null once destroyed
+            std::vector<ThreadCache*> Caches;
+
+            // Exited threads and the pool destruction, only changed under the lock
+            Counters ExitedStats;
+        };
+
+        struct ThreadCache
+        {
+            std::shared_ptr<Shared> Owner;
+            std::unique_ptr<P[]> Objects;
+            std::atomic<uint32> Count{ 0 };
+            std::atomic<bool> Busy{ false };
+            Counters Stats;
+        };
+
+        /// Lock of one cache, see Steal()
+        class CacheGuard
+        {
+        public:
+            explicit CacheGuard(ThreadCache& cache) : _cache(cache)
+            {
+                while (_cache.Busy.exchange(true, std::memory_order_acquire))
+                    std::this_thread::yield();
+            }
+
+            ~CacheGuard() { _cache.Busy.store(false, std::memory_order_release); }
+
+            CacheGuard(CacheGuard const&) = delete;
+            CacheGuard& operator=(CacheGuard const&) = delete;
+
+        private:
+            ThreadCache& _cache;
+        };
+
+        /// Caches of one thread, one per pool it used
+        struct ThreadState
+        {
+            ~ThreadState()
+            {
+                for (auto& cache : Caches)
+                {
+                    Shared& owner = *cache->Owner;
+                    std::lock_guard<std::mutex> guard(owner.Lock);
+
+                    if (!owner.Pool)
+                        continue;
+
+                    for (uint32 i = cache->Count.load(std::memory_order_relaxed); i > 0; --i)
+                        owner.Pool->PushOrDestroy(std::move(cache->Objects[i - 1]), cache->Stats);
+
+                    cache->Count.store(0, std::memory_order_relaxed);
+                    owner.Pool->_returned.Notify(true);
+
+                    ObjectPoolStats stats = cache->Stats.Get();
+                    Add(owner.ExitedStats.Borrows, stats.Borrows);
+                    Add(owner.ExitedStats.ThreadCacheHits, stats.ThreadCacheHits);
+                    Add(owner.ExitedStats.StackHits, stats.StackHits);
+                    Add(owner.ExitedStats.Steals, stats.Steals);
+                    Add(owner.ExitedStats.Creations, stats.Creations);
+                    Add(owner.ExitedStats.Destructions, stats.Destructions);
+                    Add(owner.ExitedStats.Failures, stats.Failures);
+
+                    owner.Caches.erase(std::find(owner.Caches.begin(), owner.Caches.end(), cache.get()));
+                }
+            }
+
+            std::vector<std::unique_ptr<ThreadCache>> Caches;
+            ThreadCache* Last = nullptr; // Most threads only use one pool at a time
+        };
+
+        static void Add(std::atomic<uint64>& counter, uint64 value)
+        {
+            counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+        }
+
+        static void Increment(std::atomic<uint64>& counter) { Add(counter, 1); }
+
+        ThreadCache& GetThreadCache()
+        {
+            thread_local ThreadState state;
+
+            // A cache keeps its Shared alive, no other pool can have the same one meanwhile
+            if (state.Last && state.Last->Owner == _shared)
+                return *state.Last;
+
+            auto itr = std::find_if(state.Caches.begin(), state.Caches.end(), [this](auto const& cache) { return cache->Owner == _shared; });
+
+            if (itr == state.Caches.end())
+            {
+                // Drop the caches of destroyed pools
+                state.Caches.erase(std::remove_if(state.Caches.begin(), state.Caches.end(), [](auto const& cache)
+                {
+                    std::lock_guard<std::mutex> guard(cache->Owner->Lock);
+                    return !cache->Owner->Pool;
+                }), state.Caches.end());
+
+                auto cache = std::make_unique<ThreadCache>();
+                cache->Owner = _shared;
+                cache->Objects = std::make_unique<P[]>(std::max<uint32>(_threadCacheSize, 1));
+
+                {
+                    std::lock_guard<std::mutex> guard(_shared->Lock);
+                    _shared->Caches.push_back(cache.get());
+                }
+
+                state.Caches.emplace_back(std::move(cache));
+                itr = state.Caches.end() - 1;
+            }
+
+            state.Last = itr->get();
+            return *state.Last;
+        }
+
+        /// Takes an idle object from the stack or creates one below the peak capacity
+        bool TryAcquire(P& object, ThreadCache& cache)
+        {
+            uint32 index = _idleNodes.Pop(_nodes.get());
+
+            if (index != INVALID_NODE)
+            {
+                object = std::move(_nodes[index].Object);
+                _nodes[index].Object = P{};
+                _idleCount.fetch_sub(1, std::memory_order_relaxed);
+                _freeNodes.Push(_nodes.get(), index);
+
+                Increment(cache.Stats.StackHits);
+                return true;
+            }
+
+            std::size_t size = _size.load(std::memory_order_relaxed);
+
+            do
+            {
+                if (size >= _peakCapacity)
+                    return false;
+            } while (!_size.compare_exchange_weak(size, size + 1, std::memory_order_relaxed));
+
+            try
+            {
+                object = _factory.createObject();
+            }
+            catch (...)
+            {
+                _size.fetch_sub(1, std::memory_order_relaxed);
+                throw;
+            }
+
+            std::size_t peak = _peakSize.load(std::memory_order_relaxed);
+            while (peak <= size && !_peakSize.compare_exchange_weak(peak, size + 1, std::memory_order_relaxed)) { }
+
+            Increment(cache.Stats.Creations);
+            return true;
+        }
+
+        /// At peak capacity the idle objects may all sit in other threads' caches. Takes one
+        /// and moves the rest of that cache to the stack for the other borrowers.
+        bool Steal(P& object, ThreadCache& self)
+        {
+            std::lock_guard<std::mutex> guard(_shared->Lock);
+
+            for (ThreadCache* cache : _shared->Caches)
+            {
+                if (cache == &self)
+                    continue;
+
+                uint32 count;
+
+                {
+                    // Not peeking at Count without the lock, an object cached just before it could be missed
+                    CacheGuard cacheGuard(*cache);
+
+                    count = cache->Count.load(std::memory_order_relaxed);
+                    if (!count)
+                        continue;
+
+                    object = std::move(cache->Objects[--count]);
+
+                    for (uint32 i = count; i > 0; --i)
+                        PushOrDestroy(std::move(cache->Objects[i - 1]), self.Stats);
+
+                    cache->Count.store(0, std::memory_order_relaxed);
+                }
+
+                if (count)
+                    _returned.Notify(true);
+
+                Increment(self.Stats.Steals);
+                return true;
+            }
+
+            return false;
+        }
+
+        P ActivateObject(P&& object, ThreadCache& cache)
+        {
+            try
+            {
+                _factory.activateObject(object);
+            }
+            catch (...)
+            {
+                DestroyObject(std::move(object), cache.Stats);
+                _returned.Notify();
+                throw;
+            }
+
+            return std::move(object);
+        }
+
+        void PushOrDestroy(P&& object, Counters& stats)
+        {
+            uint32 index = _freeNodes.Pop(_nodes.get());
+
+            // No free node, the stack holds capacity objects already
+            if (index == INVALID_NODE)
+            {
+                DestroyObject(std::move(object), stats);
+                return;
+            }
+
+            _nodes[index].Object = std::move(object);
+            _idleCount.fetch_add(1, std::memory_order_relaxed);
+            _idleNodes.Push(_nodes.get(), index);
+        }
+
+        void DestroyObject(P&& object, Counters& stats)
+        {
+            _factory.destroyObject(object);
+            _size.fetch_sub(1, std::memory_order_relaxed);
+            Increment(stats.Destructions);
+        }
+
+        F _factory;
+        std::size_t _capacity;
+        std::size_t _peakCapacity;
+        uint32 _threadCacheSize;
+
+        std::unique_ptr<Node[]> _nodes;
+        NodeStack _idleNodes;
+        NodeStack _freeNodes;
+        std::atomic<std::size_t> _idleCount{ 0 };
+
+        std::atomic<std::size_t> _size{ 0 };
+        std::atomic<std::size_t> _peakSize{ 0 };
+
+        // Notified when an object goes back to the stack or is destroyed
+        Threading::WaitPoint _returned;
+
+        std::shared_ptr<Shared> _shared;
+    };
+}
+
+#endif // _WARHEAD_CONCURRENT_OBJECT_POOL_H_
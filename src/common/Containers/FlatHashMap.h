@@ -0,0 +1,726 @@
+/*
+ * This file is part of the WarheadApp Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef _WARHEAD_FLAT_HASH_MAP_H_
+#define _WARHEAD_FLAT_HASH_MAP_H_
+
+#include "Define.h"
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  define WH_FLAT_HASH_SSE2
+#  include <emmintrin.h>
+#endif
+
+#ifdef _MSC_VER
+#  include <intrin.h>
+#endif
+
+namespace Warhead
+{
+    /// Default hash of the flat containers, the std::string one accepts std::string_view and char const* without a temporary string
+    template<class T>
+    struct FlatHash : std::hash<T> { };
+
+    template<>
+    struct FlatHash<std::string>
+    {
+        using is_transparent = void;
+
+        std::size_t operator()(std::string_view value) const { return std::hash<std::string_view>()(value); }
+    };
+
+    template<class T>
+    struct FlatEqual : std::equal_to<T> { };
+
+    template<>
+    struct FlatEqual<std::string>
+    {
+        using is_transparent = void;
+
+        bool operator()(std::string_view left, std::string_view right) const { return left == right; }
+    };
+}
+
+namespace Warhead::Impl::FlatHashImpl
+{
+    /// One control byte per slot: EMPTY, DELETED, SENTINEL (end of the slots) or the 7 low hash bits of a full slot
+    using Control = int8;
+
+    constexpr Control EMPTY = -128;
+    constexpr Control DELETED = -2;
+    constexpr Control SENTINEL = -1;
+
+    inline uint32 CountTrailingZeros(uint64 value)
+    {
+#ifdef _MSC_VER
+        unsigned long index;
+#  ifdef _M_X64
+        _BitScanForward64(&index, value);
+#  else
+        if (_BitScanForward(&index, uint32(value)))
+            return index;
+
+        _BitScanForward(&index, uint32(value >> 32));
+        index += 32;
+#  endif
+        return index;
+#else
+        return uint32(__builtin_ctzll(value));
+#endif
+    }
+
+    /// Set bits of a group match, one per matching slot
+    template<uint32 Shift>
+    class BitMask
+    {
+    public:
+        explicit BitMask(uint64 mask) : _mask(mask) { }
+
+        explicit operator bool() const { return _mask != 0; }
+        uint32 Lowest() const { return CountTrailingZeros(_mask) >> Shift; }
+        void ClearLowest() { _mask &= _mask - 1; }
+
+    private:
+        uint64 _mask;
+    };
+
+#ifdef WH_FLAT_HASH_SSE2
+    /// 16 control bytes compared at once, one bit per slot
+    class Group
+    {
+    public:
+        static constexpr std::size_t WIDTH = 16;
+
+        explicit Group(Control const* controls) : _controls(_mm_loadu_si128(reinterpret_cast<__m128i const*>(controls))) { }
+
+        BitMask<0> Match(Control hash) const
+        {
+            return BitMask<0>(uint32(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(hash), _controls))));
+        }
+
+        BitMask<0> MatchEmpty() const
+        {
+            return Match(EMPTY);
+        }
+
+        BitMask<0> MatchEmptyOrDeleted() const
+        {
+            return BitMask<0>(uint32(_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(SENTINEL), _controls))));
+        }
+
+    private:
+        __m128i _controls;
+    };
+#else
+    /// 8 control bytes in a word, bit tricks instead of SIMD, one bit (the byte's top one) per slot
+    class Group
+    {
+    public:
+        static constexpr std::size_t WIDTH = 8;
+
+        explicit Group(Control const* controls) { std::memcpy(&_controls, controls, sizeof(_controls)); }
+
+        /// May report false positives next to a real match, the key comparison sorts them out
+        BitMask<3> Match(Control hash) const
+        {
+            uint64 value = _controls ^ (LSBS * uint8(hash));
+            return BitMask<3>((value - LSBS) & ~value & MSBS);
+        }
+
+        BitMask<3> MatchEmpty() const
+        {
+            return BitMask<3>(_controls & ~(_controls << 6) & MSBS);
+        }
+
+        BitMask<3> MatchEmptyOrDeleted() const
+        {
+            return BitMask<3>(_controls & ~(_controls << 7) & MSBS);
+        }
+
+    private:
+        static constexpr uint64 LSBS = 0x0101010101010101ull;
+        static constexpr uint64 MSBS = 0x8080808080808080ull;
+
+        uint64 _controls;
+    };
+#endif
+
+    /// Control bytes of tables without storage, every lookup stops at the first group
+    inline Control const* GetEmptyGroup()
+    {
+        alignas(16) static Control const controls[Group::WIDTH] = { SENTINEL, EMPTY, EMPTY, EMPTY, EMPTY, EMPTY, EMPTY, EMPTY,
+#ifdef WH_FLAT_HASH_SSE2
+            EMPTY, EMPTY, EMPTY, EMPTY, EMPTY, EMPTY, EMPTY, EMPTY
+#endif
+        };
+
+        return controls;
+    }
+
+    template<class TKey>
+    struct SetPolicy
+    {
+        using Slot = TKey;
+
+        static TKey const& GetKey(Slot const& slot) { return slot; }
+    };
+
+    template<class TKey, class TValue>
+    struct MapPolicy
+    {
+        using Slot = std::pair<TKey, TValue>;
+
+        static TKey const& GetKey(Slot const& slot) { return slot.first; }
+    };
+
+    template<class T, class = void>
+    struct IsTransparent : std::false_type { };
+
+    template<class T>
+    struct IsTransparent<T, std::void_t<typename T::is_transparent>> : std::true_type { };
+
+    template<bool Transparent>
+    struct KeyArg
+    {
+        template<class K, class TKey>
+        using Type = TKey;
+    };
+
+    template<>
+    struct KeyArg<true>
+    {
+        template<class K, class TKey>
+        using Type = K;
+    };
+
+    /// Swiss table: open addressing over groups of slots with a control byte array next to them.
+    /// A lookup compares the 7 bit hash of one group of control bytes at once and only touches
+    /// the slots that matched, so a miss costs about one cache line.
+    template<class TKey, class TPolicy, class THash, class TKeyEqual>
+    class FlatHashTable
+    {
+        static_assert(alignof(typename TPolicy::Slot) <= alignof(std::max_align_t), "Over-aligned elements are not supported");
+
+    public:
+        using key_type = TKey;
+        using value_type = typename TPolicy::Slot;
+        using size_type = std::size_t;
+        using hasher = THash;
+        using key_equal = TKeyEqual;
+
+    protected:
+        template<class K>
+        using KeyArgType = typename KeyArg<IsTransparent<THash>::value && IsTransparent<TKeyEqual>::value>::template Type<K, TKey>;
+
+    public:
+        template<class TValueRef, class TControl>
+        class Iterator
+        {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = typename TPolicy::Slot;
+            using difference_type = std::ptrdiff_t;
+            using reference = TValueRef&;
+            using pointer = TValueRef*;
+
+            Iterator() = default;
+            Iterator(TControl* control, TValueRef* slot) : _control(control), _slot(slot) { SkipEmpty(); }
+
+            /// const_iterator from iterator
+            template<class TOtherRef, class TOtherControl, class = std::enable_if_t<std::is_convertible_v<TOtherRef*, TValueRef*>>>
+            Iterator(Iterator<TOtherRef, TOtherControl> const& other) : _control(other._control), _slot(other._slot) { }
+
+            reference operator*() const { return *_slot; }
+            pointer operator->() const { return _slot; }
+
+            Iterator& operator++()
+            {
+                ++_control;
+                ++_slot;
+                SkipEmpty();
+                return *this;
+            }
+
+            Iterator operator++(int)
+            {
+                Iterator itr = *this;
+                ++*this;
+                return itr;
+            }
+
+            bool operator==(Iterator const& other) const { return _control == other._control; }
+            bool operator!=(Iterator const& other) const { return _control != other._control; }
+
+        private:
+            friend class FlatHashTable;
+
+            template<class, class>
+            friend class Iterator;
+
+            void SkipEmpty()
+            {
+                // Stops at full slots and at the sentinel
+                while (*_control < SENTINEL)
+                {
+                    ++_control;
+                    ++_slot;
+                }
+            }
+
+            TControl* _control = nullptr;
+            TValueRef* _slot = nullptr;
+        };
+
+        using iterator = Iterator<value_type, Control>;
+        using const_iterator = Iterator<value_type const, Control const>;
+
+        FlatHashTable() = default;
+
+        FlatHashTable(FlatHashTable const& other)
+        {
+            reserve(other._size);
+
+            for (value_type const& value : other)
+            {
+                std::size_t hash = Hash(TPolicy::GetKey(value));
+                std::size_t index = FindFirstNonFull(hash);
+                new (_slots + index) value_type(value);
+                SetControl(index, H2(hash));
+                --_growthLeft;
+                ++_size;
+            }
+        }
+
+        FlatHashTable(FlatHashTable&& other) noexcept :
+            _controls(std::exchange(other._controls, const_cast<Control*>(GetEmptyGroup()))),
+            _slots(std::exchange(other._slots, nullptr)),
+            _capacity(std::exchange(other._capacity, 0)),
+            _size(std::exchange(other._size, 0)),
+            _growthLeft(std::exchange(other._growthLeft, 0)) { }
+
+        FlatHashTable& operator=(FlatHashTable other) noexcept
+        {
+            std::swap(_controls, other._controls);
+            std::swap(_slots, other._slots);
+            std::swap(_capacity, other._capacity);
+            std::swap(_size, other._size);
+            std::swap(_growthLeft, other._growthLeft);
+            return *this;
+        }
+
+        ~FlatHashTable()
+        {
+            Destroy();
+        }
+
+        iterator begin() { return _size ? iterator(_controls, _slots) : end(); }
+        iterator end() { return iterator(_controls + _capacity, _slots + _capacity); }
+        const_iterator begin() const { return _size ? const_iterator(_controls, _slots) : end(); }
+        const_iterator end() const { return const_iterator(_controls + _capacity, _slots + _capacity); }
+        const_iterator cbegin() const { return begin(); }
+        const_iterator cend() const { return end(); }
+
+        bool empty() const { return !_size; }
+        std::size_t size() const { return _size; }
+        std::size_t capacity() const { return _capacity; }
+
+        /// Room for count elements without a rehash
+        void reserve(std::size_t count)
+        {
+            if (count <= _size + _growthLeft)
+                return;
+
+            Rehash(NormalizeCapacity(count + (count - 1) / 7));
+        }
+
+        void clear()
+        {
+            if (!_capacity)
+                return;
+
+            DestroySlots();
+            _size = 0;
+            ResetControls();
+        }
+
+        template<class K = TKey>
+        iterator find(KeyArgType<K> const& key)
+        {
+            std::size_t index = Find(key, Hash(key));
+            return index == NOT_FOUND ? end() : IteratorAt(index);
+        }
+
+        template<class K = TKey>
+        const_iterator find(KeyArgType<K> const& key) const
+        {
+            std::size_t index = Find(key, Hash(key));
+            return index == NOT_FOUND ? end() : const_iterator(_controls + index, _slots + index);
+        }
+
+        template<class K = TKey>
+        bool contains(KeyArgType<K> const& key) const
+        {
+            return Find(key, Hash(key)) != NOT_FOUND;
+        }
+
+        template<class K = TKey>
+        std::size_t count(KeyArgType<K> const& key) const
+        {
+            return contains(key) ? 1 : 0;
+        }
+
+        template<class K = TKey>
+        std::size_t erase(KeyArgType<K> const& key)
+        {
+            std::size_t index = Find(key, Hash(key));
+            if (index == NOT_FOUND)
+                return 0;
+
+            EraseAt(index);
+            return 1;
+        }
+
+        iterator erase(iterator itr)
+        {
+            return erase(const_iterator(itr));
+        }
+
+        iterator erase(const_iterator itr)
+        {
+            std::size_t index = std::size_t(itr._control - _controls);
+            EraseAt(index);
+            return IteratorAt(index);
+        }
+
+    protected:
+        static constexpr std::size_t NOT_FOUND = std::size_t(-1);
+
+        /// std::hash is the identity for integers, the mix spreads it over both parts
+        template<class K>
+        static std::size_t Hash(K const& key)
+        {
+            uint64 hash = uint64(THash()(key)) * 0x9E3779B97F4A7C15ull;
+            return std::size_t(hash ^ (hash >> 32));
+        }
+
+        static std::size_t H1(std::size_t hash) { return hash >> 7; }
+        static Control H2(std::size_t hash) { return Control(hash & 0x7F); }
+
+        iterator IteratorAt(std::size_t index) { return iterator(_controls + index, _slots + index); }
+
+        template<class K>
+        std::size_t Find(K const& key, std::size_t hash) const
+        {
+            std::size_t offset = H1(hash) & _capacity;
+
+            for (std::size_t step = 0;; )
+            {
+                Group group(_controls + offset);
+
+                for (auto match = group.Match(H2(hash)); match; match.ClearLowest())
+                {
+                    std::size_t index = (offset + match.Lowest()) & _capacity;
+
+                    if (TKeyEqual()(TPolicy::GetKey(_slots[index]), key))
+                        return index;
+                }
+
+                // An empty slot ends the probe sequence, the key would have been placed there
+                if (group.MatchEmpty())
+                    return NOT_FOUND;
+
+                step += Group::WIDTH;
+                offset = (offset + step) & _capacity;
+            }
+        }
+
+        /// Index to construct the new element at, followed by CommitInsert()
+        std::size_t PrepareInsert(std::size_t hash)
+        {
+            std::size_t index = FindFirstNonFull(hash);
+
+            if (!_growthLeft && _controls[index] != DELETED)
+            {
+                // Mostly tombstones: clean up in place, otherwise grow
+                Rehash(!_capacity || _size > CapacityToGrowth(_capacity) / 2 ? NormalizeCapacity(_capacity * 2 + 1) : _capacity);
+                index = FindFirstNonFull(hash);
+            }
+
+            return index;
+        }
+
+        void CommitInsert(std::size_t index, std::size_t hash)
+        {
+            if (_controls[index] == EMPTY)
+                --_growthLeft;
+
+            SetControl(index, H2(hash));
+            ++_size;
+        }
+
+        /// Finds key or constructs a new element from args, returns false if the key existed
+        template<class K, class... Args>
+        std::pair<iterator, bool> EmplaceUnique(K const& key, Args&&... args)
+        {
+            std::size_t hash = Hash(key);
+            std::size_t index = Find(key, hash);
+
+            if (index != NOT_FOUND)
+                return { IteratorAt(index), false };
+
+            index = PrepareInsert(hash);
+            new (_slots + index) value_type(std::forward<Args>(args)...);
+            CommitInsert(index, hash);
+            return { IteratorAt(index), true };
+        }
+
+        Control* _controls = const_cast<Control*>(GetEmptyGroup());
+        value_type* _slots = nullptr;
+        std::size_t _capacity = 0;      // 2^n - 1, also the probe mask
+        std::size_t _size = 0;
+        std::size_t _growthLeft = 0;    // Empty slots that may still be filled before a rehash
+
+    private:
+        static std::size_t NormalizeCapacity(std::size_t count)
+        {
+            std::size_t capacity = Group::WIDTH - 1;
+            while (capacity < count)
+                capacity = capacity * 2 + 1;
+
+            return capacity;
+        }
+
+        /// Maximum load of 7/8, at least one slot stays empty so every probe sequence ends
+        static std::size_t CapacityToGrowth(std::size_t capacity)
+        {
+            return capacity < 8 ? capacity - 1 : capacity - capacity / 8;
+        }
+
+        std::size_t FindFirstNonFull(std::size_t hash) const
+        {
+            std::size_t offset = H1(hash) & _capacity;
+
+            for (std::size_t step = 0;; )
+            {
+                if (auto match = Group(_controls + offset).MatchEmptyOrDeleted())
+                    return (offset + match.Lowest()) & _capacity;
+
+                step += Group::WIDTH;
+                offset = (offset + step) & _capacity;
+            }
+        }
+
+        /// The first WIDTH - 1 control bytes are mirrored behind the sentinel, so a group loaded near the end wraps around
+        void SetControl(std::size_t index, Control control)
+        {
+            _controls[index] = control;
+            _controls[((index - (Group::WIDTH - 1)) & _capacity) + (Group::WIDTH - 1)] = control;
+        }
+
+        void ResetControls()
+        {
+            std::memset(_controls, EMPTY, _capacity + Group::WIDTH);
+            _controls[_capacity] = SENTINEL;
+            _growthLeft = CapacityToGrowth(_capacity) - _size;
+        }
+
+        void EraseAt(std::size_t index)
+        {
+            _slots[index].~value_type();
+            SetControl(index, DELETED);
+            --_size;
+        }
+
+        void Rehash(std::size_t capacity)
+        {
+            Control* oldControls = _controls;
+            value_type* oldSlots = _slots;
+            std::size_t oldCapacity = _capacity;
+
+            // Control bytes and slots share one allocation
+            std::size_t slotsOffset = (capacity + Group::WIDTH + alignof(value_type) - 1) & ~(alignof(value_type) - 1);
+            _controls = static_cast<Control*>(::operator new(slotsOffset + capacity * sizeof(value_type)));
+            _slots = reinterpret_cast<value_type*>(reinterpret_cast<char*>(_controls) + slotsOffset);
+            _capacity = capacity;
+
+            std::size_t size = _size;
+            _size = 0;
+            ResetControls();
+
+            for (std::size_t i = 0; i < oldCapacity; ++i)
+            {
+                if (oldControls[i] < 0)
+                    continue;
+
+                std::size_t hash = Hash(TPolicy::GetKey(oldSlots[i]));
+                std::size_t index = FindFirstNonFull(hash);
+                new (_slots + index) value_type(std::move(oldSlots[i]));
+                oldSlots[i].~value_type();
+                SetControl(index, H2(hash));
+            }
+
+            _size = size;
+            _growthLeft = CapacityToGrowth(_capacity) - _size;
+
+            if (oldCapacity)
+                ::operator delete(oldControls);
+        }
+
+        void DestroySlots()
+        {
+            if constexpr (!std::is_trivially_destructible_v<value_type>)
+            {
+                for (std::size_t i = 0; i < _capacity; ++i)
+                    if (_controls[i] >= 0)
+                        _slots[i].~value_type();
+            }
+        }
+
+        void Destroy()
+        {
+            if (!_capacity)
+                return;
+
+            DestroySlots();
+            ::operator delete(_controls);
+        }
+    };
+}
+
+namespace Warhead
+{
+    /// Swiss table hash map (SSE2 group probing, portable fallback), a drop-in for the common
+    /// std::unordered_map operations. Elements live in one flat array, so references and
+    /// iterators are invalidated by every insert that rehashes. Keys must not be changed through iterators.
+    /// With std::string keys find(), contains() and erase() take std::string_view without allocating.
+    template<class TKey, class TValue, class THash = FlatHash<TKey>, class TKeyEqual = FlatEqual<TKey>>
+    class FlatHashMap : public Impl::FlatHashImpl::FlatHashTable<TKey, Impl::FlatHashImpl::MapPolicy<TKey, TValue>, THash, TKeyEqual>
+    {
+        using Base = Impl::FlatHashImpl::FlatHashTable<TKey, Impl::FlatHashImpl::MapPolicy<TKey, TValue>, THash, TKeyEqual>;
+
+    public:
+        using mapped_type = TValue;
+        using typename Base::iterator;
+
+        FlatHashMap() = default;
+
+        FlatHashMap(std::initializer_list<std::pair<TKey, TValue>> values)
+        {
+            this->reserve(values.size());
+
+            for (auto const& [key, value] : values)
+                try_emplace(key, value);
+        }
+
+        /// Does nothing if the key exists, like std::unordered_map::try_emplace
+        template<class K, class... Args>
+        std::pair<iterator, bool> try_emplace(K&& key, Args&&... args)
+        {
+            return this->EmplaceUnique(key, std::piecewise_construct, std::forward_as_tuple(std::forward<K>(key)), std::forward_as_tuple(std::forward<Args>(args)...));
+        }
+
+        std::pair<iterator, bool> insert(std::pair<TKey, TValue> const& value)
+        {
+            return try_emplace(value.first, value.second);
+        }
+
+        std::pair<iterator, bool> insert(std::pair<TKey, TValue>&& value)
+        {
+            return try_emplace(std::move(value.first), std::move(value.second));
+        }
+
+        template<class K, class... Args>
+        std::pair<iterator, bool> emplace(K&& key, Args&&... args)
+        {
+            return try_emplace(std::forward<K>(key), std::forward<Args>(args)...);
+        }
+
+        template<class K, class V>
+        std::pair<iterator, bool> insert_or_assign(K&& key, V&& value)
+        {
+            auto result = try_emplace(std::forward<K>(key), std::forward<V>(value));
+            if (!result.second)
+                result.first->second = std::forward<V>(value);
+
+            return result;
+        }
+
+        template<class K>
+        TValue& operator[](K&& key)
+        {
+            return try_emplace(std::forward<K>(key)).first->second;
+        }
+
+        template<class K = TKey>
+        TValue& at(typename Base::template KeyArgType<K> const& key)
+        {
+            auto itr = this->find(key);
+            if (itr == this->end())
+                throw std::out_of_range("Warhead::FlatHashMap::at");
+
+            return itr->second;
+        }
+
+        template<class K = TKey>
+        TValue const& at(typename Base::template KeyArgType<K> const& key) const
+        {
+            auto itr = this->find(key);
+            if (itr == this->end())
+                throw std::out_of_range("Warhead::FlatHashMap::at");
+
+            return itr->second;
+        }
+    };
+
+    /// Set counterpart of FlatHashMap
+    template<class TKey, class THash = FlatHash<TKey>, class TKeyEqual = FlatEqual<TKey>>
+    class FlatHashSet : public Impl::FlatHashImpl::FlatHashTable<TKey, Impl::FlatHashImpl::SetPolicy<TKey>, THash, TKeyEqual>
+    {
+        using Base = Impl::FlatHashImpl::FlatHashTable<TKey, Impl::FlatHashImpl::SetPolicy<TKey>, THash, TKeyEqual>;
+
+    public:
+        using typename Base::iterator;
+
+        FlatHashSet() = default;
+
+        FlatHashSet(std::initializer_list<TKey> values)
+        {
+            this->reserve(values.size());
+
+            for (TKey const& value : values)
+                insert(value);
+        }
+
+        std::pair<iterator, bool> insert(TKey const& key) { return this->EmplaceUnique(key, key); }
+        std::pair<iterator, bool> insert(TKey&& key) { return this->EmplaceUnique(key, std::move(key)); }
+
+        template<class K>
+        std::pair<iterator, bool> emplace(K&& key) { return insert(TKey(std::forward<K>(key))); }
+    };
+}
+
+#endif // _WARHEAD_FLAT_HASH_MAP_H_
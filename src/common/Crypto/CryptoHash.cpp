@@ -15,25 +15,168 @@
  * with this program. If not, see <http://www.gnu.org/licenses/>.
  */
 
+
 #include "CryptoHash.h"
-#include <Poco/DigestStream.h>
+#include "Copy.h"
+#include "Encoding.h"
+#include "Log.h"
+#include "SHA256.h"
+#include "XXHash.h"
+#include <Poco/DigestEngine.h>
 #include <Poco/MD5Engine.h>
-#include <fstream>
+#include <Poco/SHA1Engine.h>
+#include <memory>
 
-std::string Warhead::Crypto::GetMD5HashFromFile(std::string const& filePath)
+struct Warhead::Crypto::Hasher::Impl
+{
+    virtual ~Impl() = default;
+
+    virtual void Update(void const* data, std::size_t size) = 0;
+    virtual std::vector<uint8> Digest() = 0;
+};
+
+namespace
 {
-    using Poco::DigestOutputStream;
-    using Poco::DigestEngine;
-    using Poco::MD5Engine;
+    using namespace Warhead::Crypto;
+
+    template<class Engine>
+    class PocoHasher : public Hasher::Impl
+    {
+    public:
+        void Update(void const* data, std::size_t size) override
+        {
+            _engine.update(data, size);
+        }
+
+        std::vector<uint8> Digest() override
+        {
+            auto const& digest = _engine.digest();
+            return { digest.begin(), digest.end() };
+        }
+
+    private:
+        Engine _engine;
+    };
+
+    class SHA256Hasher : public Hasher::Impl
+    {
+    public:
+        void Update(void const* data, std::size_t size) override
+        {
+            _sha.Update(data, size);
+        }
+
+        std::vector<uint8> Digest() override
+        {
+            auto digest = _sha.Finalize();
+            return { digest.begin(), digest.end() };
+        }
 
-    std::ifstream in(filePath, std::ios_base::binary);
+    private:
+        SHA256 _sha;
+    };
 
-    MD5Engine md5;
-    DigestOutputStream ostr(md5);
-    ostr << in.rdbuf();
-    ostr.flush(); // Ensure everything gets passed to the digest engine
+    template<class Engine>
+    class XXHasher : public Hasher::Impl
+    {
+    public:
+        void Update(void const* data, std::size_t size) override
+        {
+            _xxh.Update(data, size);
+        }
 
-    const DigestEngine::Digest& digest = md5.digest(); // obtain result
+        std::vector<uint8> Digest() override
+        {
+            uint64 hash = _xxh.Digest();
+            _xxh.Reset();
 
-    return DigestEngine::digestToHex(digest);
+            std::vector<uint8> digest(8);
+            for (std::size_t i = 0; i < 8; ++i)
+                digest[i] = uint8(hash >> (56 - i * 8));
+
+            return digest;
+        }
+
+    private:
+        Engine _xxh;
+    };
+
+    std::unique_ptr<Hasher::Impl> MakeHasher(HashAlgorithm algorithm)
+    {
+        switch (algorithm)
+        {
+            case HashAlgorithm::MD5:
+                return std::make_unique<PocoHasher<Poco::MD5Engine>>();
+            case HashAlgorithm::SHA1:
+                return std::make_unique<PocoHasher<Poco::SHA1Engine>>();
+            case HashAlgorithm::SHA256:
+                return std::make_unique<SHA256Hasher>();
+            case HashAlgorithm::XXH64:
+                return std::make_unique<XXHasher<XXH64>>();
+            case HashAlgorithm::XXH3:
+                return std::make_unique<XXHasher<XXH3>>();
+        }
+
+        return nullptr;
+    }
+}
+
+Warhead::Crypto::Hasher::Hasher(HashAlgorithm algorithm) :
+    _algorithm(algorithm), _impl(MakeHasher(algorithm)) { }
+
+Warhead::Crypto::Hasher::~Hasher() = default;
+Warhead::Crypto::Hasher::Hasher(Hasher&&) noexcept = default;
+Warhead::Crypto::Hasher& Warhead::Crypto::Hasher::operator=(Hasher&&) noexcept = default;
+
+void Warhead::Crypto::Hasher::Update(void const* data, std::size_t size)
+{
+    _impl->Update(data, size);
+}
+
+std::vector<uint8> Warhead::Crypto::Hasher::Digest()
+{
+    return _impl->Digest();
+}
+
+std::string Warhead::Crypto::Hasher::HexDigest()
+{
+    auto digest = Digest();
+    return DigestToHex(digest.data(), digest.size());
+}
+
+std::string Warhead::Crypto::DigestToHex(uint8 const* digest, std::size_t size)
+{
+    return Warhead::Encoding::HexEncode(digest, size);
+}
+
+std::string Warhead::Crypto::GetHashFromFile(std::string const& filePath, HashAlgorithm algorithm)
+{
+    Warhead::IO::FileHandle file;
+    if (!file.Open(filePath))
+    {
+        LOG_ERROR("> Crypto: Failed to open file (%s)", filePath.c_str());
+        return "";
+    }
+
+    Hasher hasher(algorithm);
+
+    // The next block is read on the I/O threads while this one is hashed
+    auto read = Warhead::IO::Copy(file, [&hasher](void const* data, std::size_t size)
+    {
+        hasher.Update(data, size);
+        return true;
+    });
+
+    if (!read)
+    {
+        LOG_ERROR("> Crypto: Failed to read file (%s)", filePath.c_str());
+        return "";
+    }
+
+    return hasher.HexDigest();
+}
+
+std::string Warhead::Crypto::GetMD5HashFromFile(std::string const& filePath)
+{
+    return GetHashFromFile(filePath, HashAlgorithm::MD5);
 }
@@ -19,9 +19,50 @@
 #define _WARHEAD_CRYPTOHASH_H_
 
 #include "Common.h"
+#include <vector>
 
 namespace Warhead::Crypto
 {
+    enum class HashAlgorithm : uint8
+    {
+        MD5,
+        SHA1,
+        SHA256,
+        XXH64,      // Non-cryptographic, for integrity checks only
+        XXH3        // Same, XXH3 64 bit, vectorized
+    };
+
+    /// Incremental hash of any HashAlgorithm
+    class WH_COMMON_API Hasher
+    {
+    public:
+        explicit Hasher(HashAlgorithm algorithm);
+        ~Hasher();
+
+        Hasher(Hasher&&) noexcept;
+        Hasher& operator=(Hasher&&) noexcept;
+
+        void Update(void const* data, std::size_t size);
+
+        /// Returns the digest and resets the state. XXH64 and XXH3 digests are big endian, as printed by xxhsum
+        std::vector<uint8> Digest();
+        std::string HexDigest();
+
+        HashAlgorithm GetAlgorithm() const { return _algorithm; }
+
+        struct Impl;
+
+    private:
+        HashAlgorithm _algorithm;
+        std::unique_ptr<Impl> _impl;
+    };
+
+    WH_COMMON_API std::string DigestToHex(uint8 const* digest, std::size_t size);
+
+    /// Hashes the file with large unbuffered reads.
+    /// Returns the hex digest or an empty string if the file can't be read.
+    WH_COMMON_API std::string GetHashFromFile(std::string const& filePath, HashAlgorithm algorithm);
+
     WH_COMMON_API std::string GetMD5HashFromFile(std::string const& filePath);
 }
 
@@ -0,0 +1,285 @@
+/*
+ * This file is part of the WarheadApp Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "Manifest.h"
+#include "DirectoryScanner.h"
+#include "Log.h"
+#include "StringConvert.h"
+#include "StringFormat.h"
+#include "Util.h"
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <thread>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+    constexpr std::string_view MANIFEST_HEADER = "# WarheadManifest";
+    constexpr uint32 MAX_DEFAULT_THREADS = 8;
+
+    std::string_view GetAlgorithmName(Warhead::Crypto::HashAlgorithm algorithm)
+    {
+        switch (algorithm)
+        {
+            case Warhead::Crypto::HashAlgorithm::MD5:
+                return "MD5";
+            case Warhead::Crypto::HashAlgorithm::SHA1:
+                return "SHA1";
+            case Warhead::Crypto::HashAlgorithm::SHA256:
+                return "SHA256";
+            case Warhead::Crypto::HashAlgorithm::XXH64:
+                return "XXH64";
+            case Warhead::Crypto::HashAlgorithm::XXH3:
+                return "XXH3";
+        }
+
+        return "";
+    }
+
+    std::optional<Warhead::Crypto::HashAlgorithm> GetAlgorithmByName(std::string_view name)
+    {
+        for (auto algorithm : { Warhead::Crypto::HashAlgorithm::MD5, Warhead::Crypto::HashAlgorithm::SHA1,
+            Warhead::Crypto::HashAlgorithm::SHA256, Warhead::Crypto::HashAlgorithm::XXH64, Warhead::Crypto::HashAlgorithm::XXH3 })
+            if (GetAlgorithmName(algorithm) == name)
+                return algorithm;
+
+        return std::nullopt;
+    }
+
+    uint32 GetThreadCount(uint32 threads)
+    {
+        if (threads)
+            return threads;
+
+        return std::clamp(std::thread::hardware_concurrency(), 1u, MAX_DEFAULT_THREADS);
+    }
+}
+
+Warhead::Crypto::Manifest Warhead::Crypto::Manifest::Build(std::string const& directory, HashAlgorithm algorithm /*= HashAlgorithm::XXH3*/,
+    Manifest const* cache /*= nullptr*/, uint32 threads /*= DEFAULT_THREADS*/)
+{
+    struct FileJob
+    {
+        std::string FullPath;
+        std::string Path;
+        ManifestEntry Entry;
+    };
+
+    // Paths are UTF-8 like everywhere in Warhead::File and Warhead::IO, MSVC would read a plain
+    // std::string in the ANSI code page, hence u8path and generic_u8string
+    fs::path root = fs::absolute(fs::u8path(directory));
+    std::vector<std::string> pathList;
+    std::mutex pathLock;
+
+    Warhead::File::ScanDirectory(root.generic_u8string(), [&pathList, &pathLock](Warhead::File::ScanEntry const& entry)
+    {
+        if (entry.Type == Warhead::File::EntryType::File)
+        {
+            std::lock_guard<std::mutex> guard(pathLock);
+            pathList.emplace_back(entry.Path);
+        }
+
+        return true;
+    });
+
+    std::vector<FileJob> jobs;
+    jobs.reserve(pathList.size());
+
+    for (auto& fullPath : pathList)
+    {
+        std::error_code error;
+        fs::path path = fs::u8path(fullPath);
+
+        FileJob job;
+        job.Path = path.lexically_relative(root).generic_u8string();
+        job.Entry.Size = fs::file_size(path, error);
+        job.Entry.ModifiedTime = int64(fs::last_write_time(path, error).time_since_epoch().count());
+        job.FullPath = std::move(fullPath);
+
+        // Unchanged since the cached run, skip reading it
+        if (cache && cache->GetAlgorithm() == algorithm)
+        {
+            ManifestEntry const* cached = cache->GetEntry(job.Path);
+            if (cached && !cached->Hash.empty() && cached->Size == job.Entry.Size && cached->ModifiedTime == job.Entry.ModifiedTime)
+                job.Entry.Hash = cached->Hash;
+        }
+
+        jobs.emplace_back(std::move(job));
+    }
+
+    std::atomic<std::size_t> nextJob{ 0 };
+
+    auto worker = [&]()
+    {
+        for (std::size_t i = nextJob++; i < jobs.size(); i = nextJob++)
+            if (jobs[i].Entry.Hash.empty())
+                jobs[i].Entry.Hash = GetHashFromFile(jobs[i].FullPath, algorithm);
+    };
+
+    std::vector<std::thread> workers;
+    uint32 threadCount = std::min<uint32>(GetThreadCount(threads), uint32(std::max<std::size_t>(jobs.size(), 1)));
+
+    for (uint32 i = 1; i < threadCount; ++i)
+        workers.emplace_back(worker);
+
+    worker();
+
+    for (auto& thread : workers)
+        thread.join();
+
+    Manifest manifest(algorithm);
+    manifest._entries.reserve(jobs.size());
+
+    for (auto& job : jobs)
+        manifest._entries.emplace(std::move(job.Path), std::move(job.Entry));
+
+    return manifest;
+}
+
+std::optional<Warhead::Crypto::Manifest> Warhead::Crypto::Manifest::Load(std::string const& manifestFile)
+{
+    std::ifstream in(fs::u8path(manifestFile));
+    if (!in.is_open())
+        return std::nullopt;
+
+    std::string line;
+    std::getline(in, line);
+
+    auto header = Warhead::Tokenize(line, ' ', false);
+    if (header.size() != 3 || fmt::format("{} {}", header[0], header[1]) != MANIFEST_HEADER)
+    {
+        LOG_ERROR("> Manifest: Bad header in file (%s)", manifestFile.c_str());
+        return std::nullopt;
+    }
+
+    auto algorithm = GetAlgorithmByName(header[2]);
+    if (!algorithm)
+    {
+        LOG_ERROR("> Manifest: Unknown hash algorithm in file (%s)", manifestFile.c_str());
+        return std::nullopt;
+    }
+
+    Manifest manifest(*algorithm);
+    uint32 lineNumber = 1;
+
+    while (std::getline(in, line))
+    {
+        lineNumber++;
+
+        if (line.empty())
+            continue;
+
+        // Path is the last field and may contain spaces
+        std::string_view lineView(line);
+        std::string_view fields[3];
+        bool valid = true;
+
+        for (auto& field : fields)
+        {
+            std::size_t end = lineView.find(' ');
+            if (end == std::string_view::npos)
+            {
+                valid = false;
+                break;
+            }
+
+            field = lineView.substr(0, end);
+            lineView.remove_prefix(end + 1);
+        }
+
+        auto size = valid ? Warhead::StringTo<uint64>(fields[1]) : std::nullopt;
+        auto modifiedTime = valid ? Warhead::StringTo<int64>(fields[2]) : std::nullopt;
+
+        if (!size || !modifiedTime || lineView.empty())
+        {
+            LOG_ERROR("> Manifest: Failure to read line number %u in file '%s'", lineNumber, manifestFile.c_str());
+            return std::nullopt;
+        }
+
+        std::string hash(fields[0] != "-" ? fields[0] : std::string_view());
+        manifest._entries[std::string(lineView)] = { std::move(hash), *size, *modifiedTime };
+    }
+
+    return manifest;
+}
+
+bool Warhead::Crypto::Manifest::Save(std::string const& manifestFile) const
+{
+    // Sorted output keeps manifests diffable
+    std::vector<EntryMap::const_iterator> sorted;
+    sorted.reserve(_entries.size());
+
+    for (auto itr = _entries.begin(); itr != _entries.end(); ++itr)
+        sorted.emplace_back(itr);
+
+    std::sort(sorted.begin(), sorted.end(), [](auto const& left, auto const& right) { return left->first < right->first; });
+
+    fmt::memory_buffer buffer;
+    fmt::format_to(buffer, "{} {}\n", MANIFEST_HEADER, GetAlgorithmName(_algorithm));
+
+    for (auto const& itr : sorted)
+        fmt::format_to(buffer, "{} {} {} {}\n", itr->second.Hash.empty() ? "-" : itr->second.Hash, itr->second.Size, itr->second.ModifiedTime, itr->first);
+
+    std::ofstream out(fs::u8path(manifestFile), std::ios_base::binary | std::ios_base::trunc);
+    if (!out.is_open())
+    {
+        LOG_ERROR("> Manifest: Failed to open file (%s)", manifestFile.c_str());
+        return false;
+    }
+
+    out.write(buffer.data(), std::streamsize(buffer.size()));
+    return out.good();
+}
+
+std::vector<Warhead::Crypto::ManifestMismatch> Warhead::Crypto::Manifest::Verify(std::string const& directory, Manifest const* cache /*= nullptr*/,
+    Manifest* current /*= nullptr*/, uint32 threads /*= DEFAULT_THREADS*/) const
+{
+    Manifest actual = Build(directory, _algorithm, cache, threads);
+    std::vector<ManifestMismatch> mismatches;
+
+    for (auto const& [path, entry] : _entries)
+    {
+        ManifestEntry const* actualEntry = actual.GetEntry(path);
+
+        if (!actualEntry)
+            mismatches.push_back({ path, ManifestStatus::Missing });
+        else if (actualEntry->Hash.empty())
+            mismatches.push_back({ path, ManifestStatus::ReadError });
+        else if (actualEntry->Hash != entry.Hash)
+            mismatches.push_back({ path, ManifestStatus::Modified });
+    }
+
+    for (auto const& [path, entry] : actual._entries)
+        if (!GetEntry(path))
+            mismatches.push_back({ path, ManifestStatus::Added });
+
+    if (current)
+        *current = std::move(actual);
+
+    return mismatches;
+}
+
+Warhead::Crypto::ManifestEntry const* Warhead::Crypto::Manifest::GetEntry(std::string const& path) const
+{
+    auto const& itr = _entries.find(path);
+    return itr != _entries.end() ? &itr->second : nullptr;
+}
@@ -0,0 +1,86 @@
+/*
+ * This file is part of the WarheadApp Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef _WARHEAD_MANIFEST_H_
+#define _WARHEAD_MANIFEST_H_
+
+#include "CryptoHash.h"
+#include <optional>
+#include <unordered_map>
+
+namespace Warhead::Crypto
+{
+    struct ManifestEntry
+    {
+        std::string Hash;
+        uint64 Size = 0;
+        int64 ModifiedTime = 0;
+    };
+
+    enum class ManifestStatus : uint8
+    {
+        Modified,   // Hash differs from the manifest
+        Missing,    // Listed in the manifest but not found
+        Added,      // Found but not listed in the manifest
+        ReadError   // Could not be read
+    };
+
+    struct ManifestMismatch
+    {
+        std::string Path;
+        ManifestStatus Status;
+    };
+
+    /// Checksums of all files in a directory tree, keyed by path relative to the root.
+    ///
+    /// File format, one entry per line after the header:
+    /// # WarheadManifest <algorithm>
+    /// <hash> <size> <modified time> <relative path>
+    class WH_COMMON_API Manifest
+    {
+    public:
+        using EntryMap = std::unordered_map<std::string /*relative path*/, ManifestEntry>;
+
+        static constexpr uint32 DEFAULT_THREADS = 0; // use hardware concurrency, max 8
+
+        explicit Manifest(HashAlgorithm algorithm = HashAlgorithm::XXH3) : _algorithm(algorithm) { }
+
+        /// Hashes all files under directory on 'threads' workers, which bounds the parallel reads.
+        /// Files with the same size and modified time as in 'cache' reuse the cached hash instead of being read.
+        static Manifest Build(std::string const& directory, HashAlgorithm algorithm = HashAlgorithm::XXH3,
+            Manifest const* cache = nullptr, uint32 threads = DEFAULT_THREADS);
+
+        static std::optional<Manifest> Load(std::string const& manifestFile);
+        bool Save(std::string const& manifestFile) const;
+
+        /// Compares the directory with this manifest. 'current' receives the manifest built from the directory,
+        /// save it and pass it as 'cache' on the next run to only hash changed files.
+        std::vector<ManifestMismatch> Verify(std::string const& directory, Manifest const* cache = nullptr,
+            Manifest* current = nullptr, uint32 threads = DEFAULT_THREADS) const;
+
+        HashAlgorithm GetAlgorithm() const { return _algorithm; }
+        EntryMap const& GetEntries() const { return _entries; }
+        ManifestEntry const* GetEntry(std::string const& path) const;
+
+    private:
+        HashAlgorithm _algorithm;
+        EntryMap _entries;
+    };
+}
+
+#endif // _WARHEAD_MANIFEST_H_
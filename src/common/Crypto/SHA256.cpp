@@ -0,0 +1,234 @@
+/*
+ * This file is part of the WarheadApp Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "SHA256.h"
+#include "CpuInfo.h"
+#include <Poco/SHA2Engine.h>
+#include <algorithm>
+#include <cstring>
+
+#if defined(_M_X64) || defined(__x86_64__)
+#  define WH_SHA256_NI
+#  if WH_COMPILER == WH_COMPILER_MICROSOFT
+#    include <intrin.h>
+#    define WH_TARGET_SHA
+#  else
+#    include <immintrin.h>
+#    define WH_TARGET_SHA __attribute__((target("sha,sse4.1,ssse3")))
+#  endif
+#endif
+
+namespace
+{
+    constexpr uint32 InitialState[8] =
+    {
+        0x6A09E667, 0xBB67AE85, 0x3C6EF372, 0xA54FF53A, 0x510E527F, 0x9B05688C, 0x1F83D9AB, 0x5BE0CD19
+    };
+
+#ifdef WH_SHA256_NI
+    alignas(16) constexpr uint32 RoundConstants[64] =
+    {
+        0x428A2F98, 0x71374491, 0xB5C0FBCF, 0xE9B5DBA5, 0x3956C25B, 0x59F111F1, 0x923F82A4, 0xAB1C5ED5,
+        0xD807AA98, 0x12835B01, 0x243185BE, 0x550C7DC3, 0x72BE5D74, 0x80DEB1FE, 0x9BDC06A7, 0xC19BF174,
+        0xE49B69C1, 0xEFBE4786, 0x0FC19DC6, 0x240CA1CC, 0x2DE92C6F, 0x4A7484AA, 0x5CB0A9DC, 0x76F988DA,
+        0x983E5152, 0xA831C66D, 0xB00327C8, 0xBF597FC7, 0xC6E00BF3, 0xD5A79147, 0x06CA6351, 0x14292967,
+        0x27B70A85, 0x2E1B2138, 0x4D2C6DFC, 0x53380D13, 0x650A7354, 0x766A0ABB, 0x81C2C92E, 0x92722C85,
+        0xA2BFE8A1, 0xA81A664B, 0xC24B8B70, 0xC76C51A3, 0xD192E819, 0xD6990624, 0xF40E3585, 0x106AA070,
+        0x19A4C116, 0x1E376C08, 0x2748774C, 0x34B0BCB5, 0x391C0CB3, 0x4ED8AA4A, 0x5B9CCA4F, 0x682E6FF3,
+        0x748F82EE, 0x78A5636F, 0x84C87814, 0x8CC70208, 0x90BEFFFA, 0xA4506CEB, 0xBEF9A3F7, 0xC67178F2
+    };
+
+    // Processes 64 byte blocks with the SHA extensions
+    WH_TARGET_SHA void TransformShaNi(uint32* state, uint8 const* data, std::size_t blocks)
+    {
+        __m128i const byteSwapMask = _mm_set_epi64x(0x0C0D0E0F08090A0BULL, 0x0405060700010203ULL);
+
+        // Reorder state into ABEF/CDGH as expected by sha256rnds2
+        __m128i tmp = _mm_loadu_si128(reinterpret_cast<__m128i const*>(&state[0]));
+        __m128i state1 = _mm_loadu_si128(reinterpret_cast<__m128i const*>(&state[4]));
+
+        tmp = _mm_shuffle_epi32(tmp, 0xB1);
+        state1 = _mm_shuffle_epi32(state1, 0x1B);
+        __m128i state0 = _mm_alignr_epi8(tmp, state1, 8);
+        state1 = _mm_blend_epi16(state1, tmp, 0xF0);
+
+        for (; blocks; --blocks, data += 64)
+        {
+            __m128i abefSave = state0;
+            __m128i cdghSave = state1;
+            __m128i msg[4];
+
+            // 16 groups of 4 rounds, the message schedule is kept in msg[] as a ring
+            for (int i = 0; i < 16; ++i)
+            {
+                if (i < 4)
+                    msg[i] = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<__m128i const*>(data + i * 16)), byteSwapMask);
+
+                __m128i words = _mm_add_epi32(msg[i & 3], _mm_load_si128(reinterpret_cast<__m128i const*>(&RoundConstants[i * 4])));
+                state1 = _mm_sha256rnds2_epu32(state1, state0, words);
+
+                if (i >= 3 && i < 15)
+                {
+                    __m128i& next = msg[(i + 1) & 3];
+                    next = _mm_add_epi32(next, _mm_alignr_epi8(msg[i & 3], msg[(i - 1) & 3], 4));
+                    next = _mm_sha256msg2_epu32(next, msg[i & 3]);
+                }
+
+                words = _mm_shuffle_epi32(words, 0x0E);
+                state0 = _mm_sha256rnds2_epu32(state0, state1, words);
+
+                if (i >= 1 && i < 13)
+                    msg[(i - 1) & 3] = _mm_sha256msg1_epu32(msg[(i - 1) & 3], msg[i & 3]);
+            }
+
+            state0 = _mm_add_epi32(state0, abefSave);
+            state1 = _mm_add_epi32(state1, cdghSave);
+        }
+
+        tmp = _mm_shuffle_epi32(state0, 0x1B);
+        state1 = _mm_shuffle_epi32(state1, 0xB1);
+        state0 = _mm_blend_epi16(tmp, state1, 0xF0);
+        state1 = _mm_alignr_epi8(state1, tmp, 8);
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(&state[0]), state0);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(&state[4]), state1);
+    }
+#endif
+
+    bool IsShaNiSupported()
+    {
+#ifdef WH_SHA256_NI
+        using Warhead::Cpu::Feature;
+        static bool const supported = Warhead::Cpu::GetFeatures().Contains({ Feature::SSSE3, Feature::SSE41, Feature::SHA });
+        return supported;
+#else
+        return false;
+#endif
+    }
+
+    void Transform(uint32* state, uint8 const* data, std::size_t blocks)
+    {
+#ifdef WH_SHA256_NI
+        TransformShaNi(state, data, blocks);
+#else
+        (void)state; (void)data; (void)blocks;
+#endif
+    }
+}
+
+Warhead::Crypto::SHA256::SHA256()
+{
+    if (!IsShaNiSupported())
+        _engine = std::make_unique<Poco::SHA2Engine>(Poco::SHA2Engine::SHA_256);
+
+    Reset();
+}
+
+Warhead::Crypto::SHA256::~SHA256() = default;
+
+bool Warhead::Crypto::SHA256::IsAccelerated()
+{
+    return IsShaNiSupported();
+}
+
+void Warhead::Crypto::SHA256::Reset()
+{
+    std::memcpy(_state, InitialState, sizeof(_state));
+    _bufferSize = 0;
+    _totalSize = 0;
+
+    if (_engine)
+        _engine->reset();
+}
+
+void Warhead::Crypto::SHA256::Update(void const* data, std::size_t size)
+{
+    if (_engine)
+    {
+        _engine->update(data, size);
+        return;
+    }
+
+    // data may be null when there is nothing to hash, memcpy must not see it
+    if (!size)
+        return;
+
+    uint8 const* input = static_cast<uint8 const*>(data);
+    _totalSize += size;
+
+    if (_bufferSize)
+    {
+        std::size_t fill = std::min(size, sizeof(_buffer) - _bufferSize);
+        std::memcpy(_buffer + _bufferSize, input, fill);
+        _bufferSize += fill;
+        input += fill;
+        size -= fill;
+
+        if (_bufferSize < sizeof(_buffer))
+            return;
+
+        Transform(_state, _buffer, 1);
+        _bufferSize = 0;
+    }
+
+    if (std::size_t blocks = size / 64)
+    {
+        Transform(_state, input, blocks);
+        input += blocks * 64;
+        size -= blocks * 64;
+    }
+
+    if (size)
+    {
+        std::memcpy(_buffer, input, size);
+        _bufferSize = size;
+    }
+}
+
+Warhead::Crypto::SHA256::Digest Warhead::Crypto::SHA256::Finalize()
+{
+    Digest digest;
+
+    if (_engine)
+    {
+        auto const& engineDigest = _engine->digest();
+        std::copy(engineDigest.begin(), engineDigest.end(), digest.begin());
+        return digest;
+    }
+
+    // Padding: 0x80, zeros, then the message length in bits as big endian
+    uint64 bitSize = _totalSize * 8;
+    uint8 padding[72] = { 0x80 };
+    std::size_t paddingSize = (_bufferSize < 56 ? 56 : 120) - _bufferSize;
+
+    for (int i = 0; i < 8; ++i)
+        padding[paddingSize + i] = uint8(bitSize >> (56 - i * 8));
+
+    Update(padding, paddingSize + 8);
+
+    for (std::size_t i = 0; i < 8; ++i)
+    {
+        digest[i * 4] = uint8(_state[i] >> 24);
+        digest[i * 4 + 1] = uint8(_state[i] >> 16);
+        digest[i * 4 + 2] = uint8(_state[i] >> 8);
+        digest[i * 4 + 3] = uint8(_state[i]);
+    }
+
+    Reset();
+    return digest;
+}
@@ -0,0 +1,66 @@
+/*
+ * This file is part of the WarheadApp Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef _WARHEAD_SHA256_H_
+#define _WARHEAD_SHA256_H_
+
+#include "Define.h"
+#include <array>
+#include <memory>
+
+namespace Poco
+{
+    class SHA2Engine;
+}
+
+namespace Warhead::Crypto
+{
+    /// SHA-256 hash. Uses the x86 SHA extensions when the CPU supports them,
+    /// Poco::SHA2Engine otherwise.
+    class WH_COMMON_API SHA256
+    {
+    public:
+        static constexpr std::size_t DIGEST_SIZE = 32;
+        using Digest = std::array<uint8, DIGEST_SIZE>;
+
+        SHA256();
+        ~SHA256();
+
+        SHA256(SHA256 const&) = delete;
+        SHA256& operator=(SHA256 const&) = delete;
+
+        void Update(void const* data, std::size_t size);
+
+        /// Returns the digest and resets the state
+        Digest Finalize();
+
+        static bool IsAccelerated();
+
+    private:
+        void Reset();
+
+        uint32 _state[8];
+        uint8 _buffer[64];
+        std::size_t _bufferSize;
+        uint64 _totalSize;
+
+        std::unique_ptr<Poco::SHA2Engine> _engine; // fallback when SHA extensions are not available
+    };
+}
+
+#endif // _WARHEAD_SHA256_H_
@@ -0,0 +1,180 @@
+/*
+ * This file is part of the WarheadApp Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "TreeHash.h"
+#include "FileHandle.h"
+#include "Log.h"
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <thread>
+
+namespace
+{
+    constexpr uint8 LEAF_PREFIX = 0x00;
+    constexpr uint8 NODE_PREFIX = 0x01;
+
+    Warhead::Crypto::TreeHash::Digest HashLeaf(Warhead::Crypto::Hasher& hasher, void const* data, std::size_t size)
+    {
+        hasher.Update(&LEAF_PREFIX, 1);
+        hasher.Update(data, size);
+        return hasher.Digest();
+    }
+
+    Warhead::Crypto::TreeHash::Digest GetRootFromLeaves(Warhead::Crypto::HashAlgorithm algorithm, std::vector<Warhead::Crypto::TreeHash::Digest> level)
+    {
+        Warhead::Crypto::Hasher hasher(algorithm);
+
+        if (level.empty())
+            level.emplace_back(HashLeaf(hasher, nullptr, 0));
+
+        while (level.size() > 1)
+        {
+            std::size_t pairs = level.size() / 2;
+
+            for (std::size_t i = 0; i < pairs; ++i)
+            {
+                hasher.Update(&NODE_PREFIX, 1);
+                hasher.Update(level[i * 2].data(), level[i * 2].size());
+                hasher.Update(level[i * 2 + 1].data(), level[i * 2 + 1].size());
+                level[i] = hasher.Digest();
+            }
+
+            // Odd node is promoted to the next level
+            if (level.size() % 2)
+                level[pairs++] = std::move(level.back());
+
+            level.resize(pairs);
+        }
+
+        return std::move(level.front());
+    }
+}
+
+Warhead::Crypto::TreeHash::TreeHash(HashAlgorithm algorithm /*= HashAlgorithm::SHA256*/, std::size_t leafSize /*= DEFAULT_LEAF_SIZE*/) :
+    _algorithm(algorithm), _leafSize(leafSize ? leafSize : DEFAULT_LEAF_SIZE), _size(0) { }
+
+bool Warhead::Crypto::TreeHash::Update(std::string const& filePath, uint32 threads /*= DEFAULT_THREADS*/)
+{
+    // Sized through the open handle, std::filesystem would read the path in the ANSI code page on MSVC
+    Warhead::IO::FileHandle file;
+    if (!file.Open(filePath))
+    {
+        LOG_ERROR("> TreeHash: Failed to open file (%s)", filePath.c_str());
+        return false;
+    }
+
+    std::optional<uint64> fileSize = file.GetSize();
+    if (!fileSize)
+    {
+        LOG_ERROR("> TreeHash: Failed to get size of file (%s)", filePath.c_str());
+        return false;
+    }
+
+    uint64 size = *fileSize;
+
+    // Shrunk file is not append-only, start over
+    if (size < _size)
+        Reset();
+
+    // Full leaves from the previous run are kept, the partial last one is hashed again
+    std::size_t firstLeaf = std::size_t(_size / _leafSize);
+    std::size_t leafCount = std::size_t((size + _leafSize - 1) / _leafSize);
+
+    _leaves.resize(leafCount);
+
+    std::atomic<std::size_t> nextLeaf{ firstLeaf };
+    std::atomic<bool> failed{ false };
+
+    // Positional reads, all workers share the handle
+    auto worker = [&]()
+    {
+        std::unique_ptr<uint8[]> buffer(new uint8[_leafSize]);
+        Hasher hasher(_algorithm);
+
+        for (std::size_t leaf = nextLeaf++; leaf < leafCount && !failed; leaf = nextLeaf++)
+        {
+            uint64 offset = uint64(leaf) * _leafSize;
+            std::size_t leafSize = std::size_t(std::min<uint64>(_leafSize, size - offset));
+
+            if (!file.ReadExactAt(offset, buffer.get(), leafSize))
+            {
+                failed = true;
+                return;
+            }
+
+            _leaves[leaf] = HashLeaf(hasher, buffer.get(), leafSize);
+        }
+    };
+
+    std::size_t jobs = leafCount - std::min(firstLeaf, leafCount);
+    uint32 threadCount = threads ? threads : std::max(std::thread::hardware_concurrency(), 1u);
+    threadCount = uint32(std::min<std::size_t>(threadCount, std::max<std::size_t>(jobs, 1)));
+
+    std::vector<std::thread> workers;
+
+    for (uint32 i = 1; i < threadCount; ++i)
+        workers.emplace_back(worker);
+
+    worker();
+
+    for (auto& thread : workers)
+        thread.join();
+
+    if (failed)
+    {
+        LOG_ERROR("> TreeHash: Failed to read file (%s)", filePath.c_str());
+        Reset();
+        return false;
+    }
+
+    _size = size;
+    return true;
+}
+
+void Warhead::Crypto::TreeHash::Reset()
+{
+    _size = 0;
+    _leaves.clear();
+}
+
+Warhead::Crypto::TreeHash::Digest Warhead::Crypto::TreeHash::GetRoot() const
+{
+    return GetRootFromLeaves(_algorithm, _leaves);
+}
+
+std::string Warhead::Crypto::TreeHash::GetRootHex() const
+{
+    Digest root = GetRoot();
+    return DigestToHex(root.data(), root.size());
+}
+
+Warhead::Crypto::TreeHash::Digest Warhead::Crypto::TreeHash::Hash(void const* data, std::size_t size, HashAlgorithm algorithm /*= HashAlgorithm::SHA256*/, std::size_t leafSize /*= DEFAULT_LEAF_SIZE*/)
+{
+    if (!leafSize)
+        leafSize = DEFAULT_LEAF_SIZE;
+
+    uint8 const* input = static_cast<uint8 const*>(data);
+    Hasher hasher(algorithm);
+    std::vector<Digest> leaves;
+
+    for (std::size_t offset = 0; offset < size; offset += leafSize)
+        leaves.emplace_back(HashLeaf(hasher, input + offset, std::min(leafSize, size - offset)));
+
+    return GetRootFromLeaves(algorithm, std::move(leaves));
+}
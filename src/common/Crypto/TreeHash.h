@@ -0,0 +1,72 @@
+/*
+ * This file is part of the WarheadApp Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef _WARHEAD_TREEHASH_H_
+#define _WARHEAD_TREEHASH_H_
+
+#include "CryptoHash.h"
+
+namespace Warhead::Crypto
+{
+    /// Merkle tree hash over fixed size leaves, leaves are hashed in parallel.
+    ///
+    /// leaf = H(0x00 || leaf data), the last leaf may be shorter, empty input is a single empty leaf
+    /// node = H(0x01 || left || right), an odd node at the end of a level is promoted unchanged
+    /// root = the single node of the last level
+    ///
+    /// Test vectors, SHA256 with 4 byte leaves:
+    /// ""                   -> 6e340b9cffb37a989ca544e6bb780a2c78901d3fb33738768511a30617afa01d
+    /// "abc"                -> 609f6e36d2405585188d5cfd761f407c7cc46a7d3f314c88270469dde315fcd1
+    /// "abcdefghij"         -> 2a5b33d54d89d05737a7dd798d9862d55951564aafb5460691ad8a7a9ab6c678
+    /// bytes 0..255 x 40    -> 8762bb7808aef80a3db7969d45a6ede19fd3e5e497ceab46873f284225aadae6
+    class WH_COMMON_API TreeHash
+    {
+    public:
+        static constexpr std::size_t DEFAULT_LEAF_SIZE = 4 * 1024 * 1024;
+        static constexpr uint32 DEFAULT_THREADS = 0; // use hardware concurrency
+
+        using Digest = std::vector<uint8>;
+
+        explicit TreeHash(HashAlgorithm algorithm = HashAlgorithm::SHA256, std::size_t leafSize = DEFAULT_LEAF_SIZE);
+
+        /// Hashes the file. Files are expected to be append-only between calls:
+        /// if the file did not shrink, only the last partial leaf and the appended leaves are read again.
+        /// Returns false if the file can't be read.
+        bool Update(std::string const& filePath, uint32 threads = DEFAULT_THREADS);
+
+        /// Forgets all leaves, the next Update hashes the whole file
+        void Reset();
+
+        Digest GetRoot() const;
+        std::string GetRootHex() const;
+
+        std::vector<Digest> const& GetLeaves() const { return _leaves; }
+        uint64 GetSize() const { return _size; }
+
+        /// Tree hash of a memory buffer, single threaded
+        static Digest Hash(void const* data, std::size_t size, HashAlgorithm algorithm = HashAlgorithm::SHA256, std::size_t leafSize = DEFAULT_LEAF_SIZE);
+
+    private:
+        HashAlgorithm _algorithm;
+        std::size_t _leafSize;
+        uint64 _size;
+        std::vector<Digest> _leaves;
+    };
+}
+
+#endif // _WARHEAD_TREEHASH_H_
@@ -0,0 +1,689 @@
+/*
+ * This file is part of the WarheadApp Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "XXHash.h"
+#include "CpuInfo.h"
+#include <algorithm>
+#include <cstring>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#  define WH_XXH3_SIMD
+#  if WH_COMPILER == WH_COMPILER_MICROSOFT
+#    include <intrin.h>
+#    define WH_TARGET_SSE2
+#    define WH_TARGET_AVX2
+#  else
+#    include <immintrin.h>
+#    define WH_TARGET_SSE2 __attribute__((target("sse2")))
+#    define WH_TARGET_AVX2 __attribute__((target("avx2")))
+#  endif
+#endif
+
+namespace
+{
+    constexpr uint32 PRIME32_1 = 0x9E3779B1;
+    constexpr uint32 PRIME32_2 = 0x85EBCA77;
+    constexpr uint32 PRIME32_3 = 0xC2B2AE3D;
+
+    constexpr uint64 PRIME64_1 = UI64LIT(0x9E3779B185EBCA87);
+    constexpr uint64 PRIME64_2 = UI64LIT(0xC2B2AE3D27D4EB4F);
+    constexpr uint64 PRIME64_3 = UI64LIT(0x165667B19E3779F9);
+    constexpr uint64 PRIME64_4 = UI64LIT(0x85EBCA77C2B2AE63);
+    constexpr uint64 PRIME64_5 = UI64LIT(0x27D4EB2F165667C5);
+
+    inline uint64 RotateLeft(uint64 value, int bits)
+    {
+        return (value << bits) | (value >> (64 - bits));
+    }
+
+    // xxHash is defined on little endian input, all our targets are little endian
+    inline uint64 Read64(uint8 const* data)
+    {
+        uint64 value;
+        std::memcpy(&value, data, sizeof(value));
+        return value;
+    }
+
+    inline uint32 Read32(uint8 const* data)
+    {
+        uint32 value;
+        std::memcpy(&value, data, sizeof(value));
+        return value;
+    }
+
+    inline uint64 Round(uint64 acc, uint64 input)
+    {
+        acc += input * PRIME64_2;
+        acc = RotateLeft(acc, 31);
+        return acc * PRIME64_1;
+    }
+
+    inline uint64 MergeRound(uint64 acc, uint64 value)
+    {
+        acc ^= Round(0, value);
+        return acc * PRIME64_1 + PRIME64_4;
+    }
+
+    inline uint64 Avalanche(uint64 hash)
+    {
+        hash ^= hash >> 33;
+        hash *= PRIME64_2;
+        hash ^= hash >> 29;
+        hash *= PRIME64_3;
+        hash ^= hash >> 32;
+        return hash;
+    }
+
+    // Consumes the tail (less than 32 bytes) of the input
+    uint64 Finalize(uint64 hash, uint8 const* data, std::size_t size)
+    {
+        while (size >= 8)
+        {
+            hash ^= Round(0, Read64(data));
+            hash = RotateLeft(hash, 27) * PRIME64_1 + PRIME64_4;
+            data += 8;
+            size -= 8;
+        }
+
+        if (size >= 4)
+        {
+            hash ^= uint64(Read32(data)) * PRIME64_1;
+            hash = RotateLeft(hash, 23) * PRIME64_2 + PRIME64_3;
+            data += 4;
+            size -= 4;
+        }
+
+        while (size > 0)
+        {
+            hash ^= (*data) * PRIME64_5;
+            hash = RotateLeft(hash, 11) * PRIME64_1;
+            ++data;
+            --size;
+        }
+
+        return Avalanche(hash);
+    }
+}
+
+Warhead::Crypto::XXH64::XXH64(uint64 seed /*= 0*/)
+{
+    Reset(seed);
+}
+
+void Warhead::Crypto::XXH64::Reset(uint64 seed /*= 0*/)
+{
+    _seed = seed;
+    _v[0] = seed + PRIME64_1 + PRIME64_2;
+    _v[1] = seed + PRIME64_2;
+    _v[2] = seed;
+    _v[3] = seed - PRIME64_1;
+    _totalSize = 0;
+    _bufferSize = 0;
+}
+
+void Warhead::Crypto::XXH64::Update(void const* data, std::size_t size)
+{
+    // data may be null when there is nothing to hash, memcpy must not see it
+    if (!size)
+        return;
+
+    uint8 const* input = static_cast<uint8 const*>(data);
+    _totalSize += size;
+
+    // Complete the pending stripe first
+    if (_bufferSize)
+    {
+        std::size_t fill = std::min(size, sizeof(_buffer) - _bufferSize);
+        std::memcpy(_buffer + _bufferSize, input, fill);
+        _bufferSize += fill;
+        input += fill;
+        size -= fill;
+
+        if (_bufferSize < sizeof(_buffer))
+            return;
+
+        for (int i = 0; i < 4; ++i)
+            _v[i] = Round(_v[i], Read64(_buffer + i * 8));
+
+        _bufferSize = 0;
+    }
+
+    // Main loop, four independent lanes of 8 bytes
+    uint64 v1 = _v[0], v2 = _v[1], v3 = _v[2], v4 = _v[3];
+
+    while (size >= 32)
+    {
+        v1 = Round(v1, Read64(input));
+        v2 = Round(v2, Read64(input + 8));
+        v3 = Round(v3, Read64(input + 16));
+        v4 = Round(v4, Read64(input + 24));
+        input += 32;
+        size -= 32;
+    }
+
+    _v[0] = v1; _v[1] = v2; _v[2] = v3; _v[3] = v4;
+
+    if (size)
+    {
+        std::memcpy(_buffer, input, size);
+        _bufferSize = size;
+    }
+}
+
+uint64 Warhead::Crypto::XXH64::Digest() const
+{
+    uint64 hash;
+
+    if (_totalSize >= 32)
+    {
+        hash = RotateLeft(_v[0], 1) + RotateLeft(_v[1], 7) + RotateLeft(_v[2], 12) + RotateLeft(_v[3], 18);
+
+        for (uint64 v : _v)
+            hash = MergeRound(hash, v);
+    }
+    else
+        hash = _seed + PRIME64_5;
+
+    hash += _totalSize;
+
+    return Finalize(hash, _buffer, _bufferSize);
+}
+
+uint64 Warhead::Crypto::XXH64::Hash(void const* data, std::size_t size, uint64 seed /*= 0*/)
+{
+    XXH64 state(seed);
+    state.Update(data, size);
+    return state.Digest();
+}
+
+namespace
+{
+    using Warhead::Crypto::XXH3;
+
+    constexpr std::size_t SECRET_SIZE = XXH3::SECRET_SIZE;
+    constexpr std::size_t STRIPE_SIZE = 64;
+    constexpr std::size_t SECRET_CONSUME_RATE = 8;      // Secret offset between two stripes
+    constexpr std::size_t STRIPES_PER_BLOCK = (SECRET_SIZE - STRIPE_SIZE) / SECRET_CONSUME_RATE;
+    constexpr std::size_t SECRET_LAST_ACC_START = 7;
+    constexpr std::size_t SECRET_MERGE_ACCS_START = 11;
+    constexpr std::size_t MID_SIZE_MAX = 240;
+
+    constexpr uint64 PRIME_MX1 = UI64LIT(0x165667919E3779F9);
+    constexpr uint64 PRIME_MX2 = UI64LIT(0x9FB21C651E98DF25);
+
+    constexpr uint64 INITIAL_ACC[8] = { PRIME32_3, PRIME64_1, PRIME64_2, PRIME64_3, PRIME64_4, PRIME32_2, PRIME64_5, PRIME32_1 };
+
+    // Default secret of the reference implementation
+    constexpr uint8 DefaultSecret[SECRET_SIZE] =
+    {
+        0xB8, 0xFE, 0x6C, 0x39, 0x23, 0xA4, 0x4B, 0xBE, 0x7C, 0x01, 0x81, 0x2C, 0xF7, 0x21, 0xAD, 0x1C,
+        0xDE, 0xD4, 0x6D, 0xE9, 0x83, 0x90, 0x97, 0xDB, 0x72, 0x40, 0xA4, 0xA4, 0xB7, 0xB3, 0x67, 0x1F,
+        0xCB, 0x79, 0xE6, 0x4E, 0xCC, 0xC0, 0xE5, 0x78, 0x82, 0x5A, 0xD0, 0x7D, 0xCC, 0xFF, 0x72, 0x21,
+        0xB8, 0x08, 0x46, 0x74, 0xF7, 0x43, 0x24, 0x8E, 0xE0, 0x35, 0x90, 0xE6, 0x81, 0x3A, 0x26, 0x4C,
+        0x3C, 0x28, 0x52, 0xBB, 0x91, 0xC3, 0x00, 0xCB, 0x88, 0xD0, 0x65, 0x8B, 0x1B, 0x53, 0x2E, 0xA3,
+        0x71, 0x64, 0x48, 0x97, 0xA2, 0x0D, 0xF9, 0x4E, 0x38, 0x19, 0xEF, 0x46, 0xA9, 0xDE, 0xAC, 0xD8,
+        0xA8, 0xFA, 0x76, 0x3F, 0xE3, 0x9C, 0x34, 0x3F, 0xF9, 0xDC, 0xBB, 0xC7, 0xC7, 0x0B, 0x4F, 0x1D,
+        0x8A, 0x51, 0xE0, 0x4B, 0xCD, 0xB4, 0x59, 0x31, 0xC8, 0x9F, 0x7E, 0xC9, 0xD9, 0x78, 0x73, 0x64,
+        0xEA, 0xC5, 0xAC, 0x83, 0x34, 0xD3, 0xEB, 0xC3, 0xC5, 0x81, 0xA0, 0xFF, 0xFA, 0x13, 0x63, 0xEB,
+        0x17, 0x0D, 0xDD, 0x51, 0xB7, 0xF0, 0xDA, 0x49, 0xD3, 0x16, 0x55, 0x26, 0x29, 0xD4, 0x68, 0x9E,
+        0x2B, 0x16, 0xBE, 0x58, 0x7D, 0x47, 0xA1, 0xFC, 0x8F, 0xF8, 0xB8, 0xD1, 0x7A, 0xD0, 0x31, 0xCE,
+        0x45, 0xCB, 0x3A, 0x8F, 0x95, 0x16, 0x04, 0x28, 0xAF, 0xD7, 0xFB, 0xCA, 0xBB, 0x4B, 0x40, 0x7E
+    };
+
+    inline void Write64(uint8* data, uint64 value)
+    {
+        std::memcpy(data, &value, sizeof(value));
+    }
+
+    inline uint32 Swap32(uint32 value)
+    {
+        return (value << 24) | ((value << 8) & 0x00FF0000) | ((value >> 8) & 0x0000FF00) | (value >> 24);
+    }
+
+    inline uint64 Swap64(uint64 value)
+    {
+        return (uint64(Swap32(uint32(value))) << 32) | Swap32(uint32(value >> 32));
+    }
+
+    // Both halves of the 128 bit product folded together
+    inline uint64 Multiply128Fold64(uint64 left, uint64 right)
+    {
+#if defined(__SIZEOF_INT128__)
+        unsigned __int128 product = static_cast<unsigned __int128>(left) * right;
+        return uint64(product) ^ uint64(product >> 64);
+#elif WH_COMPILER == WH_COMPILER_MICROSOFT && defined(_M_X64)
+        uint64 high;
+        uint64 low = _umul128(left, right, &high);
+        return low ^ high;
+#else
+        uint64 lowLow = (left & 0xFFFFFFFF) * (right & 0xFFFFFFFF);
+        uint64 highLow = (left >> 32) * (right & 0xFFFFFFFF);
+        uint64 lowHigh = (left & 0xFFFFFFFF) * (right >> 32);
+        uint64 highHigh = (left >> 32) * (right >> 32);
+        uint64 cross = (lowLow >> 32) + (highLow & 0xFFFFFFFF) + lowHigh;
+        uint64 high = (highLow >> 32) + (cross >> 32) + highHigh;
+        uint64 low = (cross << 32) | (lowLow & 0xFFFFFFFF);
+        return low ^ high;
+#endif
+    }
+
+    inline uint64 Avalanche3(uint64 hash)
+    {
+        hash ^= hash >> 37;
+        hash *= PRIME_MX1;
+        return hash ^ (hash >> 32);
+    }
+
+    inline uint64 AvalancheRrmxmx(uint64 hash, uint64 size)
+    {
+        hash ^= RotateLeft(hash, 49) ^ RotateLeft(hash, 24);
+        hash *= PRIME_MX2;
+        hash ^= (hash >> 35) + size;
+        hash *= PRIME_MX2;
+        return hash ^ (hash >> 28);
+    }
+
+    inline uint64 Mix16(uint8 const* input, uint8 const* secret, uint64 seed)
+    {
+        return Multiply128Fold64(Read64(input) ^ (Read64(secret) + seed), Read64(input + 8) ^ (Read64(secret + 8) - seed));
+    }
+
+    uint64 Hash0To16(uint8 const* input, std::size_t size, uint8 const* secret, uint64 seed)
+    {
+        if (size > 8)
+        {
+            uint64 low = Read64(input) ^ ((Read64(secret + 24) ^ Read64(secret + 32)) + seed);
+            uint64 high = Read64(input + size - 8) ^ ((Read64(secret + 40) ^ Read64(secret + 48)) - seed);
+            return Avalanche3(size + Swap64(low) + high + Multiply128Fold64(low, high));
+        }
+
+        if (size >= 4)
+        {
+            seed ^= uint64(Swap32(uint32(seed))) << 32;
+            uint64 value = Read32(input + size - 4) + (uint64(Read32(input)) << 32);
+            return AvalancheRrmxmx(value ^ ((Read64(secret + 8) ^ Read64(secret + 16)) - seed), size);
+        }
+
+        if (size)
+        {
+            uint32 combined = (uint32(input[0]) << 16) | (uint32(input[size >> 1]) << 24) | uint32(input[size - 1]) | (uint32(size) << 8);
+            return Avalanche(uint64(combined) ^ (uint64(Read32(secret) ^ Read32(secret + 4)) + seed));
+        }
+
+        return Avalanche(seed ^ Read64(secret + 56) ^ Read64(secret + 64));
+    }
+
+    uint64 Hash17To128(uint8 const* input, std::size_t size, uint8 const* secret, uint64 seed)
+    {
+        uint64 acc = size * PRIME64_1;
+
+        // Pairs from both ends, they meet in the middle
+        for (std::size_t i = 0, pairs = (size - 1) / 32; i <= pairs; ++i)
+        {
+            acc += Mix16(input + i * 16, secret + i * 32, seed);
+            acc += Mix16(input + size - (i + 1) * 16, secret + i * 32 + 16, seed);
+        }
+
+        return Avalanche3(acc);
+    }
+
+    uint64 Hash129To240(uint8 const* input, std::size_t size, uint8 const* secret, uint64 seed)
+    {
+        constexpr std::size_t START_OFFSET = 3;
+        constexpr std::size_t LAST_OFFSET = 17;
+        constexpr std::size_t SECRET_SIZE_MIN = 136;
+
+        uint64 acc = size * PRIME64_1;
+
+        for (std::size_t i = 0; i < 8; ++i)
+            acc += Mix16(input + i * 16, secret + i * 16, seed);
+
+        acc = Avalanche3(acc);
+
+        for (std::size_t i = 8; i < size / 16; ++i)
+            acc += Mix16(input + i * 16, secret + (i - 8) * 16 + START_OFFSET, seed);
+
+        acc += Mix16(input + size - 16, secret + SECRET_SIZE_MIN - LAST_OFFSET, seed);
+        return Avalanche3(acc);
+    }
+
+    uint64 HashShort(uint8 const* input, std::size_t size, uint64 seed)
+    {
+        if (size <= 16)
+            return Hash0To16(input, size, DefaultSecret, seed);
+
+        if (size <= 128)
+            return Hash17To128(input, size, DefaultSecret, seed);
+
+        return Hash129To240(input, size, DefaultSecret, seed);
+    }
+
+    // Input longer than MID_SIZE_MAX goes through 8 accumulators, one per 8 bytes of a 64 byte stripe.
+    // Stripe n of a block is keyed with the secret at n * 8, the accumulators are scrambled after every block.
+
+    using AccumulateFunc = void(uint64* acc, uint8 const* input, uint8 const* secret, std::size_t stripes);
+    using ScrambleFunc = void(uint64* acc, uint8 const* secret);
+
+    void AccumulateScalar(uint64* acc, uint8 const* input, uint8 const* secret, std::size_t stripes)
+    {
+        for (; stripes; --stripes, input += STRIPE_SIZE, secret += SECRET_CONSUME_RATE)
+        {
+            for (std::size_t i = 0; i < 8; ++i)
+            {
+                uint64 value = Read64(input + i * 8);
+                uint64 key = value ^ Read64(secret + i * 8);
+                acc[i ^ 1] += value;
+                acc[i] += (key & 0xFFFFFFFF) * (key >> 32);
+            }
+        }
+    }
+
+    void ScrambleScalar(uint64* acc, uint8 const* secret)
+    {
+        for (std::size_t i = 0; i < 8; ++i)
+        {
+            uint64 value = acc[i];
+            value ^= value >> 47;
+            value ^= Read64(secret + i * 8);
+            acc[i] = value * PRIME32_1;
+        }
+    }
+
+#ifdef WH_XXH3_SIMD
+    // The 32x32 bit multiplies are _mm_mul_epu32, the high half of each key is shuffled down first
+
+    WH_TARGET_SSE2 void AccumulateSse2(uint64* acc, uint8 const* input, uint8 const* secret, std::size_t stripes)
+    {
+        __m128i* accLanes = reinterpret_cast<__m128i*>(acc);
+        __m128i lanes[4];
+
+        for (std::size_t i = 0; i < 4; ++i)
+            lanes[i] = _mm_loadu_si128(accLanes + i);
+
+        for (; stripes; --stripes, input += STRIPE_SIZE, secret += SECRET_CONSUME_RATE)
+        {
+            for (std::size_t i = 0; i < 4; ++i)
+            {
+                __m128i value = _mm_loadu_si128(reinterpret_cast<__m128i const*>(input) + i);
+                __m128i key = _mm_xor_si128(value, _mm_loadu_si128(reinterpret_cast<__m128i const*>(secret) + i));
+                __m128i product = _mm_mul_epu32(key, _mm_shuffle_epi32(key, _MM_SHUFFLE(0, 3, 0, 1)));
+                lanes[i] = _mm_add_epi64(lanes[i], _mm_add_epi64(product, _mm_shuffle_epi32(value, _MM_SHUFFLE(1, 0, 3, 2))));
+            }
+        }
+
+        for (std::size_t i = 0; i < 4; ++i)
+            _mm_storeu_si128(accLanes + i, lanes[i]);
+    }
+
+    WH_TARGET_SSE2 void ScrambleSse2(uint64* acc, uint8 const* secret)
+    {
+        __m128i* accLanes = reinterpret_cast<__m128i*>(acc);
+        __m128i const prime = _mm_set1_epi32(int(PRIME32_1));
+
+        for (std::size_t i = 0; i < 4; ++i)
+        {
+            __m128i value = _mm_loadu_si128(accLanes + i);
+            value = _mm_xor_si128(value, _mm_srli_epi64(value, 47));
+            value = _mm_xor_si128(value, _mm_loadu_si128(reinterpret_cast<__m128i const*>(secret) + i));
+
+            __m128i low = _mm_mul_epu32(value, prime);
+            __m128i high = _mm_mul_epu32(_mm_shuffle_epi32(value, _MM_SHUFFLE(0, 3, 0, 1)), prime);
+            _mm_storeu_si128(accLanes + i, _mm_add_epi64(low, _mm_slli_epi64(high, 32)));
+        }
+    }
+
+    WH_TARGET_AVX2 void AccumulateAvx2(uint64* acc, uint8 const* input, uint8 const* secret, std::size_t stripes)
+    {
+        __m256i* accLanes = reinterpret_cast<__m256i*>(acc);
+        __m256i lanes[2] = { _mm256_loadu_si256(accLanes), _mm256_loadu_si256(accLanes + 1) };
+
+        for (; stripes; --stripes, input += STRIPE_SIZE, secret += SECRET_CONSUME_RATE)
+        {
+            for (std::size_t i = 0; i < 2; ++i)
+            {
+                __m256i value = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(input) + i);
+                __m256i key = _mm256_xor_si256(value, _mm256_loadu_si256(reinterpret_cast<__m256i const*>(secret) + i));
+                __m256i product = _mm256_mul_epu32(key, _mm256_shuffle_epi32(key, _MM_SHUFFLE(0, 3, 0, 1)));
+                lanes[i] = _mm256_add_epi64(lanes[i], _mm256_add_epi64(product, _mm256_shuffle_epi32(value, _MM_SHUFFLE(1, 0, 3, 2))));
+            }
+        }
+
+        _mm256_storeu_si256(accLanes, lanes[0]);
+        _mm256_storeu_si256(accLanes + 1, lanes[1]);
+    }
+
+    WH_TARGET_AVX2 void ScrambleAvx2(uint64* acc, uint8 const* secret)
+    {
+        __m256i* accLanes = reinterpret_cast<__m256i*>(acc);
+        __m256i const prime = _mm256_set1_epi32(int(PRIME32_1));
+
+        for (std::size_t i = 0; i < 2; ++i)
+        {
+            __m256i value = _mm256_loadu_si256(accLanes + i);
+            value = _mm256_xor_si256(value, _mm256_srli_epi64(value, 47));
+            value = _mm256_xor_si256(value, _mm256_loadu_si256(reinterpret_cast<__m256i const*>(secret) + i));
+
+            __m256i low = _mm256_mul_epu32(value, prime);
+            __m256i high = _mm256_mul_epu32(_mm256_shuffle_epi32(value, _MM_SHUFFLE(0, 3, 0, 1)), prime);
+            _mm256_storeu_si256(accLanes + i, _mm256_add_epi64(low, _mm256_slli_epi64(high, 32)));
+        }
+    }
+#endif
+
+    struct Kernels
+    {
+        AccumulateFunc* Accumulate;
+        ScrambleFunc* Scramble;
+    };
+
+    Kernels const& GetKernels()
+    {
+        static Kernels const kernels = []()
+        {
+#ifdef WH_XXH3_SIMD
+            using Warhead::Cpu::Feature;
+            using Warhead::Cpu::Select;
+
+            return Kernels
+            {
+                Select<AccumulateFunc>({ { { Feature::AVX2 }, AccumulateAvx2 }, { { Feature::SSE2 }, AccumulateSse2 }, { {}, AccumulateScalar } }),
+                Select<ScrambleFunc>({ { { Feature::AVX2 }, ScrambleAvx2 }, { { Feature::SSE2 }, ScrambleSse2 }, { {}, ScrambleScalar } })
+            };
+#else
+            return Kernels{ AccumulateScalar, ScrambleScalar };
+#endif
+        }();
+
+        return kernels;
+    }
+
+    /// Accumulates up to STRIPES_PER_BLOCK stripes, scrambling when they complete a block
+    void ConsumeStripes(uint64* acc, std::size_t& stripesSoFar, uint8 const* input, std::size_t stripes, uint8 const* secret)
+    {
+        Kernels const& kernels = GetKernels();
+
+        // Scrambles at every block end, stripes may span any number of blocks
+        while (stripes >= STRIPES_PER_BLOCK - stripesSoFar)
+        {
+            std::size_t const toBlockEnd = STRIPES_PER_BLOCK - stripesSoFar;
+            kernels.Accumulate(acc, input, secret + stripesSoFar * SECRET_CONSUME_RATE, toBlockEnd);
+            kernels.Scramble(acc, secret + SECRET_SIZE - STRIPE_SIZE);
+            input += toBlockEnd * STRIPE_SIZE;
+            stripes -= toBlockEnd;
+            stripesSoFar = 0;
+        }
+
+        kernels.Accumulate(acc, input, secret + stripesSoFar * SECRET_CONSUME_RATE, stripes);
+        stripesSoFar += stripes;
+    }
+
+    uint64 MergeAccs(uint64 const* acc, uint8 const* secret, uint64 size)
+    {
+        uint64 hash = size * PRIME64_1;
+        secret += SECRET_MERGE_ACCS_START;
+
+        for (std::size_t i = 0; i < 4; ++i)
+            hash += Multiply128Fold64(acc[i * 2] ^ Read64(secret + i * 16), acc[i * 2 + 1] ^ Read64(secret + i * 16 + 8));
+
+        return Avalanche3(hash);
+    }
+
+    uint64 HashLong(uint8 const* input, std::size_t size, uint8 const* secret)
+    {
+        constexpr std::size_t BLOCK_SIZE = STRIPE_SIZE * STRIPES_PER_BLOCK;
+
+        Kernels const& kernels = GetKernels();
+        uint64 acc[8];
+        std::memcpy(acc, INITIAL_ACC, sizeof(acc));
+
+        // The last stripe is always hashed on its own below, even when it completes a block
+        std::size_t const blocks = (size - 1) / BLOCK_SIZE;
+
+        for (std::size_t i = 0; i < blocks; ++i)
+        {
+            kernels.Accumulate(acc, input + i * BLOCK_SIZE, secret, STRIPES_PER_BLOCK);
+            kernels.Scramble(acc, secret + SECRET_SIZE - STRIPE_SIZE);
+        }
+
+        kernels.Accumulate(acc, input + blocks * BLOCK_SIZE, secret, (size - 1 - blocks * BLOCK_SIZE) / STRIPE_SIZE);
+        kernels.Accumulate(acc, input + size - STRIPE_SIZE, secret + SECRET_SIZE - STRIPE_SIZE - SECRET_LAST_ACC_START, 1);
+
+        return MergeAccs(acc, secret, size);
+    }
+
+    /// Secret of a seeded hash: the seed is added to the low and subtracted from the high 8 bytes of every 16
+    void InitSecret(uint8* secret, uint64 seed)
+    {
+        for (std::size_t i = 0; i < SECRET_SIZE; i += 16)
+        {
+            Write64(secret + i, Read64(DefaultSecret + i) + seed);
+            Write64(secret + i + 8, Read64(DefaultSecret + i + 8) - seed);
+        }
+    }
+}
+
+Warhead::Crypto::XXH3::XXH3(uint64 seed /*= 0*/)
+{
+    Reset(seed);
+}
+
+void Warhead::Crypto::XXH3::Reset(uint64 seed /*= 0*/)
+{
+    _seed = seed;
+    std::memcpy(_acc, INITIAL_ACC, sizeof(_acc));
+
+    if (seed)
+        InitSecret(_secret, seed);
+    else
+        std::memcpy(_secret, DefaultSecret, sizeof(_secret));
+
+    _totalSize = 0;
+    _bufferSize = 0;
+    _stripesSoFar = 0;
+}
+
+void Warhead::Crypto::XXH3::Update(void const* data, std::size_t size)
+{
+    // data may be null when there is nothing to hash, memcpy must not see it
+    if (!size)
+        return;
+
+    uint8 const* input = static_cast<uint8 const*>(data);
+    _totalSize += size;
+
+    // Nothing is consumed until the buffer overflows, so short input is still whole in Digest()
+    if (size <= BUFFER_SIZE - _bufferSize)
+    {
+        std::memcpy(_buffer + _bufferSize, input, size);
+        _bufferSize += size;
+        return;
+    }
+
+    constexpr std::size_t BUFFER_STRIPES = BUFFER_SIZE / STRIPE_SIZE;
+
+    if (_bufferSize)
+    {
+        std::size_t fill = BUFFER_SIZE - _bufferSize;
+        std::memcpy(_buffer + _bufferSize, input, fill);
+        input += fill;
+        size -= fill;
+
+        ConsumeStripes(_acc, _stripesSoFar, _buffer, BUFFER_STRIPES, _secret);
+        _bufferSize = 0;
+    }
+
+    // At least one byte stays buffered, Digest() hashes the last stripe on its own
+    if (size > BUFFER_SIZE)
+    {
+        std::size_t stripes = (size - 1) / STRIPE_SIZE;
+        ConsumeStripes(_acc, _stripesSoFar, input, stripes, _secret);
+        input += stripes * STRIPE_SIZE;
+        size -= stripes * STRIPE_SIZE;
+
+        // Digest() completes a last stripe shorter than 64 bytes from the end of the buffer
+        std::memcpy(_buffer + BUFFER_SIZE - STRIPE_SIZE, input - STRIPE_SIZE, STRIPE_SIZE);
+    }
+
+    std::memcpy(_buffer, input, size);
+    _bufferSize = size;
+}
+
+uint64 Warhead::Crypto::XXH3::Digest() const
+{
+    if (_totalSize <= MID_SIZE_MAX)
+        return HashShort(_buffer, std::size_t(_totalSize), _seed);
+
+    uint64 acc[8];
+    std::memcpy(acc, _acc, sizeof(acc));
+    std::size_t stripesSoFar = _stripesSoFar;
+
+    uint8 stripe[STRIPE_SIZE];
+    uint8 const* lastStripe;
+
+    if (_bufferSize >= STRIPE_SIZE)
+    {
+        ConsumeStripes(acc, stripesSoFar, _buffer, (_bufferSize - 1) / STRIPE_SIZE, _secret);
+        lastStripe = _buffer + _bufferSize - STRIPE_SIZE;
+    }
+    else
+    {
+        // The stripe starts in the bytes consumed before
+        std::size_t previous = STRIPE_SIZE - _bufferSize;
+        std::memcpy(stripe, _buffer + BUFFER_SIZE - previous, previous);
+        std::memcpy(stripe + previous, _buffer, _bufferSize);
+        lastStripe = stripe;
+    }
+
+    GetKernels().Accumulate(acc, lastStripe, _secret + SECRET_SIZE - STRIPE_SIZE - SECRET_LAST_ACC_START, 1);
+    return MergeAccs(acc, _secret, _totalSize);
+}
+
+uint64 Warhead::Crypto::XXH3::Hash(void const* data, std::size_t size, uint64 seed /*= 0*/)
+{
+    uint8 const* input = static_cast<uint8 const*>(data);
+
+    if (size <= MID_SIZE_MAX)
+        return HashShort(input, size, seed);
+
+    if (!seed)
+        return HashLong(input, size, DefaultSecret);
+
+    uint8 secret[SECRET_SIZE];
+    InitSecret(secret, seed);
+    return HashLong(input, size, secret);
+}
@@ -0,0 +1,75 @@
+/*
+ * This file is part of the WarheadApp Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef _WARHEAD_XXHASH_H_
+#define _WARHEAD_XXHASH_H_
+
+#include "Define.h"
+
+namespace Warhead::Crypto
+{
+    /// Streaming XXH64, a fast non-cryptographic hash for integrity checks.
+    /// Output is compatible with the reference xxHash implementation.
+    class WH_COMMON_API XXH64
+    {
+    public:
+        explicit XXH64(uint64 seed = 0);
+
+        void Reset(uint64 seed = 0);
+        void Update(void const* data, std::size_t size);
+        uint64 Digest() const;
+
+        static uint64 Hash(void const* data, std::size_t size, uint64 seed = 0);
+
+    private:
+        uint64 _v[4];
+        uint64 _seed;
+        uint64 _totalSize;
+        uint8 _buffer[32];
+        std::size_t _bufferSize;
+    };
+
+    /// Streaming XXH3 with a 64 bit result, the successor of XXH64 and several times faster on large input.
+    /// 64 byte stripes are accumulated with AVX2 or SSE2 when the CPU has them, scalar otherwise.
+    /// Output matches XXH3_64bits_withSeed of the reference xxHash implementation.
+    class WH_COMMON_API XXH3
+    {
+    public:
+        static constexpr std::size_t SECRET_SIZE = 192;
+        static constexpr std::size_t BUFFER_SIZE = 256;
+
+        explicit XXH3(uint64 seed = 0);
+
+        void Reset(uint64 seed = 0);
+        void Update(void const* data, std::size_t size);
+        uint64 Digest() const;
+
+        static uint64 Hash(void const* data, std::size_t size, uint64 seed = 0);
+
+    private:
+        uint64 _acc[8];
+        uint8 _secret[SECRET_SIZE];     // Default secret, or derived from a non zero seed
+        uint8 _buffer[BUFFER_SIZE];     // Also holds the whole input while it is 240 bytes or less
+        uint64 _seed;
+        uint64 _totalSize;
+        std::size_t _bufferSize;
+        std::size_t _stripesSoFar;      // Stripes accumulated since the last scramble
+    };
+}
+
+#endif // _WARHEAD_XXHASH_H_
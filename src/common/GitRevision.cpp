@@ -16,6 +16,7 @@
  */
 
 #include "GitRevision.h"
+#include "CpuInfo.h"
 #include "revision_data.h"
 
 char const* GitRevision::GetHash()
@@ -77,10 +78,47 @@ char const* GitRevision::GetMySQLExecutable()
 #  define WH_LINKAGE_TYPE_STR "Dynamic"
 #endif
 
+#ifdef WH_WITH_LTO
+#  define WH_LTO_STR ", LTO"
+#else
+#  define WH_LTO_STR ""
+#endif
+
+#if defined(WH_WITH_PGO_USE)
+#  define WH_PGO_STR ", PGO"
+#elif defined(WH_WITH_PGO_GENERATE)
+#  define WH_PGO_STR ", PGO instrumented"
+#else
+#  define WH_PGO_STR ""
+#endif
+
+#ifdef WH_WITH_NATIVE_ARCH
+#  define WH_NATIVE_ARCH_STR ", Native arch"
+#else
+#  define WH_NATIVE_ARCH_STR ""
+#endif
+
+#if defined(WH_WITH_BUILTIN_ALLOCATOR) && defined(WH_WITH_ALLOCATION_STATS)
+#  define WH_ALLOCATOR_STR ", Builtin allocator with stats"
+#elif defined(WH_WITH_BUILTIN_ALLOCATOR)
+#  define WH_ALLOCATOR_STR ", Builtin allocator"
+#elif defined(WH_WITH_ALLOCATION_STATS)
+#  define WH_ALLOCATOR_STR ", Allocation stats"
+#else
+#  define WH_ALLOCATOR_STR ""
+#endif
+
 char const* GitRevision::GetFullVersion()
 {
   return "WarheadConsole rev. " VER_PRODUCTVERSION_STR
-    " (" WH_PLATFORM_STR ", " _BUILD_DIRECTIVE ", " WH_LINKAGE_TYPE_STR ")";
+    " (" WH_PLATFORM_STR ", " _BUILD_DIRECTIVE ", " WH_LINKAGE_TYPE_STR WH_LTO_STR WH_PGO_STR WH_NATIVE_ARCH_STR WH_ALLOCATOR_STR ")";
+}
+
+char const* GitRevision::GetCpuInfo()
+{
+  // Build options tell what the binary may use, this tells what the host offers
+  static std::string const cpuInfo = Warhead::Cpu::GetBrand() + " (" + Warhead::Cpu::GetFeaturesString() + ")";
+  return cpuInfo.c_str();
 }
 
 char const* GitRevision::GetCompanyNameStr()
@@ -33,6 +33,7 @@ namespace GitRevision
     WH_COMMON_API char const* GetMySQLExecutable();
     WH_COMMON_API char const* GetFullDatabase();
     WH_COMMON_API char const* GetFullVersion();
+    WH_COMMON_API char const* GetCpuInfo();
     WH_COMMON_API char const* GetCompanyNameStr();
     WH_COMMON_API char const* GetLegalCopyrightStr();
     WH_COMMON_API char const* GetFileVersionStr();
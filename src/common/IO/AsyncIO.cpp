@@ -0,0 +1,165 @@
+/*
+ * This file is part of the WarheadApp Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "AsyncIO.h"
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    constexpr uint32 IO_THREADS = 4;
+
+    /// Blocking requests on dedicated threads. I/O threads mostly wait on the disk,
+    /// so the pool size does not follow the core count.
+    class IOService
+    {
+    public:
+        static IOService& Instance()
+        {
+            static IOService instance;
+            return instance;
+        }
+
+        void Post(std::function<void()>&& task)
+        {
+            {
+                std::lock_guard<std::mutex> guard(_lock);
+                _tasks.emplace_back(std::move(task));
+            }
+
+            _condition.notify_one();
+        }
+
+        template<class Func>
+        auto Submit(Func&& func) -> std::future<decltype(func())>
+        {
+            auto task = std::make_shared<std::packaged_task<decltype(func())()>>(std::forward<Func>(func));
+            auto future = task->get_future();
+            Post([task]() { (*task)(); });
+            return future;
+        }
+
+    private:
+        IOService()
+        {
+            for (uint32 i = 0; i < IO_THREADS; ++i)
+                _workers.emplace_back(&IOService::Work, this);
+        }
+
+        ~IOService()
+        {
+            {
+                std::lock_guard<std::mutex> guard(_lock);
+                _stop = true;
+            }
+
+            _condition.notify_all();
+
+            for (auto& worker : _workers)
+                worker.join();
+        }
+
+        void Work()
+        {
+            for (;;)
+            {
+                std::function<void()> task;
+
+                {
+                    std::unique_lock<std::mutex> lock(_lock);
+                    _condition.wait(lock, [this]() { return _stop || !_tasks.empty(); });
+
+                    // Finish what was queued before shutting down
+                    if (_tasks.empty())
+                        return;
+
+                    task = std::move(_tasks.front());
+                    _tasks.pop_front();
+                }
+
+                task();
+            }
+        }
+
+        std::mutex _lock;
+        std::condition_variable _condition;
+        std::deque<std::function<void()>> _tasks;
+        std::vector<std::thread> _workers;
+        bool _stop = false;
+    };
+}
+
+std::optional<std::string> Warhead::IO::ReadFile(std::string const& path)
+{
+    FileHandle file;
+    if (!file.Open(path))
+        return std::nullopt;
+
+    std::optional<uint64> size = file.GetSize();
+    if (!size)
+        return std::nullopt;
+
+    std::string data;
+    data.resize(std::size_t(*size));
+
+    // The size is a hint, a file that shrank meanwhile is returned as read
+    std::size_t total = 0;
+    while (total < data.size())
+    {
+        int64 read = file.ReadAt(total, data.data() + total, data.size() - total);
+        if (read < 0)
+            return std::nullopt;
+
+        if (!read)
+            break;
+
+        total += std::size_t(read);
+    }
+
+    data.resize(total);
+    return data;
+}
+
+bool Warhead::IO::WriteFile(std::string const& path, std::string_view data)
+{
+    FileHandle file;
+    return file.Open(path, OpenMode::Write) && file.WriteExactAt(0, data.data(), data.size());
+}
+
+std::future<std::optional<std::string>> Warhead::IO::ReadFileAsync(std::string path)
+{
+    return IOService::Instance().Submit([path = std::move(path)]() { return ReadFile(path); });
+}
+
+void Warhead::IO::ReadFileAsync(std::string path, ReadCallback callback)
+{
+    IOService::Instance().Post([path = std::move(path), callback = std::move(callback)]() { callback(ReadFile(path)); });
+}
+
+std::future<bool> Warhead::IO::WriteFileAsync(std::string path, std::string data)
+{
+    return IOService::Instance().Submit([path = std::move(path), data = std::move(data)]() { return WriteFile(path, data); });
+}
+
+std::future<int64> Warhead::IO::ReadAsync(FileHandle const& file, uint64 offset, void* data, std::size_t size)
+{
+    return IOService::Instance().Submit([&file, offset, data, size]() { return file.ReadAt(offset, data, size); });
+}
@@ -0,0 +1,48 @@
+/*
+ * This file is part of the WarheadApp Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef _WARHEAD_ASYNC_IO_H_
+#define _WARHEAD_ASYNC_IO_H_
+
+#include "FileHandle.h"
+#include <functional>
+#include <future>
+#include <string_view>
+
+namespace Warhead::IO
+{
+    /// Whole file in one allocation, std::nullopt if it can't be opened or read
+    WH_COMMON_API std::optional<std::string> ReadFile(std::string const& path);
+
+    /// Creates or truncates the file
+    WH_COMMON_API bool WriteFile(std::string const& path, std::string_view data);
+
+    /// Requests below run on a small pool of I/O threads, so the caller can parse
+    /// or hash one buffer while the next ones are read.
+    /// Callbacks run on an I/O thread and must not block on other I/O requests.
+    using ReadCallback = std::function<void(std::optional<std::string>&& data)>;
+
+    WH_COMMON_API std::future<std::optional<std::string>> ReadFileAsync(std::string path);
+    WH_COMMON_API void ReadFileAsync(std::string path, ReadCallback callback);
+    WH_COMMON_API std::future<bool> WriteFileAsync(std::string path, std::string data);
+
+    /// Positional read, the file and the buffer must stay alive until the future is ready
+    WH_COMMON_API std::future<int64> ReadAsync(FileHandle const& file, uint64 offset, void* data, std::size_t size);
+}
+
+#endif // _WARHEAD_ASYNC_IO_H_
@@ -0,0 +1,233 @@
+/*
+ * This file is part of the WarheadApp Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "Copy.h"
+#include "AsyncIO.h"
+#include <algorithm>
+#include <istream>
+#include <memory>
+#include <ostream>
+
+#if WH_PLATFORM == WH_PLATFORM_WINDOWS
+#include <Poco/UnicodeConverter.h>
+#include <Windows.h>
+#elif defined(__linux__)
+#include <cerrno>
+#include <sys/sendfile.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    constexpr std::size_t COPY_BLOCK_SIZE = 1024 * 1024;
+
+    // Stream copies are often small ones, the buffer is allocated per call
+    constexpr std::size_t STREAM_BLOCK_SIZE = 64 * 1024;
+
+#if WH_PLATFORM != WH_PLATFORM_WINDOWS && defined(__linux__)
+    // Largest single kernel request, both calls stop at about 2 GiB anyway
+    constexpr std::size_t MAX_KERNEL_COPY = 1024 * 1024 * 1024;
+
+    // The file systems or the kernel can't do it, not an I/O error.
+    // EBADF is not one of them, a bad or wrongly opened handle fails the user space copy too.
+    bool IsUnsupported(int error)
+    {
+        return error == ENOSYS || error == EXDEV || error == EINVAL || error == EOPNOTSUPP;
+    }
+
+    /// Copies up to size bytes in the kernel, returns the bytes copied.
+    /// Stops early on end of file or if no kernel copy works for these files, error is set on real errors.
+    uint64 KernelCopy(int source, int destination, uint64 sourceOffset, uint64 destinationOffset, uint64 size, bool& error)
+    {
+        uint64 copied = 0;
+        bool useCopyRange = true;
+
+        while (copied < size)
+        {
+            std::size_t count = std::size_t(std::min<uint64>(size - copied, MAX_KERNEL_COPY));
+            ssize_t result;
+
+            if (useCopyRange)
+            {
+                loff_t sourcePosition = loff_t(sourceOffset + copied);
+                loff_t destinationPosition = loff_t(destinationOffset + copied);
+
+                result = ::copy_file_range(source, &sourcePosition, destination, &destinationPosition, count, 0);
+
+                if (result < 0 && IsUnsupported(errno))
+                {
+                    // Older kernels or different file systems, sendfile writes at the file position
+                    if (::lseek(destination, off_t(destinationOffset + copied), SEEK_SET) < 0)
+                        return copied;
+
+                    useCopyRange = false;
+                    continue;
+                }
+            }
+            else
+            {
+                off_t sourcePosition = off_t(sourceOffset + copied);
+                result = ::sendfile(destination, source, &sourcePosition, count);
+
+                if (result < 0 && IsUnsupported(errno))
+                    return copied;
+            }
+
+            if (result < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+
+                error = true;
+                return copied;
+            }
+
+            // The source got shorter meanwhile
+            if (!result)
+                return copied;
+
+            copied += uint64(result);
+        }
+
+        return copied;
+    }
+#endif
+}
+
+std::optional<uint64> Warhead::IO::Copy(FileHandle const& source, CopySink const& sink, uint64 offset /*= 0*/)
+{
+    std::optional<uint64> fileSize = source.GetSize();
+    std::unique_ptr<uint8[]> buffers[2] = { std::unique_ptr<uint8[]>(new uint8[COPY_BLOCK_SIZE]), std::unique_ptr<uint8[]>(new uint8[COPY_BLOCK_SIZE]) };
+
+    // Double buffered, the next block is read on the I/O threads while the sink takes this one
+    uint64 start = offset;
+    int64 size = source.ReadAt(offset, buffers[0].get(), COPY_BLOCK_SIZE);
+
+    for (std::size_t current = 0; size > 0; current ^= 1)
+    {
+        offset += uint64(size);
+
+        std::future<int64> next;
+        if (!fileSize || offset < *fileSize)
+            next = ReadAsync(source, offset, buffers[current ^ 1].get(), COPY_BLOCK_SIZE);
+
+        if (!sink(buffers[current].get(), std::size_t(size)))
+        {
+            // The buffer must outlive the read
+            if (next.valid())
+                next.wait();
+
+            return std::nullopt;
+        }
+
+        size = next.valid() ? next.get() : 0;
+    }
+
+    if (size < 0)
+        return std::nullopt;
+
+    return offset - start;
+}
+
+std::optional<uint64> Warhead::IO::Copy(FileHandle const& source, FileHandle const& destination, uint64 sourceOffset /*= 0*/, uint64 destinationOffset /*= 0*/)
+{
+    uint64 copied = 0;
+
+#if WH_PLATFORM != WH_PLATFORM_WINDOWS && defined(__linux__)
+    if (std::optional<uint64> size = source.GetSize(); size && *size > sourceOffset)
+    {
+        bool error = false;
+        copied = KernelCopy(source.GetNativeHandle(), destination.GetNativeHandle(), sourceOffset, destinationOffset, *size - sourceOffset, error);
+
+        if (error)
+            return std::nullopt;
+
+        if (copied == *size - sourceOffset)
+            return copied;
+    }
+#endif
+
+    // Whatever the kernel did not copy goes through user space
+    uint64 written = 0;
+
+    std::optional<uint64> rest = Copy(source, [&](void const* data, std::size_t size)
+    {
+        if (!destination.WriteExactAt(destinationOffset + copied + written, data, size))
+            return false;
+
+        written += size;
+        return true;
+    }, sourceOffset + copied);
+
+    if (!rest)
+        return std::nullopt;
+
+    return copied + *rest;
+}
+
+bool Warhead::IO::Copy(std::string const& source, std::string const& destination)
+{
+#if WH_PLATFORM == WH_PLATFORM_WINDOWS
+    std::wstring wideSource;
+    std::wstring wideDestination;
+    Poco::UnicodeConverter::toUTF16(source, wideSource);
+    Poco::UnicodeConverter::toUTF16(destination, wideDestination);
+
+    return CopyFileExW(wideSource.c_str(), wideDestination.c_str(), nullptr, nullptr, nullptr, 0) != FALSE;
+#else
+    FileHandle input;
+    FileHandle output;
+
+    if (!input.Open(source) || !output.Open(destination, OpenMode::Write))
+        return false;
+
+    return Copy(input, output).has_value();
+#endif
+}
+
+std::streamsize Warhead::IO::Copy(std::istream& istr, std::ostream& ostr)
+{
+    std::streambuf* input = istr.rdbuf();
+    std::streambuf* output = ostr.rdbuf();
+
+    if (!input || !output)
+        return 0;
+
+    std::unique_ptr<char[]> buffer(new char[STREAM_BLOCK_SIZE]);
+    std::streamsize copied = 0;
+
+    for (;;)
+    {
+        std::streamsize read = input->sgetn(buffer.get(), std::streamsize(STREAM_BLOCK_SIZE));
+        if (read <= 0)
+            break;
+
+        std::streamsize written = output->sputn(buffer.get(), read);
+        copied += std::max<std::streamsize>(written, 0);
+
+        if (written != read)
+        {
+            ostr.setstate(std::ios::badbit);
+            return copied;
+        }
+    }
+
+    // Same state as the read loop of Poco::StreamCopier leaves behind
+    istr.setstate(std::ios::eofbit);
+    return copied;
+}
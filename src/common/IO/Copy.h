@@ -0,0 +1,53 @@
+/*
+ * This file is part of the WarheadApp Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef _WARHEAD_IO_COPY_H_
+#define _WARHEAD_IO_COPY_H_
+
+#include "FileHandle.h"
+#include <functional>
+#include <iosfwd>
+
+namespace Warhead::IO
+{
+    /// Receives the copied bytes in order, returns false to abort the copy
+    using CopySink = std::function<bool(void const* data, std::size_t size)>;
+
+    /// Copies source from sourceOffset to its end into destination at destinationOffset.
+    /// 1 MiB blocks are read on the I/O threads while the previous one is written.
+    /// Windows, the only platform the build supports, has no handle to handle copy call,
+    /// so this is what runs there; use the path overload for whole files.
+    /// A Linux build lets the kernel move the bytes first (copy_file_range, then sendfile,
+    /// which moves the destination's file position) and falls back to the blocks if the file systems refuse.
+    /// Returns the number of bytes copied, std::nullopt on error.
+    WH_COMMON_API std::optional<uint64> Copy(FileHandle const& source, FileHandle const& destination, uint64 sourceOffset = 0, uint64 destinationOffset = 0);
+
+    /// Hands source from offset to its end to the sink, double buffered like above.
+    /// Returns the number of bytes copied, std::nullopt on a read error or if the sink aborted.
+    WH_COMMON_API std::optional<uint64> Copy(FileHandle const& source, CopySink const& sink, uint64 offset = 0);
+
+    /// Creates or replaces destination. On Windows CopyFileExW copies inside the system cache.
+    WH_COMMON_API bool Copy(std::string const& source, std::string const& destination);
+
+    /// Replaces Poco::StreamCopier::copyStream. Large blocks go straight between the stream buffers,
+    /// which pass them on to the file without their own buffer where they can.
+    /// Returns the number of bytes copied, sets badbit on ostr if it stopped taking them.
+    WH_COMMON_API std::streamsize Copy(std::istream& istr, std::ostream& ostr);
+}
+
+#endif // _WARHEAD_IO_COPY_H_
@@ -0,0 +1,250 @@
+/*
+ * This file is part of the WarheadApp Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "FileHandle.h"
+#include <algorithm>
+#include <utility>
+
+#if WH_PLATFORM == WH_PLATFORM_WINDOWS
+#include <Poco/UnicodeConverter.h>
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    // Largest single request, Windows takes a DWORD size
+    constexpr std::size_t MAX_REQUEST_SIZE = 1024 * 1024 * 1024;
+
+#if WH_PLATFORM == WH_PLATFORM_WINDOWS
+    // A thread waits for one request at a time, its event is reused for all of them
+    HANDLE GetRequestEvent()
+    {
+        struct RequestEvent
+        {
+            RequestEvent() : Handle(CreateEventW(nullptr, TRUE, FALSE, nullptr)) { }
+            ~RequestEvent() { if (Handle) CloseHandle(Handle); }
+
+            HANDLE Handle;
+        };
+
+        thread_local RequestEvent event;
+        return event.Handle;
+    }
+
+    /// Issues the request on the overlapped handle and waits for it, -1 on error
+    template<class Function>
+    int64 WaitForRequest(HANDLE handle, uint64 offset, Function&& issue)
+    {
+        OVERLAPPED overlapped = {};
+        overlapped.Offset = DWORD(offset);
+        overlapped.OffsetHigh = DWORD(offset >> 32);
+        overlapped.hEvent = GetRequestEvent();
+
+        if (!overlapped.hEvent)
+            return -1;
+
+        DWORD transferred = 0;
+
+        if (!issue(&overlapped) && GetLastError() != ERROR_IO_PENDING)
+            return GetLastError() == ERROR_HANDLE_EOF ? 0 : -1;
+
+        if (!GetOverlappedResult(handle, &overlapped, &transferred, TRUE))
+            return GetLastError() == ERROR_HANDLE_EOF ? 0 : -1;
+
+        return int64(transferred);
+    }
+#endif
+}
+
+Warhead::IO::FileHandle::~FileHandle()
+{
+    Close();
+}
+
+Warhead::IO::FileHandle::FileHandle(FileHandle&& right) noexcept :
+    _handle(std::exchange(right._handle, FileHandle()._handle)) { }
+
+Warhead::IO::FileHandle& Warhead::IO::FileHandle::operator=(FileHandle&& right) noexcept
+{
+    if (this != &right)
+    {
+        Close();
+        _handle = std::exchange(right._handle, FileHandle()._handle);
+    }
+
+    return *this;
+}
+
+#if WH_PLATFORM == WH_PLATFORM_WINDOWS
+
+bool Warhead::IO::FileHandle::Open(std::string const& path, OpenMode mode /*= OpenMode::Read*/)
+{
+    Close();
+
+    std::wstring widePath;
+    Poco::UnicodeConverter::toUTF16(path, widePath);
+
+    DWORD access = GENERIC_READ;
+    DWORD creation = OPEN_EXISTING;
+
+    if (mode == OpenMode::Write)
+    {
+        access = GENERIC_WRITE;
+        creation = CREATE_ALWAYS;
+    }
+    else if (mode == OpenMode::ReadWrite)
+    {
+        access = GENERIC_READ | GENERIC_WRITE;
+        creation = OPEN_ALWAYS;
+    }
+
+    HANDLE handle = CreateFileW(widePath.c_str(), access, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr,
+        creation, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN | FILE_FLAG_OVERLAPPED, nullptr);
+
+    if (handle == INVALID_HANDLE_VALUE)
+        return false;
+
+    _handle = handle;
+    return true;
+}
+
+void Warhead::IO::FileHandle::Close()
+{
+    if (_handle)
+        CloseHandle(std::exchange(_handle, nullptr));
+}
+
+bool Warhead::IO::FileHandle::IsOpen() const
+{
+    return _handle != nullptr;
+}
+
+std::optional<uint64> Warhead::IO::FileHandle::GetSize() const
+{
+    LARGE_INTEGER size;
+    if (!_handle || !GetFileSizeEx(_handle, &size))
+        return std::nullopt;
+
+    return uint64(size.QuadPart);
+}
+
+int64 Warhead::IO::FileHandle::ReadAt(uint64 offset, void* data, std::size_t size) const
+{
+    // Opened for overlapped I/O, otherwise Windows serializes all requests on the handle
+    return WaitForRequest(_handle, offset, [&](OVERLAPPED* overlapped)
+    {
+        return ::ReadFile(_handle, data, DWORD(std::min(size, MAX_REQUEST_SIZE)), nullptr, overlapped);
+    });
+}
+
+int64 Warhead::IO::FileHandle::WriteAt(uint64 offset, void const* data, std::size_t size) const
+{
+    return WaitForRequest(_handle, offset, [&](OVERLAPPED* overlapped)
+    {
+        return ::WriteFile(_handle, data, DWORD(std::min(size, MAX_REQUEST_SIZE)), nullptr, overlapped);
+    });
+}
+
+#else
+
+bool Warhead::IO::FileHandle::Open(std::string const& path, OpenMode mode /*= OpenMode::Read*/)
+{
+    Close();
+
+    int flags = O_RDONLY;
+
+    if (mode == OpenMode::Write)
+        flags = O_WRONLY | O_CREAT | O_TRUNC;
+    else if (mode == OpenMode::ReadWrite)
+        flags = O_RDWR | O_CREAT;
+
+    _handle = ::open(path.c_str(), flags | O_CLOEXEC, 0644);
+    return _handle >= 0;
+}
+
+void Warhead::IO::FileHandle::Close()
+{
+    if (_handle >= 0)
+        ::close(std::exchange(_handle, -1));
+}
+
+bool Warhead::IO::FileHandle::IsOpen() const
+{
+    return _handle >= 0;
+}
+
+std::optional<uint64> Warhead::IO::FileHandle::GetSize() const
+{
+    struct stat info;
+    if (_handle < 0 || ::fstat(_handle, &info))
+        return std::nullopt;
+
+    return uint64(info.st_size);
+}
+
+int64 Warhead::IO::FileHandle::ReadAt(uint64 offset, void* data, std::size_t size) const
+{
+    return int64(::pread(_handle, data, std::min(size, MAX_REQUEST_SIZE), off_t(offset)));
+}
+
+int64 Warhead::IO::FileHandle::WriteAt(uint64 offset, void const* data, std::size_t size) const
+{
+    return int64(::pwrite(_handle, data, std::min(size, MAX_REQUEST_SIZE), off_t(offset)));
+}
+
+#endif
+
+bool Warhead::IO::FileHandle::ReadExactAt(uint64 offset, void* data, std::size_t size) const
+{
+    auto bytes = static_cast<uint8*>(data);
+
+    while (size)
+    {
+        int64 read = ReadAt(offset, bytes, size);
+        if (read <= 0)
+            return false;
+
+        bytes += read;
+        offset += uint64(read);
+        size -= std::size_t(read);
+    }
+
+    return true;
+}
+
+bool Warhead::IO::FileHandle::WriteExactAt(uint64 offset, void const* data, std::size_t size) const
+{
+    auto bytes = static_cast<uint8 const*>(data);
+
+    while (size)
+    {
+        int64 written = WriteAt(offset, bytes, size);
+        if (written <= 0)
+            return false;
+
+        bytes += written;
+        offset += uint64(written);
+        size -= std::size_t(written);
+    }
+
+    return true;
+}
@@ -0,0 +1,86 @@
+/*
+ * This file is part of the WarheadApp Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef _WARHEAD_FILE_HANDLE_H_
+#define _WARHEAD_FILE_HANDLE_H_
+
+#include "Define.h"
+#include <optional>
+#include <string>
+
+namespace Warhead::IO
+{
+    enum class OpenMode : uint8
+    {
+        Read,
+        Write,      // Create or truncate
+        ReadWrite   // Create if missing, keep contents
+    };
+
+    /// Owning OS file handle with positional reads and writes.
+    /// ReadAt and WriteAt don't share a file position, so one handle can be used from several threads at once.
+    /// On Windows the handle is opened for overlapped I/O and each call waits for its own request,
+    /// so requests of different threads are in flight together instead of being serialized.
+    class WH_COMMON_API FileHandle
+    {
+    public:
+        FileHandle() = default;
+        ~FileHandle();
+
+        FileHandle(FileHandle&& right) noexcept;
+        FileHandle& operator=(FileHandle&& right) noexcept;
+
+        FileHandle(FileHandle const&) = delete;
+        FileHandle& operator=(FileHandle const&) = delete;
+
+        bool Open(std::string const& path, OpenMode mode = OpenMode::Read);
+        void Close();
+
+        bool IsOpen() const;
+        std::optional<uint64> GetSize() const;
+
+        /// Returns the number of bytes read, 0 at end of file, -1 on error
+        int64 ReadAt(uint64 offset, void* data, std::size_t size) const;
+
+        /// Returns the number of bytes written, -1 on error
+        int64 WriteAt(uint64 offset, void const* data, std::size_t size) const;
+
+        /// Loops over short reads, false on error or if the file ends first
+        bool ReadExactAt(uint64 offset, void* data, std::size_t size) const;
+
+        /// Loops over short writes
+        bool WriteExactAt(uint64 offset, void const* data, std::size_t size) const;
+
+#if WH_PLATFORM == WH_PLATFORM_WINDOWS
+        /// HANDLE opened with FILE_FLAG_OVERLAPPED, null when closed
+        void* GetNativeHandle() const { return _handle; }
+#else
+        /// File descriptor, -1 when closed
+        int GetNativeHandle() const { return _handle; }
+#endif
+
+    private:
+#if WH_PLATFORM == WH_PLATFORM_WINDOWS
+        void* _handle = nullptr;
+#else
+        int _handle = -1;
+#endif
+    };
+}
+
+#endif // _WARHEAD_FILE_HANDLE_H_
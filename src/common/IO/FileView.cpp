@@ -0,0 +1,163 @@
+/*
+ * This file is part of the WarheadApp Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "FileView.h"
+#include "AsyncIO.h"
+#include <utility>
+
+#if WH_PLATFORM == WH_PLATFORM_WINDOWS
+#include <Poco/UnicodeConverter.h>
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    /// Maps the whole file read-only, nullptr on failure. The mapping outlives the file handle.
+    void* MapFile(std::string const& path, uint64 mapThreshold, std::size_t& size)
+    {
+#if WH_PLATFORM == WH_PLATFORM_WINDOWS
+        std::wstring widePath;
+        Poco::UnicodeConverter::toUTF16(path, widePath);
+
+        HANDLE file = CreateFileW(widePath.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr,
+            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+
+        if (file == INVALID_HANDLE_VALUE)
+            return nullptr;
+
+        LARGE_INTEGER fileSize;
+        void* view = nullptr;
+
+        if (GetFileSizeEx(file, &fileSize) && uint64(fileSize.QuadPart) >= mapThreshold && fileSize.QuadPart)
+        {
+            if (HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr))
+            {
+                view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+                CloseHandle(mapping);
+            }
+        }
+
+        CloseHandle(file);
+
+        if (view)
+            size = std::size_t(fileSize.QuadPart);
+
+        return view;
+#else
+        int file = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (file < 0)
+            return nullptr;
+
+        struct stat info;
+        void* view = nullptr;
+
+        if (!::fstat(file, &info) && uint64(info.st_size) >= mapThreshold && info.st_size)
+        {
+            view = ::mmap(nullptr, std::size_t(info.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+
+            if (view == MAP_FAILED)
+                view = nullptr;
+            else
+                ::madvise(view, std::size_t(info.st_size), MADV_SEQUENTIAL);
+        }
+
+        ::close(file);
+
+        if (view)
+            size = std::size_t(info.st_size);
+
+        return view;
+#endif
+    }
+
+    void UnmapFile(void* view, std::size_t size)
+    {
+#if WH_PLATFORM == WH_PLATFORM_WINDOWS
+        UnmapViewOfFile(view);
+#else
+        ::munmap(view, size);
+#endif
+    }
+}
+
+Warhead::IO::FileView::~FileView()
+{
+    Close();
+}
+
+Warhead::IO::FileView::FileView(FileView&& right) noexcept :
+    _buffer(std::move(right._buffer)), _mapping(std::exchange(right._mapping, nullptr)),
+    _size(std::exchange(right._size, 0)), _open(std::exchange(right._open, false)) { }
+
+Warhead::IO::FileView& Warhead::IO::FileView::operator=(FileView&& right) noexcept
+{
+    if (this != &right)
+    {
+        Close();
+        _buffer = std::move(right._buffer);
+        _mapping = std::exchange(right._mapping, nullptr);
+        _size = std::exchange(right._size, 0);
+        _open = std::exchange(right._open, false);
+    }
+
+    return *this;
+}
+
+bool Warhead::IO::FileView::Open(std::string const& path, uint64 mapThreshold /*= MAP_THRESHOLD*/)
+{
+    Close();
+
+    _mapping = MapFile(path, mapThreshold, _size);
+
+    // Small file or the mapping failed, a plain read still works
+    if (!_mapping)
+    {
+        std::optional<std::string> text = ReadFile(path);
+        if (!text)
+            return false;
+
+        _buffer = std::move(*text);
+        _size = _buffer.size();
+    }
+
+    _open = true;
+    return true;
+}
+
+void Warhead::IO::FileView::Close()
+{
+    if (_mapping)
+        UnmapFile(std::exchange(_mapping, nullptr), _size);
+
+    std::string().swap(_buffer);
+    _size = 0;
+    _open = false;
+}
+
+std::string_view Warhead::IO::FileView::GetText() const
+{
+    if (_mapping)
+        return { static_cast<char const*>(_mapping), _size };
+
+    return _buffer;
+}
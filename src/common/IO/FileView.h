@@ -0,0 +1,62 @@
+/*
+ * This file is part of the WarheadApp Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef _WARHEAD_FILE_VIEW_H_
+#define _WARHEAD_FILE_VIEW_H_
+
+#include "Define.h"
+#include <string>
+#include <string_view>
+
+namespace Warhead::IO
+{
+    /// Read-only contents of a whole file. Files of at least MAP_THRESHOLD bytes are memory mapped,
+    /// smaller ones are read into one exact size buffer, where a mapping would cost more than the copy.
+    /// The bytes are returned as stored, no newline conversion.
+    class WH_COMMON_API FileView
+    {
+    public:
+        static constexpr uint64 MAP_THRESHOLD = 1024 * 1024;
+
+        FileView() = default;
+        ~FileView();
+
+        FileView(FileView&& right) noexcept;
+        FileView& operator=(FileView&& right) noexcept;
+
+        FileView(FileView const&) = delete;
+        FileView& operator=(FileView const&) = delete;
+
+        bool Open(std::string const& path, uint64 mapThreshold = MAP_THRESHOLD);
+        void Close();
+
+        bool IsOpen() const { return _open; }
+        bool IsMapped() const { return _mapping != nullptr; }
+
+        std::string_view GetText() const;
+        std::size_t GetSize() const { return _size; }
+
+    private:
+        std::string _buffer;
+        void* _mapping = nullptr;
+        std::size_t _size = 0;
+        bool _open = false;
+    };
+}
+
+#endif // _WARHEAD_FILE_VIEW_H_
@@ -16,14 +16,18 @@
  */
 
 #include "Log.h"
+#include "Allocator.h"
 #include "Poco/WindowsConsoleChannel.h"
+#include "TimestampFormatter.h"
 #include "Util.h"
 #include <Poco/AutoPtr.h>
 #include <Poco/Exception.h>
+#include <Poco/Formatter.h>
 #include <Poco/FormattingChannel.h>
 #include <Poco/Logger.h>
-#include <Poco/PatternFormatter.h>
+#include <Poco/Message.h>
 #include <Poco/SplitterChannel.h>
+#include <atomic>
 #include <filesystem>
 #include <sstream>
 
@@ -32,6 +36,40 @@ using namespace Poco;
 namespace
 {
     LogLevel highestLogLevel;
+
+    // Logger::get() locks Poco's registry and searches its std::map on every message,
+    // the system logger is cached here. Set by InitSystemLogger(), reset by Clear().
+    // Constant initialized, so it is usable before and after the Log instance lives.
+    // With the cache Poco's logger map and LoggingRegistry are only searched on create,
+    // the fallback below and shutdown, which is why they stay on std::map.
+    std::atomic<Logger*> systemLogger{ nullptr };
+
+    Logger& GetSystemLogger()
+    {
+        if (Logger* logger = systemLogger.load(std::memory_order_acquire))
+            return *logger;
+
+        // Not created yet or already cleared, Poco finds or creates it under its own lock
+        return Logger::get("system");
+    }
+
+    // "%H:%M:%S %t" in local time, the time prefix is reused for all messages in the same second
+    class ConsoleFormatter : public Formatter
+    {
+    public:
+        void format(Message const& msg, std::string& text) override
+        {
+            thread_local Warhead::Time::TimestampFormatter timestamp("%H:%M:%S");
+
+            std::string_view time = timestamp.Format(msg.getTime().epochTime());
+            std::string const& message = msg.getText();
+
+            text.reserve(text.size() + time.size() + 1 + message.size());
+            text.append(time.data(), time.size());
+            text.push_back(' ');
+            text.append(message);
+        }
+    };
 }
 
 Log::Log()
@@ -53,6 +91,7 @@ Log* Log::instance()
 void Log::Clear()
 {
     // Clear all loggers
+    systemLogger.store(nullptr, std::memory_order_release);
     Logger::shutdown();
 }
 
@@ -69,7 +108,7 @@ void Log::InitSystemLogger()
     LogLevel level = LOG_LEVEL_DEBUG;
 
     // Start console channel
-    AutoPtr<PatternFormatter> _ConsolePattern(new PatternFormatter);
+    AutoPtr<ConsoleFormatter> _ConsolePattern(new ConsoleFormatter);
 
 #define LOG_CATCH \
         catch (const Poco::Exception& e) \
@@ -77,13 +116,6 @@ void Log::InitSystemLogger()
             printf("Log::InitSystemLogger - %s\n", e.displayText().c_str()); \
         } \
 
-    try
-    {
-        _ConsolePattern->setProperty("pattern", "%H:%M:%S %t");
-        _ConsolePattern->setProperty("times", "local");
-    }
-    LOG_CATCH
-
     AutoPtr<WindowsColorConsoleChannel> _ConsoleChannel(new WindowsColorConsoleChannel);
 
     try
@@ -101,7 +133,7 @@ void Log::InitSystemLogger()
 
     try
     {
-        Logger::create("system", new FormattingChannel(_ConsolePattern, _ConsoleChannel), level);
+        systemLogger.store(&Logger::create("system", new FormattingChannel(_ConsolePattern, _ConsoleChannel), level), std::memory_order_release);
     }
     LOG_CATCH
 
@@ -114,9 +146,7 @@ bool Log::ShouldLog(LogLevel const level) const
     if (level > highestLogLevel)
         return false;
 
-    Logger& logger = Logger::get("system");
-
-    LogLevel logLevel = LogLevel(logger.getLevel());
+    LogLevel logLevel = LogLevel(GetSystemLogger().getLevel());
     return logLevel != LOG_LEVEL_DISABLED && logLevel >= level;
 }
 
@@ -124,12 +154,15 @@ void Log::SetLogLevel(LogLevel const level)
 {
     highestLogLevel = level;
 
-    Logger::get("system").setLevel(level);
+    GetSystemLogger().setLevel(level);
 }
 
 void Log::outSys(LogLevel const level, std::string&& message)
 {
-    Logger& logger = Logger::get("system");
+    static Warhead::Memory::AllocationTag const allocationTag("Log");
+    Warhead::Memory::AllocationScope allocationScope(allocationTag);
+
+    Logger& logger = GetSystemLogger();
 
     try
     {
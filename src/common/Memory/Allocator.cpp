@@ -0,0 +1,751 @@
+/*
+ * This file is part of the WarheadApp Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "Allocator.h"
+#include "Arena.h"
+#include "StringFormat.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <thread>
+
+// Global operator new/delete are only replaced when one of the two is enabled
+#if defined(WH_WITH_BUILTIN_ALLOCATOR) || defined(WH_WITH_ALLOCATION_STATS)
+#  define WH_ALLOCATOR_HOOKS
+#endif
+
+using Warhead::Memory::AllocationTag;
+
+namespace
+{
+    // Constant initialized, so operator new can use it before any static constructor ran
+    class SpinLock
+    {
+    public:
+        void lock()
+        {
+            while (_locked.exchange(true, std::memory_order_acquire))
+                while (_locked.load(std::memory_order_relaxed))
+                    std::this_thread::yield();
+        }
+
+        void unlock() { _locked.store(false, std::memory_order_release); }
+
+    private:
+        std::atomic<bool> _locked{ false };
+    };
+
+    constexpr std::size_t TAG_NAME_SIZE = 32;
+
+    SpinLock _tagLock;
+    std::atomic<uint8> _tagCount{ 1 };
+    char _tagNames[AllocationTag::MAX_TAGS][TAG_NAME_SIZE] = { "untagged" };
+
+    thread_local uint8 _threadTag = 0;
+
+#ifdef WH_ALLOCATOR_HOOKS
+    // Every block starts with a header, 16 bytes keep the returned pointer aligned like malloc's
+    constexpr std::size_t HEADER_SIZE = 16;
+
+    struct BlockHeader
+    {
+        uint64 Size;        // Requested size
+        uint8 SizeClass;
+        uint8 Tag;
+    };
+
+    static_assert(sizeof(BlockHeader) <= HEADER_SIZE, "Block header too large");
+
+    // Blocks too large for a size class, or all blocks with the system allocator, come from malloc
+    constexpr uint8 LARGE_CLASS = 0xFF;
+
+#ifdef WH_WITH_BUILTIN_ALLOCATOR
+    // 16 byte steps up to 1 KiB, then powers of two up to 32 KiB. Class sizes include the header.
+    constexpr uint8 SMALL_CLASSES = 64;
+    constexpr uint8 SIZE_CLASS_COUNT = SMALL_CLASSES + 5;
+    constexpr std::size_t MAX_CLASS_SIZE = 32768;
+
+    constexpr std::size_t GetClassSize(uint8 sizeClass)
+    {
+        return sizeClass < SMALL_CLASSES ? (std::size_t(sizeClass) + 1) * 16 : std::size_t(2048) << (sizeClass - SMALL_CLASSES);
+    }
+
+    static_assert(GetClassSize(SIZE_CLASS_COUNT - 1) == MAX_CLASS_SIZE, "Size classes do not end at MAX_CLASS_SIZE");
+
+    uint8 GetSizeClass(std::size_t blockSize)
+    {
+        if (blockSize <= 1024)
+            return uint8((blockSize + 15) / 16 - 1);
+
+        uint8 sizeClass = SMALL_CLASSES;
+
+        while (GetClassSize(sizeClass) < blockSize)
+            ++sizeClass;
+
+        return sizeClass;
+    }
+
+    // Blocks moved between a thread cache and the central list at once, a cache holds up to two batches
+    constexpr uint32 GetBatchSize(uint8 sizeClass)
+    {
+        return uint32(std::clamp<std::size_t>(8192 / GetClassSize(sizeClass), 2, 32));
+    }
+
+    struct FreeBlock
+    {
+        FreeBlock* Next;
+    };
+
+    struct FreeList
+    {
+        FreeBlock* Head;
+        uint32 Count;
+    };
+
+    // Shared by all threads. Memory taken from the system stays here and is never given back.
+    struct CentralList
+    {
+        SpinLock Lock;
+        FreeBlock* Head = nullptr;
+    };
+
+    CentralList _central[SIZE_CLASS_COUNT];
+
+    void ReturnToCentral(uint8 sizeClass, FreeBlock* head, FreeBlock* tail)
+    {
+        CentralList& central = _central[sizeClass];
+        std::lock_guard<SpinLock> lock(central.Lock);
+        tail->Next = central.Head;
+        central.Head = head;
+    }
+
+    // Returns a chain of up to count blocks, carving a new span from the system when the class is empty
+    FreeBlock* FetchFromCentral(uint8 sizeClass, uint32 count, uint32& fetched)
+    {
+        CentralList& central = _central[sizeClass];
+
+        {
+            std::lock_guard<SpinLock> lock(central.Lock);
+
+            if (FreeBlock* head = central.Head)
+            {
+                FreeBlock* tail = head;
+                fetched = 1;
+
+                while (fetched < count && tail->Next)
+                {
+                    tail = tail->Next;
+                    ++fetched;
+                }
+
+                central.Head = tail->Next;
+                tail->Next = nullptr;
+                return head;
+            }
+        }
+
+        std::size_t classSize = GetClassSize(sizeClass);
+        std::size_t blocks = std::max<std::size_t>(65536 / classSize, 4);
+
+        char* span = static_cast<char*>(std::malloc(blocks * classSize));
+        if (!span)
+        {
+            fetched = 0;
+            return nullptr;
+        }
+
+        for (std::size_t i = 0; i < blocks; ++i)
+            reinterpret_cast<FreeBlock*>(span + i * classSize)->Next = i + 1 < blocks ? reinterpret_cast<FreeBlock*>(span + (i + 1) * classSize) : nullptr;
+
+        fetched = uint32(std::min<std::size_t>(count, blocks));
+
+        if (blocks > fetched)
+        {
+            FreeBlock* tail = reinterpret_cast<FreeBlock*>(span + (fetched - 1) * classSize);
+            FreeBlock* rest = tail->Next;
+            tail->Next = nullptr;
+
+            ReturnToCentral(sizeClass, rest, reinterpret_cast<FreeBlock*>(span + (blocks - 1) * classSize));
+        }
+
+        return reinterpret_cast<FreeBlock*>(span);
+    }
+#endif // WH_WITH_BUILTIN_ALLOCATOR
+
+#ifdef WH_WITH_ALLOCATION_STATS
+    // Written by the owning thread only, read by anyone taking a snapshot
+    struct ThreadCounters
+    {
+        std::atomic<uint64> Allocations;
+        std::atomic<uint64> Deallocations;
+        std::atomic<uint64> BytesAllocated;
+        std::atomic<uint64> BytesFreed;
+        std::atomic<int64> LiveBytes;
+        std::atomic<uint64> PeakLiveBytes;
+        std::atomic<uint64> TagAllocations[AllocationTag::MAX_TAGS];
+        std::atomic<uint64> TagBytes[AllocationTag::MAX_TAGS];
+        std::atomic<int64> TagLiveBytes[AllocationTag::MAX_TAGS];
+    };
+
+    // A plain load and store is enough for a counter with a single writer, shared counters need the atomic add
+    template<class T>
+    void Add(std::atomic<T>& counter, T value, bool shared)
+    {
+        if (shared)
+            counter.fetch_add(value, std::memory_order_relaxed);
+        else
+            counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+#endif // WH_WITH_ALLOCATION_STATS
+
+    enum class ThreadStatus : uint8
+    {
+        New,
+        Alive,
+        Exited
+    };
+
+    // Zero initialized per thread, no constructor runs
+    struct ThreadState
+    {
+#ifdef WH_WITH_BUILTIN_ALLOCATOR
+        FreeList Cache[SIZE_CLASS_COUNT];
+#endif
+#ifdef WH_WITH_ALLOCATION_STATS
+        ThreadCounters Counters;
+        ThreadState* Next;
+        uint32 Id;
+#endif
+        ThreadStatus Status;
+    };
+
+    thread_local ThreadState _threadState;
+
+#ifdef WH_WITH_ALLOCATION_STATS
+    SpinLock _registryLock;
+    ThreadState* _threads = nullptr;
+    uint32 _nextThreadId = 0;
+    uint32 _exitedThreads = 0;
+    uint64 _exitedPeakLiveBytes = 0;
+
+    // Folded in from exited threads, also counts allocations made after a thread released its state
+    ThreadCounters _exitedCounters;
+#endif
+
+    void ReleaseThreadState(ThreadState& state)
+    {
+#ifdef WH_WITH_BUILTIN_ALLOCATOR
+        for (uint8 sizeClass = 0; sizeClass < SIZE_CLASS_COUNT; ++sizeClass)
+        {
+            FreeList& list = state.Cache[sizeClass];
+            if (!list.Head)
+                continue;
+
+            FreeBlock* tail = list.Head;
+            while (tail->Next)
+                tail = tail->Next;
+
+            ReturnToCentral(sizeClass, list.Head, tail);
+            list.Head = nullptr;
+            list.Count = 0;
+        }
+#endif
+
+#ifdef WH_WITH_ALLOCATION_STATS
+        {
+            std::lock_guard<SpinLock> lock(_registryLock);
+
+            for (ThreadState** itr = &_threads; *itr; itr = &(*itr)->Next)
+            {
+                if (*itr == &state)
+                {
+                    *itr = state.Next;
+                    break;
+                }
+            }
+
+            ThreadCounters& counters = state.Counters;
+            _exitedCounters.Allocations.fetch_add(counters.Allocations.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            _exitedCounters.Deallocations.fetch_add(counters.Deallocations.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            _exitedCounters.BytesAllocated.fetch_add(counters.BytesAllocated.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            _exitedCounters.BytesFreed.fetch_add(counters.BytesFreed.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            _exitedCounters.LiveBytes.fetch_add(counters.LiveBytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+
+            for (uint8 tag = 0; tag < AllocationTag::MAX_TAGS; ++tag)
+            {
+                _exitedCounters.TagAllocations[tag].fetch_add(counters.TagAllocations[tag].load(std::memory_order_relaxed), std::memory_order_relaxed);
+                _exitedCounters.TagBytes[tag].fetch_add(counters.TagBytes[tag].load(std::memory_order_relaxed), std::memory_order_relaxed);
+                _exitedCounters.TagLiveBytes[tag].fetch_add(counters.TagLiveBytes[tag].load(std::memory_order_relaxed), std::memory_order_relaxed);
+            }
+
+            _exitedPeakLiveBytes = std::max(_exitedPeakLiveBytes, counters.PeakLiveBytes.load(std::memory_order_relaxed));
+            ++_exitedThreads;
+        }
+#endif
+
+        state.Status = ThreadStatus::Exited;
+    }
+
+    // Gives the thread cache back and retires the counters when the thread ends
+    struct ThreadExit
+    {
+        ~ThreadExit() { ReleaseThreadState(_threadState); }
+    };
+
+    thread_local ThreadExit _threadExit;
+
+    // Null once the thread released its state, later calls go straight to the shared structures
+    ThreadState* GetThreadState()
+    {
+        ThreadState& state = _threadState;
+
+        if (state.Status == ThreadStatus::Alive)
+            return &state;
+
+        if (state.Status == ThreadStatus::Exited)
+            return nullptr;
+
+        state.Status = ThreadStatus::Alive;
+
+        // First use registers the destructor for this thread
+        (void)&_threadExit;
+
+#ifdef WH_WITH_ALLOCATION_STATS
+        std::lock_guard<SpinLock> lock(_registryLock);
+        state.Id = ++_nextThreadId;
+        state.Next = _threads;
+        _threads = &state;
+#endif
+
+        return &state;
+    }
+
+#ifdef WH_WITH_ALLOCATION_STATS
+    void RecordAllocation(ThreadState* state, uint64 size, uint8 tag)
+    {
+        bool shared = !state;
+        ThreadCounters& counters = shared ? _exitedCounters : state->Counters;
+
+        Add<uint64>(counters.Allocations, 1, shared);
+        Add<uint64>(counters.BytesAllocated, size, shared);
+        Add<uint64>(counters.TagAllocations[tag], 1, shared);
+        Add<uint64>(counters.TagBytes[tag], size, shared);
+        Add<int64>(counters.TagLiveBytes[tag], int64(size), shared);
+        Add<int64>(counters.LiveBytes, int64(size), shared);
+
+        if (shared)
+            return;
+
+        int64 live = counters.LiveBytes.load(std::memory_order_relaxed);
+        if (live > 0 && uint64(live) > counters.PeakLiveBytes.load(std::memory_order_relaxed))
+            counters.PeakLiveBytes.store(uint64(live), std::memory_order_relaxed);
+    }
+
+    void RecordDeallocation(ThreadState* state, uint64 size, uint8 tag)
+    {
+        bool shared = !state;
+        ThreadCounters& counters = shared ? _exitedCounters : state->Counters;
+
+        Add<uint64>(counters.Deallocations, 1, shared);
+        Add<uint64>(counters.BytesFreed, size, shared);
+        Add<int64>(counters.TagLiveBytes[tag], -int64(size), shared);
+        Add<int64>(counters.LiveBytes, -int64(size), shared);
+    }
+#endif
+
+#ifdef WH_WITH_BUILTIN_ALLOCATOR
+    void* AllocateSmall(ThreadState* state, uint8 sizeClass)
+    {
+        uint32 fetched = 0;
+
+        if (!state)
+            return FetchFromCentral(sizeClass, 1, fetched);
+
+        FreeList& list = state->Cache[sizeClass];
+
+        if (!list.Head)
+        {
+            list.Head = FetchFromCentral(sizeClass, GetBatchSize(sizeClass), fetched);
+            list.Count = fetched;
+
+            if (!list.Head)
+                return nullptr;
+        }
+
+        FreeBlock* block = list.Head;
+        list.Head = block->Next;
+        --list.Count;
+        return block;
+    }
+
+    void DeallocateSmall(ThreadState* state, uint8 sizeClass, void* ptr)
+    {
+        FreeBlock* block = static_cast<FreeBlock*>(ptr);
+
+        if (!state)
+        {
+            ReturnToCentral(sizeClass, block, block);
+            return;
+        }
+
+        FreeList& list = state->Cache[sizeClass];
+        block->Next = list.Head;
+        list.Head = block;
+
+        uint32 batch = GetBatchSize(sizeClass);
+        if (++list.Count <= batch * 2)
+            return;
+
+        // Keep one batch, hand the other to the threads that need it
+        FreeBlock* head = list.Head;
+        FreeBlock* tail = head;
+
+        for (uint32 i = 1; i < batch; ++i)
+            tail = tail->Next;
+
+        list.Head = tail->Next;
+        list.Count -= batch;
+
+        ReturnToCentral(sizeClass, head, tail);
+    }
+#endif
+
+    void* Allocate(std::size_t size)
+    {
+        ThreadState* state = GetThreadState();
+        uint8 sizeClass = LARGE_CLASS;
+        void* block = nullptr;
+
+#ifdef WH_WITH_BUILTIN_ALLOCATOR
+        if (size <= MAX_CLASS_SIZE - HEADER_SIZE)
+        {
+            sizeClass = GetSizeClass(size + HEADER_SIZE);
+            block = AllocateSmall(state, sizeClass);
+        }
+#endif
+
+        if (sizeClass == LARGE_CLASS && size <= SIZE_MAX - HEADER_SIZE)
+            block = std::malloc(size + HEADER_SIZE);
+
+        if (!block)
+            return nullptr;
+
+        BlockHeader* header = static_cast<BlockHeader*>(block);
+        header->Size = size;
+        header->SizeClass = sizeClass;
+        header->Tag = _threadTag;
+
+#ifdef WH_WITH_ALLOCATION_STATS
+        RecordAllocation(state, size, header->Tag);
+#endif
+
+        return static_cast<char*>(block) + HEADER_SIZE;
+    }
+
+    void Deallocate(void* ptr)
+    {
+        if (!ptr)
+            return;
+
+        BlockHeader* header = reinterpret_cast<BlockHeader*>(static_cast<char*>(ptr) - HEADER_SIZE);
+        ThreadState* state = GetThreadState();
+
+#ifdef WH_WITH_ALLOCATION_STATS
+        RecordDeallocation(state, header->Size, header->Tag);
+#endif
+
+#ifdef WH_WITH_BUILTIN_ALLOCATOR
+        if (header->SizeClass != LARGE_CLASS)
+        {
+            DeallocateSmall(state, header->SizeClass, header);
+            return;
+        }
+#endif
+
+        std::free(header);
+    }
+
+    void* AllocateOrThrow(std::size_t size)
+    {
+        for (;;)
+        {
+            if (void* ptr = Allocate(size))
+                return ptr;
+
+            std::new_handler handler = std::get_new_handler();
+            if (!handler)
+                throw std::bad_alloc();
+
+            handler();
+        }
+    }
+
+    void* AllocateNoThrow(std::size_t size) noexcept
+    {
+        try
+        {
+            return AllocateOrThrow(size);
+        }
+        catch (...)
+        {
+            return nullptr;
+        }
+    }
+#endif // WH_ALLOCATOR_HOOKS
+
+#ifdef WH_WITH_ALLOCATION_STATS
+    struct ExitReport
+    {
+        ~ExitReport()
+        {
+            std::string report = Warhead::Memory::GetAllocationStats().ToString();
+            std::fprintf(stderr, "%s\n", report.c_str());
+        }
+    };
+
+    ExitReport _exitReport;
+#endif
+}
+
+std::string_view Warhead::Memory::GetAllocatorName()
+{
+#ifdef WH_WITH_BUILTIN_ALLOCATOR
+    return "builtin";
+#else
+    return "system";
+#endif
+}
+
+Warhead::Memory::AllocationStats Warhead::Memory::GetAllocationStats()
+{
+    AllocationStats stats;
+
+#ifdef WH_WITH_ALLOCATION_STATS
+    stats.Enabled = true;
+
+    // Registering takes the registry lock, so it must not happen while we hold it
+    GetThreadState();
+
+    // Nothing below may allocate while the registry is locked, reserve a few more in case threads start meanwhile
+    std::size_t threadCount = 0;
+
+    {
+        std::lock_guard<SpinLock> lock(_registryLock);
+        for (ThreadState* state = _threads; state; state = state->Next)
+            ++threadCount;
+    }
+
+    stats.Threads.reserve(threadCount + 16);
+
+    uint64 tagAllocations[AllocationTag::MAX_TAGS];
+    uint64 tagBytes[AllocationTag::MAX_TAGS];
+    int64 tagLiveBytes[AllocationTag::MAX_TAGS];
+
+    {
+        std::lock_guard<SpinLock> lock(_registryLock);
+
+        auto addCounters = [&](ThreadCounters const& counters)
+        {
+            stats.Allocations += counters.Allocations.load(std::memory_order_relaxed);
+            stats.Deallocations += counters.Deallocations.load(std::memory_order_relaxed);
+            stats.BytesAllocated += counters.BytesAllocated.load(std::memory_order_relaxed);
+            stats.BytesFreed += counters.BytesFreed.load(std::memory_order_relaxed);
+            stats.LiveBytes += counters.LiveBytes.load(std::memory_order_relaxed);
+            stats.PeakThreadLiveBytes = std::max(stats.PeakThreadLiveBytes, counters.PeakLiveBytes.load(std::memory_order_relaxed));
+
+            for (uint8 tag = 0; tag < AllocationTag::MAX_TAGS; ++tag)
+            {
+                tagAllocations[tag] += counters.TagAllocations[tag].load(std::memory_order_relaxed);
+                tagBytes[tag] += counters.TagBytes[tag].load(std::memory_order_relaxed);
+                tagLiveBytes[tag] += counters.TagLiveBytes[tag].load(std::memory_order_relaxed);
+            }
+        };
+
+        std::fill(std::begin(tagAllocations), std::end(tagAllocations), 0);
+        std::fill(std::begin(tagBytes), std::end(tagBytes), 0);
+        std::fill(std::begin(tagLiveBytes), std::end(tagLiveBytes), 0);
+
+        addCounters(_exitedCounters);
+        stats.PeakThreadLiveBytes = std::max(stats.PeakThreadLiveBytes, _exitedPeakLiveBytes);
+        stats.ExitedThreads = _exitedThreads;
+
+        for (ThreadState* state = _threads; state; state = state->Next)
+        {
+            ThreadCounters const& counters = state->Counters;
+            addCounters(counters);
+
+            // Totals stay complete even if the reserved list is full
+            if (stats.Threads.size() == stats.Threads.capacity())
+                continue;
+
+            ThreadAllocationStats& thread = stats.Threads.emplace_back();
+            thread.ThreadId = state->Id;
+            thread.Allocations = counters.Allocations.load(std::memory_order_relaxed);
+            thread.Deallocations = counters.Deallocations.load(std::memory_order_relaxed);
+            thread.BytesAllocated = counters.BytesAllocated.load(std::memory_order_relaxed);
+            thread.LiveBytes = counters.LiveBytes.load(std::memory_order_relaxed);
+            thread.PeakLiveBytes = counters.PeakLiveBytes.load(std::memory_order_relaxed);
+        }
+    }
+
+    std::sort(stats.Threads.begin(), stats.Threads.end(), [](ThreadAllocationStats const& left, ThreadAllocationStats const& right)
+    {
+        return left.ThreadId < right.ThreadId;
+    });
+
+    uint8 tagCount = _tagCount.load(std::memory_order_acquire);
+    stats.Tags.reserve(tagCount);
+
+    for (uint8 tag = 0; tag < tagCount; ++tag)
+    {
+        TagAllocationStats& tagStats = stats.Tags.emplace_back();
+        tagStats.Name = _tagNames[tag];
+        tagStats.Allocations = tagAllocations[tag];
+        tagStats.BytesAllocated = tagBytes[tag];
+        tagStats.LiveBytes = tagLiveBytes[tag];
+    }
+#endif
+
+    return stats;
+}
+
+std::string Warhead::Memory::AllocationStats::ToString() const
+{
+    std::string allocator(GetAllocatorName());
+
+    if (!Enabled)
+        return Warhead::StringFormat("Allocator: %s, allocation stats disabled", allocator.c_str());
+
+    std::string result = Warhead::StringFormat("Allocator: %s, allocations: " UI64FMTD " frees: " UI64FMTD " allocated: " UI64FMTD " bytes freed: " UI64FMTD " bytes live: " SI64FMTD " bytes thread peak: " UI64FMTD " bytes exited threads: %u",
+        allocator.c_str(), Allocations, Deallocations, BytesAllocated, BytesFreed, LiveBytes, PeakThreadLiveBytes, ExitedThreads);
+
+    // Lines are formatted into the stack buffer, only the result is allocated
+    char buffer[512];
+    Warhead::Arena arena(buffer, sizeof(buffer));
+
+    for (TagAllocationStats const& tag : Tags)
+    {
+        Warhead::ArenaScope scope(arena);
+        result += Warhead::StringFormat(arena, "\n  tag %s: allocations: " UI64FMTD " allocated: " UI64FMTD " bytes live: " SI64FMTD " bytes",
+            tag.Name.c_str(), tag.Allocations, tag.BytesAllocated, tag.LiveBytes);
+    }
+
+    for (ThreadAllocationStats const& thread : Threads)
+    {
+        Warhead::ArenaScope scope(arena);
+        result += Warhead::StringFormat(arena, "\n  thread %u: allocations: " UI64FMTD " frees: " UI64FMTD " allocated: " UI64FMTD " bytes live: " SI64FMTD " bytes peak: " UI64FMTD " bytes",
+            thread.ThreadId, thread.Allocations, thread.Deallocations, thread.BytesAllocated, thread.LiveBytes, thread.PeakLiveBytes);
+    }
+
+    return result;
+}
+
+Warhead::Memory::AllocationTag::AllocationTag(std::string_view name) : _id(0)
+{
+    std::lock_guard<SpinLock> lock(_tagLock);
+    uint8 count = _tagCount.load(std::memory_order_relaxed);
+
+    name = name.substr(0, TAG_NAME_SIZE - 1);
+
+    for (uint8 i = 0; i < count; ++i)
+    {
+        if (name == _tagNames[i])
+        {
+            _id = i;
+            return;
+        }
+    }
+
+    if (count == MAX_TAGS)
+        return;
+
+    std::memcpy(_tagNames[count], name.data(), name.size());
+    _tagNames[count][name.size()] = '\0';
+
+    _tagCount.store(count + 1, std::memory_order_release);
+    _id = count;
+}
+
+Warhead::Memory::AllocationScope::AllocationScope(AllocationTag const& tag) : _previous(_threadTag)
+{
+    _threadTag = tag.GetId();
+}
+
+Warhead::Memory::AllocationScope::~AllocationScope()
+{
+    _threadTag = _previous;
+}
+
+#ifdef WH_ALLOCATOR_HOOKS
+// Replacements for the global operators. They are only picked up when common is linked statically,
+// a DLL would replace them for itself only, see WITH_ALLOCATOR in src/common/CMakeLists.txt.
+// The aligned overloads are left to the runtime, they pair with their own delete.
+void* operator new(std::size_t size)
+{
+    return AllocateOrThrow(size);
+}
+
+void* operator new[](std::size_t size)
+{
+    return AllocateOrThrow(size);
+}
+
+void* operator new(std::size_t size, std::nothrow_t const&) noexcept
+{
+    return AllocateNoThrow(size);
+}
+
+void* operator new[](std::size_t size, std::nothrow_t const&) noexcept
+{
+    return AllocateNoThrow(size);
+}
+
+void operator delete(void* ptr) noexcept
+{
+    Deallocate(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+    Deallocate(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    Deallocate(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept
+{
+    Deallocate(ptr);
+}
+
+void operator delete(void* ptr, std::nothrow_t const&) noexcept
+{
+    Deallocate(ptr);
+}
+
+void operator delete[](void* ptr, std::nothrow_t const&) noexcept
+{
+    Deallocate(ptr);
+}
+#endif
@@ -0,0 +1,107 @@
+/*
+ * This file is part of the WarheadApp Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef _WARHEAD_ALLOCATOR_H_
+#define _WARHEAD_ALLOCATOR_H_
+
+#include "Define.h"
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Warhead::Memory
+{
+    struct ThreadAllocationStats
+    {
+        uint32 ThreadId = 0;
+        uint64 Allocations = 0;
+        uint64 Deallocations = 0;
+        uint64 BytesAllocated = 0;
+        int64 LiveBytes = 0;        // Negative when the thread frees more than it allocated
+        uint64 PeakLiveBytes = 0;
+    };
+
+    struct TagAllocationStats
+    {
+        std::string Name;
+        uint64 Allocations = 0;
+        uint64 BytesAllocated = 0;
+        int64 LiveBytes = 0;
+    };
+
+    struct WH_COMMON_API AllocationStats
+    {
+        bool Enabled = false;
+        uint64 Allocations = 0;
+        uint64 Deallocations = 0;
+        uint64 BytesAllocated = 0;
+        uint64 BytesFreed = 0;
+        int64 LiveBytes = 0;
+
+        /// Highest peak of any thread, exited threads included
+        uint64 PeakThreadLiveBytes = 0;
+        uint32 ExitedThreads = 0;
+
+        std::vector<ThreadAllocationStats> Threads; // Running threads only
+        std::vector<TagAllocationStats> Tags;
+
+        /// Multi line report, totals first, then one line per tag and per thread
+        std::string ToString() const;
+    };
+
+    /// "builtin" or "system", see WITH_ALLOCATOR
+    WH_COMMON_API std::string_view GetAllocatorName();
+
+    /// Snapshot of the counters, Enabled is false unless built with WITH_ALLOCATION_STATS.
+    /// The report is also written to stderr at exit.
+    WH_COMMON_API AllocationStats GetAllocationStats();
+
+    /// Subsystem allocations are counted under. Register once and keep it:
+    ///
+    /// static Warhead::Memory::AllocationTag const configTag("Config");
+    /// Warhead::Memory::AllocationScope scope(configTag);
+    class WH_COMMON_API AllocationTag
+    {
+    public:
+        static constexpr uint8 MAX_TAGS = 32;
+
+        /// Same name gives the same tag, tags past MAX_TAGS fall back to "untagged"
+        explicit AllocationTag(std::string_view name);
+
+        uint8 GetId() const { return _id; }
+
+    private:
+        uint8 _id;
+    };
+
+    /// Counts allocations made by this thread under the tag until the scope ends. Scopes nest.
+    class WH_COMMON_API AllocationScope
+    {
+    public:
+        explicit AllocationScope(AllocationTag const& tag);
+        ~AllocationScope();
+
+        AllocationScope(AllocationScope const&) = delete;
+        AllocationScope& operator=(AllocationScope const&) = delete;
+
+    private:
+        uint8 _previous;
+    };
+}
+
+#endif // _WARHEAD_ALLOCATOR_H_
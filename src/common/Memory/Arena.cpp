@@ -0,0 +1,136 @@
+/*
+ * This file is part of the WarheadApp Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "Arena.h"
+#include <algorithm>
+#include <cstring>
+#include <new>
+
+struct alignas(std::max_align_t) Warhead::Arena::Chunk
+{
+    Chunk* Previous;
+    std::size_t Size; // Usable bytes after the header
+
+    char* GetData() { return reinterpret_cast<char*>(this + 1); }
+};
+
+void* Warhead::ArenaResource::do_allocate(std::size_t bytes, std::size_t alignment)
+{
+    return _arena.Allocate(std::max<std::size_t>(bytes, 1), alignment);
+}
+
+void Warhead::ArenaResource::do_deallocate(void* ptr, std::size_t bytes, std::size_t /*alignment*/)
+{
+    _arena.Deallocate(ptr, std::max<std::size_t>(bytes, 1));
+}
+
+Warhead::Arena::Arena(std::size_t chunkSize /*= DEFAULT_CHUNK_SIZE*/) :
+    _nextChunkSize(std::clamp<std::size_t>(chunkSize, 256, MAX_CHUNK_SIZE)) { }
+
+Warhead::Arena::Arena(void* buffer, std::size_t size, std::size_t chunkSize /*= DEFAULT_CHUNK_SIZE*/) :
+    _current(static_cast<char*>(buffer)),
+    _end(static_cast<char*>(buffer) + size),
+    _buffer(static_cast<char*>(buffer)),
+    _bufferSize(size),
+    // The first chunk should hold more than the buffer did
+    _nextChunkSize(std::clamp<std::size_t>(std::max(chunkSize, size * 2), 256, MAX_CHUNK_SIZE)) { }
+
+Warhead::Arena::~Arena()
+{
+    while (Chunk* chunk = _chunks)
+    {
+        _chunks = chunk->Previous;
+        ::operator delete(chunk);
+    }
+
+    ::operator delete(_spare);
+}
+
+void* Warhead::Arena::AllocateSlow(std::size_t size, std::size_t alignment)
+{
+    if (!size)
+        return Allocate(1, alignment);
+
+    // Worst case padding of the chunk data, which is only aligned to max_align_t
+    std::size_t needed = size + (alignment > alignof(Chunk) ? alignment - 1 : 0);
+    Chunk* chunk;
+
+    if (_spare && _spare->Size >= needed)
+    {
+        chunk = _spare;
+        _spare = nullptr;
+    }
+    else
+    {
+        std::size_t chunkSize = std::max(_nextChunkSize, needed);
+        _nextChunkSize = std::min(_nextChunkSize * 2, MAX_CHUNK_SIZE);
+
+        chunk = static_cast<Chunk*>(::operator new(sizeof(Chunk) + chunkSize));
+        chunk->Size = chunkSize;
+        _chunkBytes += sizeof(Chunk) + chunkSize;
+    }
+
+    chunk->Previous = _chunks;
+    _chunks = chunk;
+    _current = chunk->GetData();
+    _end = _current + chunk->Size;
+
+    return Allocate(size, alignment);
+}
+
+void Warhead::Arena::Recycle(Chunk* chunk)
+{
+    // Only the largest one is kept, the others were outgrown
+    if (_spare && _spare->Size >= chunk->Size)
+        std::swap(_spare, chunk);
+
+    if (_spare)
+    {
+        _chunkBytes -= sizeof(Chunk) + _spare->Size;
+        ::operator delete(_spare);
+    }
+
+    _spare = chunk;
+}
+
+void Warhead::Arena::Rewind(Marker const& marker)
+{
+    while (_chunks != marker.Chunk)
+    {
+        Chunk* chunk = _chunks;
+        _chunks = chunk->Previous;
+        Recycle(chunk);
+    }
+
+    _current = marker.Current;
+
+    if (_chunks)
+        _end = _chunks->GetData() + _chunks->Size;
+    else
+        _end = _buffer + _bufferSize;
+}
+
+std::string_view Warhead::Arena::CopyString(std::string_view str)
+{
+    if (str.empty())
+        return {};
+
+    char* data = static_cast<char*>(Allocate(str.size(), 1));
+    std::memcpy(data, str.data(), str.size());
+    return { data, str.size() };
+}
@@ -0,0 +1,153 @@
+/*
+ * This file is part of the WarheadApp Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef _WARHEAD_ARENA_H_
+#define _WARHEAD_ARENA_H_
+
+#include "Define.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <string_view>
+
+namespace Warhead
+{
+    class Arena;
+
+    /// std::pmr view of an Arena, for std::pmr::vector, std::pmr::string and friends.
+    /// deallocate() only gives memory back if it was the last allocation, vectors growing at the top reuse it.
+    class WH_COMMON_API ArenaResource final : public std::pmr::memory_resource
+    {
+    public:
+        explicit ArenaResource(Arena& arena) : _arena(arena) { }
+
+    private:
+        void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+        void do_deallocate(void* ptr, std::size_t bytes, std::size_t alignment) override;
+        bool do_is_equal(std::pmr::memory_resource const& other) const noexcept override { return this == &other; }
+
+        Arena& _arena;
+    };
+
+    /// Bump allocator for short lived work. Allocating moves a pointer, there is no per allocation free:
+    /// everything goes at once with Reset(), or back to a marker with Rewind() / ArenaScope.
+    /// Chunks are chained and double in size up to MAX_CHUNK_SIZE. The largest chunk given back
+    /// is kept for the next round, so an arena reset in a loop stops allocating after the first pass.
+    ///
+    /// Destructors of objects in the arena are not called. Not thread safe, use one arena per thread.
+    class WH_COMMON_API Arena
+    {
+    public:
+        static constexpr std::size_t DEFAULT_CHUNK_SIZE = 4096;
+        static constexpr std::size_t MAX_CHUNK_SIZE = 1024 * 1024;
+
+        /// Position to Rewind() to
+        struct Marker
+        {
+            void* Chunk = nullptr;
+            char* Current = nullptr;
+        };
+
+        explicit Arena(std::size_t chunkSize = DEFAULT_CHUNK_SIZE);
+
+        /// Uses the buffer (usually on the stack) first, chunks are only allocated once it is full
+        Arena(void* buffer, std::size_t size, std::size_t chunkSize = DEFAULT_CHUNK_SIZE);
+
+        ~Arena();
+
+        Arena(Arena const&) = delete;
+        Arena& operator=(Arena const&) = delete;
+
+        /// alignment must be a power of two
+        void* Allocate(std::size_t size, std::size_t alignment = alignof(std::max_align_t))
+        {
+            std::uintptr_t aligned = (reinterpret_cast<std::uintptr_t>(_current) + alignment - 1) & ~std::uintptr_t(alignment - 1);
+
+            if (aligned > reinterpret_cast<std::uintptr_t>(_end) || size > reinterpret_cast<std::uintptr_t>(_end) - aligned || !size)
+                return AllocateSlow(size, alignment);
+
+            _current = reinterpret_cast<char*>(aligned + size);
+            return reinterpret_cast<void*>(aligned);
+        }
+
+        /// Gives the memory back if it is the last allocation, otherwise it stays until Reset() or Rewind()
+        void Deallocate(void* ptr, std::size_t size)
+        {
+            if (static_cast<char*>(ptr) + size == _current)
+                _current = static_cast<char*>(ptr);
+        }
+
+        template<class T>
+        T* AllocateArray(std::size_t count)
+        {
+            return static_cast<T*>(Allocate(sizeof(T) * count, alignof(T)));
+        }
+
+        /// Copy of the string in the arena, not null terminated
+        std::string_view CopyString(std::string_view str);
+
+        Marker GetMarker() const { return { _chunks, _current }; }
+
+        /// Frees everything allocated after the marker was taken
+        void Rewind(Marker const& marker);
+
+        /// Frees everything, O(number of chunks)
+        void Reset() { Rewind({ nullptr, _buffer }); }
+
+        std::pmr::memory_resource* GetResource() { return &_resource; }
+
+        /// Bytes of heap memory held in chunks, the initial buffer not included
+        std::size_t GetChunkBytes() const { return _chunkBytes; }
+
+    private:
+        struct Chunk;
+
+        void* AllocateSlow(std::size_t size, std::size_t alignment);
+        void Recycle(Chunk* chunk);
+
+        Chunk* _chunks = nullptr; // Newest first
+        Chunk* _spare = nullptr;
+        char* _current = nullptr;
+        char* _end = nullptr;
+
+        char* _buffer = nullptr;
+        std::size_t _bufferSize = 0;
+
+        std::size_t _nextChunkSize;
+        std::size_t _chunkBytes = 0;
+
+        ArenaResource _resource{ *this };
+    };
+
+    /// Rewinds the arena when the scope ends, whatever was allocated inside it is freed at once
+    class ArenaScope
+    {
+    public:
+        explicit ArenaScope(Arena& arena) : _arena(arena), _marker(arena.GetMarker()) { }
+        ~ArenaScope() { _arena.Rewind(_marker); }
+
+        ArenaScope(ArenaScope const&) = delete;
+        ArenaScope& operator=(ArenaScope const&) = delete;
+
+    private:
+        Arena& _arena;
+        Arena::Marker _marker;
+    };
+}
+
+#endif // _WARHEAD_ARENA_H_
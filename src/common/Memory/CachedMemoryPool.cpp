@@ -0,0 +1,225 @@
+/*
+ * This file is part of the WarheadApp Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "CachedMemoryPool.h"
+#include <Poco/Exception.h>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+namespace
+{
+    std::atomic<uint64> _nextId{ 1 };
+}
+
+struct Warhead::Memory::ThreadMagazines::Shared
+{
+    std::mutex Lock;
+    bool Alive = true;
+
+    uint64 Id;
+    uint32 Size;
+    RefillFunction Refill;
+    FlushFunction Flush;
+
+    std::vector<Magazine*> Magazines;
+};
+
+struct Warhead::Memory::ThreadMagazines::Magazine
+{
+    std::shared_ptr<Shared> Owner;
+    std::unique_ptr<void*[]> Blocks;
+
+    // Only written by the owning thread, atomic so GetCachedCount() may read it
+    std::atomic<uint32> Count{ 0 };
+
+    /// Moves the newest count blocks to the pool, the caller holds the lock
+    void FlushLocked(uint32 count)
+    {
+        uint32 remaining = Count.load(std::memory_order_relaxed) - count;
+        Owner->Flush(Blocks.get() + remaining, count);
+        Count.store(remaining, std::memory_order_relaxed);
+    }
+};
+
+/// The magazines of one thread, one per pool it used
+struct Warhead::Memory::ThreadMagazines::ThreadState
+{
+    ~ThreadState()
+    {
+        // Give the blocks back to pools that still exist
+        for (auto& magazine : Magazines)
+        {
+            Shared& owner = *magazine->Owner;
+            std::lock_guard<std::mutex> guard(owner.Lock);
+
+            if (!owner.Alive)
+                continue;
+
+            if (uint32 count = magazine->Count.load(std::memory_order_relaxed))
+                magazine->FlushLocked(count);
+
+            owner.Magazines.erase(std::find(owner.Magazines.begin(), owner.Magazines.end(), magazine.get()));
+        }
+    }
+
+    std::vector<std::unique_ptr<Magazine>> Magazines;
+
+    // Last used, most threads only touch one pool at a time
+    uint64 LastId = 0;
+    Magazine* Last = nullptr;
+};
+
+Warhead::Memory::ThreadMagazines::ThreadMagazines(uint32 magazineSize, RefillFunction refill, FlushFunction flush) :
+    _shared(std::make_shared<Shared>())
+{
+    _shared->Id = _nextId.fetch_add(1, std::memory_order_relaxed);
+    _shared->Size = std::max<uint32>(magazineSize, 2);
+    _shared->Refill = std::move(refill);
+    _shared->Flush = std::move(flush);
+}
+
+Warhead::Memory::ThreadMagazines::~ThreadMagazines()
+{
+    std::lock_guard<std::mutex> guard(_shared->Lock);
+
+    // Poco::MemoryPool only frees the blocks it has back
+    for (Magazine* magazine : _shared->Magazines)
+        if (uint32 count = magazine->Count.load(std::memory_order_relaxed))
+            magazine->FlushLocked(count);
+
+    _shared->Magazines.clear();
+    _shared->Alive = false;
+}
+
+Warhead::Memory::ThreadMagazines::Magazine& Warhead::Memory::ThreadMagazines::GetMagazine()
+{
+    thread_local ThreadState state;
+
+    if (state.LastId == _shared->Id)
+        return *state.Last;
+
+    auto itr = std::find_if(state.Magazines.begin(), state.Magazines.end(), [this](auto const& magazine) { return magazine->Owner == _shared; });
+
+    if (itr == state.Magazines.end())
+    {
+        // Drop the magazines of destroyed pools, their blocks went away with the pool
+        state.Magazines.erase(std::remove_if(state.Magazines.begin(), state.Magazines.end(), [](auto const& magazine)
+        {
+            std::lock_guard<std::mutex> guard(magazine->Owner->Lock);
+            return !magazine->Owner->Alive;
+        }), state.Magazines.end());
+
+        auto magazine = std::make_unique<Magazine>();
+        magazine->Owner = _shared;
+        magazine->Blocks = std::make_unique<void*[]>(_shared->Size);
+
+        {
+            std::lock_guard<std::mutex> guard(_shared->Lock);
+            _shared->Magazines.push_back(magazine.get());
+        }
+
+        state.Magazines.emplace_back(std::move(magazine));
+        itr = state.Magazines.end() - 1;
+    }
+
+    state.LastId = _shared->Id;
+    state.Last = itr->get();
+    return *state.Last;
+}
+
+void* Warhead::Memory::ThreadMagazines::Get()
+{
+    Magazine& magazine = GetMagazine();
+    uint32 count = magazine.Count.load(std::memory_order_relaxed);
+
+    if (!count)
+    {
+        std::lock_guard<std::mutex> guard(_shared->Lock);
+        count = _shared->Refill(magazine.Blocks.get(), _shared->Size / 2);
+    }
+
+    magazine.Count.store(--count, std::memory_order_relaxed);
+    return magazine.Blocks[count];
+}
+
+void Warhead::Memory::ThreadMagazines::Release(void* block)
+{
+    Magazine& magazine = GetMagazine();
+
+    if (magazine.Count.load(std::memory_order_relaxed) == _shared->Size)
+    {
+        std::lock_guard<std::mutex> guard(_shared->Lock);
+        magazine.FlushLocked(_shared->Size / 2);
+    }
+
+    uint32 count = magazine.Count.load(std::memory_order_relaxed);
+    magazine.Blocks[count] = block;
+    magazine.Count.store(count + 1, std::memory_order_relaxed);
+}
+
+void Warhead::Memory::ThreadMagazines::Flush()
+{
+    Magazine& magazine = GetMagazine();
+
+    uint32 count = magazine.Count.load(std::memory_order_relaxed);
+    if (!count)
+        return;
+
+    std::lock_guard<std::mutex> guard(_shared->Lock);
+    magazine.FlushLocked(count);
+}
+
+uint32 Warhead::Memory::ThreadMagazines::GetCachedCount() const
+{
+    std::lock_guard<std::mutex> guard(_shared->Lock);
+
+    uint32 count = 0;
+    for (Magazine const* magazine : _shared->Magazines)
+        count += magazine->Count.load(std::memory_order_relaxed);
+
+    return count;
+}
+
+Warhead::Memory::CachedMemoryPool::CachedMemoryPool(std::size_t blockSize, int preAlloc /*= 0*/, int maxAlloc /*= 0*/, uint32 magazineSize /*= 32*/) :
+    _pool(blockSize, preAlloc, maxAlloc),
+    _magazines(magazineSize,
+        [this](void** blocks, uint32 count)
+        {
+            uint32 i = 0;
+
+            try
+            {
+                for (; i < count; ++i)
+                    blocks[i] = _pool.get();
+            }
+            catch (Poco::OutOfMemoryException const&)
+            {
+                // maxAlloc reached, a partial refill is fine
+                if (!i)
+                    throw;
+            }
+
+            return i;
+        },
+        [this](void* const* blocks, uint32 count)
+        {
+            for (uint32 i = 0; i < count; ++i)
+                _pool.release(blocks[i]);
+        }) { }
@@ -0,0 +1,156 @@
+/*
+ * This file is part of the WarheadApp Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef _WARHEAD_CACHED_MEMORY_POOL_H_
+#define _WARHEAD_CACHED_MEMORY_POOL_H_
+
+#include "Define.h"
+#include <Poco/MemoryPool.h>
+#include <Poco/Mutex.h>
+#include <functional>
+#include <memory>
+#include <new>
+
+namespace Warhead::Memory
+{
+    /// Per thread magazines (small stacks of free blocks) in front of a shared pool.
+    /// Get() and Release() only touch the calling thread's magazine. An empty magazine is
+    /// refilled and a full one flushed by half its size at once, under the only lock.
+    ///
+    /// A block may be released on any thread, blocks of one pool are interchangeable:
+    /// it goes to the releasing thread's magazine and from there back to the shared pool,
+    /// so a thread that only frees hands blocks on to threads that only allocate in batches.
+    class WH_COMMON_API ThreadMagazines
+    {
+    public:
+        /// Called under the lock. Fills up to count blocks, returns how many, throws only if it got none.
+        using RefillFunction = std::function<uint32(void** blocks, uint32 count)>;
+        using FlushFunction = std::function<void(void* const* blocks, uint32 count)>;
+
+        ThreadMagazines(uint32 magazineSize, RefillFunction refill, FlushFunction flush);
+
+        /// Flushes the magazines of all threads, no thread may use the pool anymore
+        ~ThreadMagazines();
+
+        ThreadMagazines(ThreadMagazines const&) = delete;
+        ThreadMagazines& operator=(ThreadMagazines const&) = delete;
+
+        void* Get();
+        void Release(void* block);
+
+        /// Gives the calling thread's blocks back to the pool
+        void Flush();
+
+        /// Number of blocks held by all magazines, a snapshot
+        uint32 GetCachedCount() const;
+
+    private:
+        struct Shared;
+        struct Magazine;
+        struct ThreadState;
+
+        Magazine& GetMagazine();
+
+        std::shared_ptr<Shared> _shared;
+    };
+
+    /// Poco::MemoryPool with per thread magazines, same interface.
+    /// available() counts the blocks in the magazines as well.
+    class WH_COMMON_API CachedMemoryPool
+    {
+    public:
+        CachedMemoryPool(std::size_t blockSize, int preAlloc = 0, int maxAlloc = 0, uint32 magazineSize = 32);
+
+        CachedMemoryPool(CachedMemoryPool const&) = delete;
+        CachedMemoryPool& operator=(CachedMemoryPool const&) = delete;
+
+        /// Throws Poco::OutOfMemoryException if maxAlloc blocks are in use
+        void* get() { return _magazines.Get(); }
+        void release(void* ptr) { if (ptr) _magazines.Release(ptr); }
+
+        std::size_t blockSize() const { return _pool.blockSize(); }
+        int allocated() const { return _pool.allocated(); }
+        int available() const { return _pool.available() + int(_magazines.GetCachedCount()); }
+
+    private:
+        Poco::MemoryPool _pool;
+        ThreadMagazines _magazines;
+    };
+
+    /// Poco::FastMemoryPool with per thread magazines, same interface. The underlying pool runs
+    /// with Poco::NullMutex, the magazines' lock already serializes every access to it.
+    template<class T>
+    class CachedFastMemoryPool
+    {
+    public:
+        CachedFastMemoryPool(std::size_t blocksPerBucket = POCO_FAST_MEMORY_POOL_PREALLOC, std::size_t bucketPreAlloc = 10, std::size_t maxAlloc = 0, uint32 magazineSize = 32) :
+            _pool(blocksPerBucket, bucketPreAlloc, maxAlloc),
+            _magazines(magazineSize,
+                [this](void** blocks, uint32 count)
+                {
+                    uint32 i = 0;
+
+                    try
+                    {
+                        for (; i < count; ++i)
+                            blocks[i] = _pool.get();
+                    }
+                    catch (std::bad_alloc const&)
+                    {
+                        // maxAlloc reached, a partial refill is fine
+                        if (!i)
+                            throw;
+                    }
+
+                    return i;
+                },
+                [this](void* const* blocks, uint32 count)
+                {
+                    for (uint32 i = 0; i < count; ++i)
+                        _pool.release(static_cast<RawBlock*>(blocks[i]));
+                }) { }
+
+        CachedFastMemoryPool(CachedFastMemoryPool const&) = delete;
+        CachedFastMemoryPool& operator=(CachedFastMemoryPool const&) = delete;
+
+        void* get() { return _magazines.Get(); }
+
+        /// Calls the destructor, null is ignored
+        template<class P>
+        void release(P* ptr)
+        {
+            if (!ptr)
+                return;
+
+            ptr->~P();
+            _magazines.Release(ptr);
+        }
+
+        std::size_t blockSize() const { return _pool.blockSize(); }
+        std::size_t allocated() const { return _pool.allocated(); }
+
+    private:
+        // The pool destroys what it gets back, blocks from the magazines hold no object anymore
+        struct RawBlock { };
+
+        Poco::FastMemoryPool<T, Poco::NullMutex> _pool;
+        ThreadMagazines _magazines;
+    };
+}
+
+#endif // _WARHEAD_CACHED_MEMORY_POOL_H_
@@ -0,0 +1,43 @@
+/*
+ * This file is part of the WarheadApp Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+// Headers used by most of common and the apps, compiled once when USE_COREPCH is enabled.
+// On Windows Common.h (also pulled in by Log.h) includes <ws2tcpip.h> and with it <Windows.h>,
+// so the PCH carries those macros, trimmed by WIN32_LEAN_AND_MEAN and NOMINMAX.
+// Every source including Common.h gets them anyway; don't add other platform headers here.
+
+#include "Define.h"
+#include "Common.h"
+#include "Log.h"
+#include "StringFormat.h"
+#include "Timer.h"
+#include "Util.h"
+#include <Poco/Exception.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
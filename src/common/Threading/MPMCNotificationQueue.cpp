@@ -0,0 +1,356 @@
+/*
+ * This file is part of the WarheadApp Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "MPMCNotificationQueue.h"
+#include "Duration.h"
+#include <Poco/Bugcheck.h>
+#include <thread>
+
+#if WH_PLATFORM == WH_PLATFORM_WINDOWS && defined(_WIN32_WINNT) && _WIN32_WINNT >= 0x0602
+#  define WH_WAIT_ON_ADDRESS
+#  include <Windows.h>
+#  pragma comment(lib, "Synchronization.lib")
+#elif defined(__linux__)
+#  define WH_WAIT_FUTEX
+#  include <climits>
+#  include <ctime>
+#  include <linux/futex.h>
+#  include <sys/syscall.h>
+#  include <unistd.h>
+#else
+// WaitOnAddress needs Windows 8, the build targets Windows 7 (_WIN32_WINNT 0x0601)
+#  define WH_WAIT_FALLBACK
+#  include <condition_variable>
+#  include <mutex>
+#endif
+
+namespace
+{
+    // Yields before going to sleep, a producer or consumer usually shows up within a few time slices
+    constexpr uint32 SPIN_ROUNDS = 16;
+}
+
+struct Warhead::Threading::WaitPoint::Fallback
+{
+#ifdef WH_WAIT_FALLBACK
+    std::mutex Lock;
+    std::condition_variable Condition;
+#endif
+};
+
+Warhead::Threading::WaitPoint::WaitPoint()
+{
+#ifdef WH_WAIT_FALLBACK
+    _fallback = std::make_unique<Fallback>();
+#endif
+}
+
+Warhead::Threading::WaitPoint::~WaitPoint() = default;
+
+uint32 Warhead::Threading::WaitPoint::Prepare()
+{
+    _waiters.fetch_add(1, std::memory_order_seq_cst);
+    return _sequence.load(std::memory_order_seq_cst);
+}
+
+bool Warhead::Threading::WaitPoint::Wait(uint32 ticket, long milliseconds /*= -1*/)
+{
+    using namespace std::chrono;
+
+    steady_clock::time_point deadline = steady_clock::now() + Milliseconds(milliseconds < 0 ? 0 : milliseconds);
+
+#ifdef WH_WAIT_FALLBACK
+    {
+        std::unique_lock<std::mutex> lock(_fallback->Lock);
+        auto notified = [this, ticket]() { return _sequence.load(std::memory_order_acquire) != ticket; };
+
+        if (milliseconds < 0)
+            _fallback->Condition.wait(lock, notified);
+        else
+            _fallback->Condition.wait_until(lock, deadline, notified);
+    }
+#else
+    while (_sequence.load(std::memory_order_acquire) == ticket)
+    {
+        Milliseconds remaining(-1);
+
+        if (milliseconds >= 0)
+        {
+            remaining = duration_cast<Milliseconds>(deadline - steady_clock::now());
+            if (remaining.count() <= 0)
+                break;
+        }
+
+#ifdef WH_WAIT_ON_ADDRESS
+        WaitOnAddress(&_sequence, &ticket, sizeof(ticket), milliseconds < 0 ? INFINITE : DWORD(remaining.count()));
+#else
+        timespec timeout;
+        timeout.tv_sec = time_t(remaining.count() / 1000);
+        timeout.tv_nsec = long(remaining.count() % 1000) * 1000000;
+
+        // Returns at once if the sequence moved on meanwhile
+        syscall(SYS_futex, reinterpret_cast<uint32*>(&_sequence), FUTEX_WAIT_PRIVATE, ticket, milliseconds < 0 ? nullptr : &timeout, nullptr, 0);
+#endif
+    }
+#endif
+
+    _waiters.fetch_sub(1, std::memory_order_relaxed);
+    return _sequence.load(std::memory_order_acquire) != ticket;
+}
+
+void Warhead::Threading::WaitPoint::Cancel()
+{
+    _waiters.fetch_sub(1, std::memory_order_relaxed);
+}
+
+void Warhead::Threading::WaitPoint::Notify(bool all /*= false*/)
+{
+    // Pairs with Prepare(): either the waiter sees the new state or we see the waiter
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    if (!_waiters.load(std::memory_order_relaxed))
+        return;
+
+    _sequence.fetch_add(1, std::memory_order_seq_cst);
+
+#if defined(WH_WAIT_FALLBACK)
+    {
+        std::lock_guard<std::mutex> guard(_fallback->Lock);
+    }
+
+    if (all)
+        _fallback->Condition.notify_all();
+    else
+        _fallback->Condition.notify_one();
+#elif defined(WH_WAIT_ON_ADDRESS)
+    if (all)
+        WakeByAddressAll(&_sequence);
+    else
+        WakeByAddressSingle(&_sequence);
+#else
+    syscall(SYS_futex, reinterpret_cast<uint32*>(&_sequence), FUTEX_WAKE_PRIVATE, all ? INT_MAX : 1, nullptr, nullptr, 0);
+#endif
+}
+
+Warhead::Threading::MPMCNotificationQueue::MPMCNotificationQueue(std::size_t capacity /*= 1024*/) :
+    _mask([capacity]()
+    {
+        std::size_t size = 2;
+        while (size < capacity)
+            size <<= 1;
+
+        return size - 1;
+    }()),
+    _cells(new Cell[_mask + 1])
+{
+    for (std::size_t i = 0; i <= _mask; ++i)
+    {
+        _cells[i].Sequence.store(i, std::memory_order_relaxed);
+        _cells[i].Notification = nullptr;
+    }
+}
+
+Warhead::Threading::MPMCNotificationQueue::~MPMCNotificationQueue()
+{
+    clear();
+}
+
+bool Warhead::Threading::MPMCNotificationQueue::TryPush(Poco::Notification* notification)
+{
+    std::size_t position = _enqueuePos.load(std::memory_order_relaxed);
+    Cell* cell;
+
+    for (;;)
+    {
+        cell = &_cells[position & _mask];
+        std::size_t sequence = cell->Sequence.load(std::memory_order_acquire);
+        intptr_t difference = intptr_t(sequence) - intptr_t(position);
+
+        if (!difference)
+        {
+            if (_enqueuePos.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                break;
+        }
+        else if (difference < 0)
+            return false; // Full
+        else
+            position = _enqueuePos.load(std::memory_order_relaxed);
+    }
+
+    cell->Notification = notification;
+    cell->Sequence.store(position + 1, std::memory_order_release);
+    return true;
+}
+
+Poco::Notification* Warhead::Threading::MPMCNotificationQueue::TryPop()
+{
+    std::size_t position = _dequeuePos.load(std::memory_order_relaxed);
+    Cell* cell;
+
+    for (;;)
+    {
+        cell = &_cells[position & _mask];
+        std::size_t sequence = cell->Sequence.load(std::memory_order_acquire);
+        intptr_t difference = intptr_t(sequence) - intptr_t(position + 1);
+
+        if (!difference)
+        {
+            if (_dequeuePos.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                break;
+        }
+        else if (difference < 0)
+            return nullptr; // Empty
+        else
+            position = _dequeuePos.load(std::memory_order_relaxed);
+    }
+
+    Poco::Notification* notification = cell->Notification;
+    cell->Sequence.store(position + _mask + 1, std::memory_order_release);
+    return notification;
+}
+
+bool Warhead::Threading::MPMCNotificationQueue::tryEnqueueNotification(Poco::Notification::Ptr notification)
+{
+    poco_check_ptr(notification);
+
+    Poco::Notification* raw = notification.duplicate();
+
+    if (!TryPush(raw))
+    {
+        raw->release();
+        return false;
+    }
+
+    _notEmpty.Notify();
+    return true;
+}
+
+void Warhead::Threading::MPMCNotificationQueue::enqueueNotification(Poco::Notification::Ptr notification)
+{
+    poco_check_ptr(notification);
+
+    Poco::Notification* raw = notification.duplicate();
+
+    for (uint32 i = 0; i < SPIN_ROUNDS; ++i)
+    {
+        if (TryPush(raw))
+        {
+            _notEmpty.Notify();
+            return;
+        }
+
+        std::this_thread::yield();
+    }
+
+    while (!TryPush(raw))
+    {
+        uint32 ticket = _notFull.Prepare();
+
+        if (TryPush(raw))
+        {
+            _notFull.Cancel();
+            break;
+        }
+
+        _notFull.Wait(ticket);
+    }
+
+    _notEmpty.Notify();
+}
+
+Poco::Notification* Warhead::Threading::MPMCNotificationQueue::dequeueNotification()
+{
+    Poco::Notification* notification = TryPop();
+
+    if (notification)
+        _notFull.Notify();
+
+    return notification;
+}
+
+Poco::Notification* Warhead::Threading::MPMCNotificationQueue::waitDequeueNotification()
+{
+    return waitDequeueNotification(-1);
+}
+
+Poco::Notification* Warhead::Threading::MPMCNotificationQueue::waitDequeueNotification(long milliseconds)
+{
+    using namespace std::chrono;
+
+    for (uint32 i = 0; i < SPIN_ROUNDS; ++i)
+    {
+        if (Poco::Notification* notification = dequeueNotification())
+            return notification;
+
+        std::this_thread::yield();
+    }
+
+    uint32 wakeUps = _wakeUps.load(std::memory_order_acquire);
+    steady_clock::time_point deadline = steady_clock::now() + Milliseconds(milliseconds < 0 ? 0 : milliseconds);
+
+    _idleThreads.fetch_add(1, std::memory_order_relaxed);
+
+    Poco::Notification* notification = nullptr;
+
+    for (;;)
+    {
+        uint32 ticket = _notEmpty.Prepare();
+
+        if ((notification = dequeueNotification()) || _wakeUps.load(std::memory_order_acquire) != wakeUps)
+        {
+            _notEmpty.Cancel();
+            break;
+        }
+
+        long remaining = -1;
+
+        if (milliseconds >= 0)
+        {
+            remaining = long(duration_cast<Milliseconds>(deadline - steady_clock::now()).count());
+            if (remaining <= 0)
+            {
+                _notEmpty.Cancel();
+                break;
+            }
+        }
+
+        _notEmpty.Wait(ticket, remaining);
+    }
+
+    _idleThreads.fetch_sub(1, std::memory_order_relaxed);
+    return notification;
+}
+
+void Warhead::Threading::MPMCNotificationQueue::wakeUpAll()
+{
+    _wakeUps.fetch_add(1, std::memory_order_release);
+    _notEmpty.Notify(true);
+}
+
+std::size_t Warhead::Threading::MPMCNotificationQueue::size() const
+{
+    std::size_t dequeued = _dequeuePos.load(std::memory_order_relaxed);
+    std::size_t enqueued = _enqueuePos.load(std::memory_order_relaxed);
+    return enqueued > dequeued ? enqueued - dequeued : 0;
+}
+
+void Warhead::Threading::MPMCNotificationQueue::clear()
+{
+    while (Poco::Notification* notification = dequeueNotification())
+        notification->release();
+}
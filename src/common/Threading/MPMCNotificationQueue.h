@@ -0,0 +1,126 @@
+/*
+ * This file is part of the WarheadApp Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef _WARHEAD_MPMC_NOTIFICATION_QUEUE_H_
+#define _WARHEAD_MPMC_NOTIFICATION_QUEUE_H_
+
+#include "Define.h"
+#include <Poco/Notification.h>
+#include <atomic>
+#include <memory>
+
+namespace Warhead::Threading
+{
+    /// Sleeping side of the lock-free queue. Waiters block on a futex where the
+    /// platform has one, the producers only touch it when somebody is waiting.
+    class WH_COMMON_API WaitPoint
+    {
+    public:
+        WaitPoint();
+        ~WaitPoint();
+
+        WaitPoint(WaitPoint const&) = delete;
+        WaitPoint& operator=(WaitPoint const&) = delete;
+
+        /// Call before the last check of the condition, pass the result to Wait()
+        uint32 Prepare();
+
+        /// Blocks until Notify() was called after Prepare(), timeout in milliseconds, -1 = infinite.
+        /// Returns false on timeout.
+        bool Wait(uint32 ticket, long milliseconds = -1);
+        void Cancel();
+
+        /// Cheap when nobody waits
+        void Notify(bool all = false);
+
+        /// Racy hint, for callers that can take a cheaper path when nobody waits
+        bool HasWaiters() const { return _waiters.load(std::memory_order_relaxed) != 0; }
+
+    private:
+        struct Fallback;
+
+        std::atomic<uint32> _sequence{ 0 };
+        std::atomic<uint32> _waiters{ 0 };
+        std::unique_ptr<Fallback> _fallback;
+    };
+
+    /// Bounded lock-free replacement for Poco::NotificationQueue (Vyukov MPMC ring).
+    /// It keeps Poco's method names so users can switch by changing the member type.
+    /// Differences: the capacity is fixed, enqueueNotification() blocks while the queue is full,
+    /// there is no enqueueUrgentNotification() and no dispatch().
+    /// Opt-in only, Poco::NotificationQueue stays the default: so far it was only measured on a
+    /// single core, where it lost to Poco's queue at 64 producer/consumer pairs. Check Lab's
+    /// queue benchmark on a multi-core machine before switching a user over.
+    class WH_COMMON_API MPMCNotificationQueue
+    {
+    public:
+        /// Rounded up to a power of two
+        explicit MPMCNotificationQueue(std::size_t capacity = 1024);
+        ~MPMCNotificationQueue();
+
+        MPMCNotificationQueue(MPMCNotificationQueue const&) = delete;
+        MPMCNotificationQueue& operator=(MPMCNotificationQueue const&) = delete;
+
+        void enqueueNotification(Poco::Notification::Ptr notification);
+
+        /// False if the queue is full
+        bool tryEnqueueNotification(Poco::Notification::Ptr notification);
+
+        /// The caller owns the returned notification and must release it. Null if the queue is empty.
+        Poco::Notification* dequeueNotification();
+
+        /// Blocks until a notification arrives or wakeUpAll() is called (returns null then)
+        Poco::Notification* waitDequeueNotification();
+        Poco::Notification* waitDequeueNotification(long milliseconds);
+
+        /// Every thread blocked in waitDequeueNotification() returns null
+        void wakeUpAll();
+
+        bool empty() const { return size() == 0; }
+        std::size_t size() const;
+        bool hasIdleThreads() const { return _idleThreads.load(std::memory_order_relaxed) != 0; }
+        std::size_t capacity() const { return _mask + 1; }
+
+        /// Releases all queued notifications
+        void clear();
+
+    private:
+        struct Cell
+        {
+            std::atomic<std::size_t> Sequence;
+            Poco::Notification* Notification;
+        };
+
+        bool TryPush(Poco::Notification* notification);
+        Poco::Notification* TryPop();
+
+        std::size_t const _mask;
+        std::unique_ptr<Cell[]> _cells;
+
+        // Producers and consumers each get their own cache line
+        alignas(64) std::atomic<std::size_t> _enqueuePos{ 0 };
+        alignas(64) std::atomic<std::size_t> _dequeuePos{ 0 };
+
+        alignas(64) WaitPoint _notEmpty;
+        WaitPoint _notFull;
+        std::atomic<uint32> _wakeUps{ 0 };
+        std::atomic<uint32> _idleThreads{ 0 };
+    };
+}
+
+#endif // _WARHEAD_MPMC_NOTIFICATION_QUEUE_H_
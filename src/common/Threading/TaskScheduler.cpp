@@ -0,0 +1,457 @@
+/*
+ * This file is part of the WarheadApp Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "TaskScheduler.h"
+#include "Log.h"
+#include <Poco/Semaphore.h>
+#include <Poco/Thread.h>
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+namespace
+{
+    constexpr uint32 SPIN_ROUNDS = 64;
+
+    template<class T>
+    class WorkStealingDeque
+    {
+    public:
+        WorkStealingDeque() : _ring(new Ring(256))
+        {
+            _rings.emplace_back(_ring.load(std::memory_order_relaxed));
+        }
+
+        WorkStealingDeque(WorkStealingDeque const&) = delete;
+        WorkStealingDeque& operator=(WorkStealingDeque const&) = delete;
+
+        // Owner only
+        void Push(T* item)
+        {
+            int64 bottom = _bottom.load(std::memory_order_relaxed);
+            int64 top = _top.load(std::memory_order_acquire);
+            Ring* ring = _ring.load(std::memory_order_relaxed);
+
+            if (bottom - top > ring->Mask)
+                ring = Grow(ring, top, bottom);
+
+            ring->Put(bottom, item);
+            _bottom.store(bottom + 1, std::memory_order_release);
+        }
+
+        // Owner only, newest first
+        T* Pop()
+        {
+            int64 bottom = _bottom.load(std::memory_order_relaxed) - 1;
+            Ring* ring = _ring.load(std::memory_order_relaxed);
+            _bottom.store(bottom, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            int64 top = _top.load(std::memory_order_relaxed);
+
+            if (top > bottom)
+            {
+                _bottom.store(bottom + 1, std::memory_order_relaxed);
+                return nullptr;
+            }
+
+            T* item = ring->Get(bottom);
+
+            // Last item, race the thieves for it
+            if (top == bottom)
+            {
+                if (!_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                    item = nullptr;
+
+                _bottom.store(bottom + 1, std::memory_order_relaxed);
+            }
+
+            return item;
+        }
+
+        // Any thread, oldest first
+        T* Steal()
+        {
+            int64 top = _top.load(std::memory_order_acquire);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            int64 bottom = _bottom.load(std::memory_order_acquire);
+
+            if (top >= bottom)
+                return nullptr;
+
+            T* item = _ring.load(std::memory_order_acquire)->Get(top);
+            if (!_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                return nullptr;
+
+            return item;
+        }
+
+        bool Empty() const
+        {
+            return _bottom.load(std::memory_order_relaxed) <= _top.load(std::memory_order_relaxed);
+        }
+
+    private:
+        struct Ring
+        {
+            explicit Ring(int64 capacity) : Mask(capacity - 1), Items(new std::atomic<T*>[std::size_t(capacity)]) { }
+
+            void Put(int64 index, T* item) { Items[std::size_t(index & Mask)].store(item, std::memory_order_relaxed); }
+            T* Get(int64 index) const { return Items[std::size_t(index & Mask)].load(std::memory_order_relaxed); }
+
+            int64 const Mask;
+            std::unique_ptr<std::atomic<T*>[]> Items;
+        };
+
+        Ring* Grow(Ring* ring, int64 top, int64 bottom)
+        {
+            Ring* grown = new Ring((ring->Mask + 1) * 2);
+
+            for (int64 i = top; i < bottom; ++i)
+                grown->Put(i, ring->Get(i));
+
+            // Thieves may still read the old ring, it is kept until the deque goes away
+            _rings.emplace_back(grown);
+            _ring.store(grown, std::memory_order_release);
+            return grown;
+        }
+
+        std::atomic<int64> _top{ 0 };
+        std::atomic<int64> _bottom{ 0 };
+        std::atomic<Ring*> _ring;
+        std::vector<std::unique_ptr<Ring>> _rings;
+    };
+
+    uint32 NextRandom(uint32& state)
+    {
+        // xorshift32, only used to spread thieves over the victims
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+}
+
+struct Warhead::Threading::TaskScheduler::Task
+{
+    std::function<void()> Function;
+    TaskGroup* Group;
+};
+
+struct Warhead::Threading::TaskScheduler::Worker
+{
+    uint32 Index = 0;
+    WorkStealingDeque<Task> Tasks;
+    Poco::Thread Thread;
+    uint32 Random = 0;
+};
+
+struct Warhead::Threading::TaskScheduler::Shared
+{
+    // Tasks posted from outside the workers
+    std::mutex InjectionLock;
+    std::deque<Task*> Injected;
+    std::atomic<std::size_t> InjectedCount{ 0 };
+
+    // Workers parked or about to park
+    std::atomic<uint32> Sleeping{ 0 };
+    Poco::Semaphore Wakeup{ 0, INT_MAX };
+    std::atomic<bool> Stop{ false };
+
+    // Threads in TaskGroup::Wait() sleep here once there is nothing left to help with
+    std::mutex WaitLock;
+    std::condition_variable WaitCondition;
+};
+
+namespace
+{
+    // Set on worker threads only
+    thread_local Warhead::Threading::TaskScheduler const* _currentScheduler = nullptr;
+    thread_local uint32 _currentWorkerIndex = 0;
+}
+
+Warhead::Threading::TaskScheduler::TaskScheduler(uint32 workers /*= 0*/) : _shared(std::make_unique<Shared>())
+{
+    if (!workers)
+        workers = std::max(std::thread::hardware_concurrency(), 1u);
+
+    _workers.reserve(workers);
+
+    for (uint32 i = 0; i < workers; ++i)
+    {
+        auto& worker = _workers.emplace_back(std::make_unique<Worker>());
+        worker->Index = i;
+        worker->Random = i * 2654435761u + 1;
+    }
+
+    // Started once all deques exist, workers steal from each other right away
+    for (uint32 i = 0; i < workers; ++i)
+    {
+        Worker* worker = _workers[i].get();
+        worker->Thread.setName("Task worker " + std::to_string(i));
+        worker->Thread.startFunc([this, worker]() { Work(worker); });
+    }
+}
+
+Warhead::Threading::TaskScheduler::~TaskScheduler()
+{
+    // Workers drain the queues before they stop
+    _shared->Stop.store(true, std::memory_order_seq_cst);
+
+    for (std::size_t i = 0; i < _workers.size(); ++i)
+        _shared->Wakeup.set();
+
+    for (auto& worker : _workers)
+        worker->Thread.join();
+}
+
+Warhead::Threading::TaskScheduler& Warhead::Threading::TaskScheduler::Instance()
+{
+    static TaskScheduler instance;
+    return instance;
+}
+
+Warhead::Threading::TaskScheduler::Worker* Warhead::Threading::TaskScheduler::GetCurrentWorker() const
+{
+    return _currentScheduler == this ? _workers[_currentWorkerIndex].get() : nullptr;
+}
+
+void Warhead::Threading::TaskScheduler::Post(std::function<void()> task)
+{
+    Spawn(std::move(task), nullptr);
+}
+
+void Warhead::Threading::TaskScheduler::Spawn(std::function<void()>&& function, TaskGroup* group)
+{
+    Task* task = new Task{ std::move(function), group };
+
+    if (Worker* worker = GetCurrentWorker())
+        worker->Tasks.Push(task);
+    else
+    {
+        std::lock_guard<std::mutex> guard(_shared->InjectionLock);
+        _shared->Injected.push_back(task);
+        _shared->InjectedCount.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    WakeWorker();
+}
+
+void Warhead::Threading::TaskScheduler::WakeWorker()
+{
+    // Pairs with the fence in Work(): either the worker sees the new task or we see the worker sleeping
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    uint32 sleeping = _shared->Sleeping.load(std::memory_order_relaxed);
+
+    while (sleeping && !_shared->Sleeping.compare_exchange_weak(sleeping, sleeping - 1, std::memory_order_relaxed)) { }
+
+    if (sleeping)
+        _shared->Wakeup.set();
+}
+
+bool Warhead::Threading::TaskScheduler::HasQueuedTasks() const
+{
+    if (_shared->InjectedCount.load(std::memory_order_relaxed))
+        return true;
+
+    return std::any_of(_workers.begin(), _workers.end(), [](auto const& worker) { return !worker->Tasks.Empty(); });
+}
+
+Warhead::Threading::TaskScheduler::Task* Warhead::Threading::TaskScheduler::FindTask(Worker* self)
+{
+    if (self)
+        if (Task* task = self->Tasks.Pop())
+            return task;
+
+    if (_shared->InjectedCount.load(std::memory_order_relaxed))
+    {
+        std::lock_guard<std::mutex> guard(_shared->InjectionLock);
+
+        if (!_shared->Injected.empty())
+        {
+            Task* task = _shared->Injected.front();
+            _shared->Injected.pop_front();
+            _shared->InjectedCount.fetch_sub(1, std::memory_order_relaxed);
+            return task;
+        }
+    }
+
+    std::size_t count = _workers.size();
+    thread_local uint32 random = 0x9E3779B9u;
+    std::size_t start = NextRandom(self ? self->Random : random) % count;
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        Worker* victim = _workers[(start + i) % count].get();
+        if (victim == self)
+            continue;
+
+        if (Task* task = victim->Tasks.Steal())
+            return task;
+    }
+
+    return nullptr;
+}
+
+void Warhead::Threading::TaskScheduler::Execute(Task* task)
+{
+    std::unique_ptr<Task> owned(task);
+    std::exception_ptr exception;
+
+    try
+    {
+        task->Function();
+    }
+    catch (std::exception const& e)
+    {
+        if (!task->Group)
+            LOG_ERROR("> TaskScheduler: task failed with %s", e.what());
+
+        exception = std::current_exception();
+    }
+    catch (...)
+    {
+        if (!task->Group)
+            LOG_ERROR("> TaskScheduler: task failed with an unknown exception");
+
+        exception = std::current_exception();
+    }
+
+    if (TaskGroup* group = task->Group)
+    {
+        // Release the captured state before the group may be destroyed
+        owned.reset();
+        group->OnTaskDone(std::move(exception));
+    }
+}
+
+bool Warhead::Threading::TaskScheduler::RunOne()
+{
+    Task* task = FindTask(GetCurrentWorker());
+    if (!task)
+        return false;
+
+    Execute(task);
+    return true;
+}
+
+void Warhead::Threading::TaskScheduler::Work(Worker* self)
+{
+    _currentScheduler = this;
+    _currentWorkerIndex = self->Index;
+
+    for (;;)
+    {
+        Task* task = FindTask(self);
+
+        for (uint32 i = 0; !task && i < SPIN_ROUNDS; ++i)
+        {
+            std::this_thread::yield();
+            task = FindTask(self);
+        }
+
+        if (task)
+        {
+            Execute(task);
+            continue;
+        }
+
+        _shared->Sleeping.fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        // Recheck after announcing the sleep, a task spawned before that is seen here
+        bool stop = _shared->Stop.load(std::memory_order_relaxed);
+        if (stop || HasQueuedTasks())
+        {
+            // Withdraw unless a waker already counted us out, a spare wakeup only costs one extra loop
+            uint32 sleeping = _shared->Sleeping.load(std::memory_order_relaxed);
+            while (sleeping && !_shared->Sleeping.compare_exchange_weak(sleeping, sleeping - 1, std::memory_order_relaxed)) { }
+
+            if (stop && !HasQueuedTasks())
+                break;
+
+            continue;
+        }
+
+        _shared->Wakeup.wait();
+    }
+
+    _currentScheduler = nullptr;
+}
+
+void Warhead::Threading::TaskScheduler::WaitGroup(TaskGroup& group)
+{
+    while (group._pending.load(std::memory_order_acquire))
+    {
+        if (RunOne())
+            continue;
+
+        // The remaining tasks run elsewhere, they may still spawn work we can help with
+        std::unique_lock<std::mutex> lock(_shared->WaitLock);
+        _shared->WaitCondition.wait_for(lock, std::chrono::milliseconds(1), [&group]()
+        {
+            return !group._pending.load(std::memory_order_acquire);
+        });
+    }
+}
+
+Warhead::Threading::TaskGroup::~TaskGroup()
+{
+    _scheduler.WaitGroup(*this);
+}
+
+void Warhead::Threading::TaskGroup::Run(std::function<void()> task)
+{
+    _pending.fetch_add(1, std::memory_order_relaxed);
+    _scheduler.Spawn(std::move(task), this);
+}
+
+void Warhead::Threading::TaskGroup::Wait()
+{
+    _scheduler.WaitGroup(*this);
+
+    if (_failed.load(std::memory_order_acquire))
+    {
+        std::exception_ptr exception = std::move(_exception);
+        _exception = nullptr;
+        _failed.store(false, std::memory_order_relaxed);
+        std::rethrow_exception(exception);
+    }
+}
+
+void Warhead::Threading::TaskGroup::OnTaskDone(std::exception_ptr exception)
+{
+    if (exception && !_failed.exchange(true, std::memory_order_acq_rel))
+        _exception = std::move(exception);
+
+    // The group may be gone once the count reaches zero, only the scheduler is touched afterwards
+    TaskScheduler::Shared& shared = *_scheduler._shared;
+
+    if (_pending.fetch_sub(1, std::memory_order_acq_rel) != 1)
+        return;
+
+    {
+        std::lock_guard<std::mutex> guard(shared.WaitLock);
+    }
+
+    shared.WaitCondition.notify_all();
+}
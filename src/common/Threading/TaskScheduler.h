@@ -0,0 +1,142 @@
+/*
+ * This file is part of the WarheadApp Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef _WARHEAD_TASK_SCHEDULER_H_
+#define _WARHEAD_TASK_SCHEDULER_H_
+
+#include "Define.h"
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <vector>
+
+namespace Warhead::Threading
+{
+    class TaskGroup;
+
+    /// Work stealing scheduler for short CPU bound tasks. Unlike Poco::ThreadPool it queues
+    /// instead of throwing when all workers are busy.
+    ///
+    /// Each worker owns a Chase-Lev deque: tasks spawned on a worker go to its own deque,
+    /// it runs them newest first, idle workers steal the oldest. Tasks posted from other
+    /// threads go through a shared injection queue. Workers with nothing to do park on a semaphore.
+    /// Tasks must not block on I/O, use Warhead::IO for that.
+    class WH_COMMON_API TaskScheduler
+    {
+    public:
+        /// 0 = hardware concurrency
+        explicit TaskScheduler(uint32 workers = 0);
+        ~TaskScheduler();
+
+        TaskScheduler(TaskScheduler const&) = delete;
+        TaskScheduler& operator=(TaskScheduler const&) = delete;
+
+        /// Shared scheduler with one worker per core
+        static TaskScheduler& Instance();
+
+        /// Fire and forget, exceptions are logged
+        void Post(std::function<void()> task);
+
+        template<class Func>
+        auto Submit(Func&& func) -> std::future<decltype(func())>
+        {
+            auto task = std::make_shared<std::packaged_task<decltype(func())()>>(std::forward<Func>(func));
+            auto future = task->get_future();
+            Post([task]() { (*task)(); });
+            return future;
+        }
+
+        /// Runs one queued task on the calling thread, false if none was found
+        bool RunOne();
+
+        uint32 GetWorkerCount() const { return uint32(_workers.size()); }
+
+    private:
+        friend class TaskGroup;
+
+        struct Task;
+        struct Worker;
+        struct Shared;
+
+        Worker* GetCurrentWorker() const;
+        void Spawn(std::function<void()>&& function, TaskGroup* group);
+        void Execute(Task* task);
+        Task* FindTask(Worker* self);
+        bool HasQueuedTasks() const;
+        void WakeWorker();
+        void Work(Worker* self);
+        void WaitGroup(TaskGroup& group);
+
+        std::vector<std::unique_ptr<Worker>> _workers;
+        std::unique_ptr<Shared> _shared;
+    };
+
+    /// Fork/join: tasks run on the scheduler, Wait() helps running queued tasks until all of them finished.
+    /// The first exception thrown by a task is rethrown from Wait().
+    ///
+    /// Warhead::Threading::TaskGroup group;
+    /// group.Run([&]() { left = Sum(first, middle); });
+    /// group.Run([&]() { right = Sum(middle, last); });
+    /// group.Wait();
+    class WH_COMMON_API TaskGroup
+    {
+    public:
+        explicit TaskGroup(TaskScheduler& scheduler = TaskScheduler::Instance()) : _scheduler(scheduler) { }
+
+        /// Waits for the remaining tasks, an exception is dropped if Wait() was not called
+        ~TaskGroup();
+
+        TaskGroup(TaskGroup const&) = delete;
+        TaskGroup& operator=(TaskGroup const&) = delete;
+
+        void Run(std::function<void()> task);
+        void Wait();
+
+    private:
+        friend class TaskScheduler;
+
+        void OnTaskDone(std::exception_ptr exception);
+
+        TaskScheduler& _scheduler;
+        std::atomic<uint32> _pending{ 0 };
+        std::atomic<bool> _failed{ false };
+        std::exception_ptr _exception;
+    };
+
+    /// Calls func(begin, end) for chunks of at most grain elements in parallel and waits for all of them
+    template<class Func>
+    void ParallelFor(std::size_t begin, std::size_t end, std::size_t grain, Func const& func, TaskScheduler& scheduler = TaskScheduler::Instance())
+    {
+        if (!grain)
+            grain = 1;
+
+        TaskGroup group(scheduler);
+
+        for (std::size_t first = begin; first < end; first += grain)
+        {
+            std::size_t last = end - first > grain ? first + grain : end;
+            group.Run([&func, first, last]() { func(first, last); });
+        }
+
+        group.Wait();
+    }
+}
+
+#endif // _WARHEAD_TASK_SCHEDULER_H_
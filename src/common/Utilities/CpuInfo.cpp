@@ -0,0 +1,199 @@
+/*
+ * This file is part of the WarheadApp Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "CpuInfo.h"
+#include <array>
+#include <cstring>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#  define WH_CPU_X86
+#  if WH_COMPILER == WH_COMPILER_MICROSOFT
+#    include <intrin.h>
+#  else
+#    include <cpuid.h>
+#  endif
+#endif
+
+namespace
+{
+    constexpr std::string_view FeatureNames[] =
+    {
+        "sse2", "sse3", "ssse3", "sse4.1", "sse4.2", "popcnt", "aes", "pclmul", "avx", "fma", "bmi1", "bmi2",
+        "avx2", "avx512f", "avx512dq", "avx512bw", "avx512vl", "sha", "invariant_tsc"
+    };
+
+    static_assert(std::size(FeatureNames) == std::size_t(Warhead::Cpu::Feature::Count), "Feature name missing");
+
+#ifdef WH_CPU_X86
+    using Registers = std::array<uint32, 4>; // eax, ebx, ecx, edx
+
+    Registers CpuId(uint32 leaf, uint32 subleaf = 0)
+    {
+        Registers regs = {};
+#if WH_COMPILER == WH_COMPILER_MICROSOFT
+        int values[4];
+        __cpuidex(values, int(leaf), int(subleaf));
+        std::memcpy(regs.data(), values, sizeof(values));
+#else
+        __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+        return regs;
+    }
+
+    // Register state the OS saves on context switch (XCR0)
+    uint64 GetEnabledXState()
+    {
+#if WH_COMPILER == WH_COMPILER_MICROSOFT
+        return _xgetbv(0);
+#else
+        uint32 eax, edx;
+        __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+        return (uint64(edx) << 32) | eax;
+#endif
+    }
+
+    constexpr bool Bit(uint32 value, uint8 bit) { return (value >> bit) & 1; }
+#endif
+
+    struct CpuInfo
+    {
+        CpuInfo()
+        {
+            Detect();
+
+            for (uint8 i = 0; i < uint8(Warhead::Cpu::Feature::Count); ++i)
+            {
+                if (!Features.Has(Warhead::Cpu::Feature(i)))
+                    continue;
+
+                if (!FeaturesString.empty())
+                    FeaturesString += ' ';
+
+                FeaturesString += FeatureNames[i];
+            }
+        }
+
+        void Detect()
+        {
+#ifdef WH_CPU_X86
+            using Warhead::Cpu::Feature;
+
+            uint32 maxLeaf = CpuId(0)[0];
+            if (maxLeaf < 1)
+                return;
+
+            Registers leaf1 = CpuId(1);
+            uint32 ecx = leaf1[2];
+            uint32 edx = leaf1[3];
+
+            auto add = [this](bool present, Feature feature)
+            {
+                if (present)
+                    Features.Add(feature);
+            };
+
+            add(Bit(edx, 26), Feature::SSE2);
+            add(Bit(ecx, 0), Feature::SSE3);
+            add(Bit(ecx, 1), Feature::PCLMUL);
+            add(Bit(ecx, 9), Feature::SSSE3);
+            add(Bit(ecx, 19), Feature::SSE41);
+            add(Bit(ecx, 20), Feature::SSE42);
+            add(Bit(ecx, 23), Feature::POPCNT);
+            add(Bit(ecx, 25), Feature::AES);
+
+            // AVX state (XMM + YMM) and AVX-512 state (opmask + ZMM) must be enabled by the OS
+            uint64 xstate = Bit(ecx, 27) ? GetEnabledXState() : 0;
+            bool avxState = (xstate & 0x06) == 0x06;
+            bool avx512State = (xstate & 0xE6) == 0xE6;
+
+            add(avxState && Bit(ecx, 28), Feature::AVX);
+            add(avxState && Bit(ecx, 12), Feature::FMA);
+
+            if (maxLeaf >= 7)
+            {
+                uint32 ebx = CpuId(7)[1];
+
+                add(Bit(ebx, 3), Feature::BMI1);
+                add(Bit(ebx, 8), Feature::BMI2);
+                add(Bit(ebx, 29), Feature::SHA);
+                add(avxState && Bit(ebx, 5), Feature::AVX2);
+                add(avx512State && Bit(ebx, 16), Feature::AVX512F);
+                add(avx512State && Bit(ebx, 17), Feature::AVX512DQ);
+                add(avx512State && Bit(ebx, 30), Feature::AVX512BW);
+                add(avx512State && Bit(ebx, 31), Feature::AVX512VL);
+            }
+
+            uint32 maxExtendedLeaf = CpuId(0x80000000)[0];
+
+            if (maxExtendedLeaf >= 0x80000004)
+            {
+                char brand[49] = {};
+
+                for (uint32 i = 0; i < 3; ++i)
+                {
+                    Registers regs = CpuId(0x80000002 + i);
+                    std::memcpy(brand + i * 16, regs.data(), 16);
+                }
+
+                // Some vendors pad the brand string
+                std::string_view name(brand);
+                std::size_t first = name.find_first_not_of(' ');
+
+                if (first != std::string_view::npos)
+                    Brand = name.substr(first, name.find_last_not_of(' ') - first + 1);
+            }
+
+            if (maxExtendedLeaf >= 0x80000007)
+                add(Bit(CpuId(0x80000007)[3], 8), Feature::InvariantTsc);
+#endif
+        }
+
+        Warhead::Cpu::FeatureSet Features;
+        std::string FeaturesString;
+        std::string Brand = "Unknown";
+    };
+
+    CpuInfo const& GetCpuInfo()
+    {
+        static CpuInfo const info;
+        return info;
+    }
+}
+
+Warhead::Cpu::FeatureSet const& Warhead::Cpu::GetFeatures()
+{
+    return GetCpuInfo().Features;
+}
+
+std::string_view Warhead::Cpu::GetFeatureName(Feature feature)
+{
+    if (feature >= Feature::Count)
+        return "unknown";
+
+    return FeatureNames[uint8(feature)];
+}
+
+std::string const& Warhead::Cpu::GetFeaturesString()
+{
+    return GetCpuInfo().FeaturesString;
+}
+
+std::string const& Warhead::Cpu::GetBrand()
+{
+    return GetCpuInfo().Brand;
+}
@@ -0,0 +1,111 @@
+/*
+ * This file is part of the WarheadApp Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef _WARHEAD_CPU_INFO_H_
+#define _WARHEAD_CPU_INFO_H_
+
+#include "Define.h"
+#include <initializer_list>
+#include <string>
+#include <string_view>
+
+namespace Warhead::Cpu
+{
+    /// Instruction set extensions, AVX and newer are only reported if the OS saves their registers (XSAVE)
+    enum class Feature : uint8
+    {
+        SSE2,
+        SSE3,
+        SSSE3,
+        SSE41,
+        SSE42,
+        POPCNT,
+        AES,
+        PCLMUL,
+        AVX,
+        FMA,
+        BMI1,
+        BMI2,
+        AVX2,
+        AVX512F,
+        AVX512DQ,
+        AVX512BW,
+        AVX512VL,
+        SHA,
+        InvariantTsc,
+
+        Count
+    };
+
+    class FeatureSet
+    {
+    public:
+        constexpr FeatureSet() = default;
+        constexpr FeatureSet(std::initializer_list<Feature> features)
+        {
+            for (Feature feature : features)
+                _mask |= uint64(1) << uint8(feature);
+        }
+
+        constexpr bool Has(Feature feature) const { return (_mask & (uint64(1) << uint8(feature))) != 0; }
+        constexpr bool Contains(FeatureSet features) const { return (_mask & features._mask) == features._mask; }
+        constexpr void Add(Feature feature) { _mask |= uint64(1) << uint8(feature); }
+
+        constexpr uint64 GetMask() const { return _mask; }
+
+    private:
+        uint64 _mask = 0;
+    };
+
+    /// Detected once on first use, empty on non x86 builds
+    WH_COMMON_API FeatureSet const& GetFeatures();
+
+    inline bool Has(Feature feature) { return GetFeatures().Has(feature); }
+
+    WH_COMMON_API std::string_view GetFeatureName(Feature feature);
+
+    /// Space separated names of the detected features, "sse2 ssse3 avx2 ..."
+    WH_COMMON_API std::string const& GetFeaturesString();
+
+    /// Processor brand string, "Unknown" when the CPU does not report one
+    WH_COMMON_API std::string const& GetBrand();
+
+    /// One implementation of a function and the features it needs
+    template<class Func>
+    struct Candidate
+    {
+        FeatureSet Requires;
+        Func* Function;
+    };
+
+    /// Runtime multiversioning: returns the first candidate the CPU supports.
+    /// List candidates best first and end with one that requires nothing. Resolve once and keep the pointer:
+    ///
+    /// static auto const sum = Warhead::Cpu::Select<SumFunc>({ { { Feature::AVX2 }, SumAvx2 }, { {}, SumScalar } });
+    template<class Func>
+    Func* Select(std::initializer_list<Candidate<Func>> candidates)
+    {
+        for (auto const& candidate : candidates)
+            if (GetFeatures().Contains(candidate.Requires))
+                return candidate.Function;
+
+        return nullptr;
+    }
+}
+
+#endif // _WARHEAD_CPU_INFO_H_
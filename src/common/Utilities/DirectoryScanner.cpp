@@ -0,0 +1,341 @@
+/*
+ * This file is part of the WarheadApp Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "DirectoryScanner.h"
+#include "Log.h"
+#include <Poco/Glob.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#if WH_PLATFORM == WH_PLATFORM_WINDOWS
+#include <Poco/UnicodeConverter.h>
+#include <Windows.h>
+#else
+#include <dirent.h>
+#include <sys/stat.h>
+#endif
+
+namespace
+{
+    constexpr uint32 MAX_SCAN_THREADS = 8;
+
+    /// Calls onEntry(name, type) for every entry of a directory except "." and "..".
+    /// onEntry returns false to stop listing. Returns false if the directory could not be opened.
+    template<class Func>
+    bool ListDirectory(std::string const& directory, Func&& onEntry)
+    {
+#if WH_PLATFORM == WH_PLATFORM_WINDOWS
+        std::wstring searchPath;
+        Poco::UnicodeConverter::toUTF16(directory + "/*", searchPath);
+
+        WIN32_FIND_DATAW data;
+        HANDLE handle = FindFirstFileExW(searchPath.c_str(), FindExInfoBasic, &data, FindExSearchNameMatch, nullptr, FIND_FIRST_EX_LARGE_FETCH);
+        if (handle == INVALID_HANDLE_VALUE)
+            return false;
+
+        std::string name;
+
+        do
+        {
+            wchar_t const* fileName = data.cFileName;
+            if (fileName[0] == L'.' && (!fileName[1] || (fileName[1] == L'.' && !fileName[2])))
+                continue;
+
+            Warhead::File::EntryType type = Warhead::File::EntryType::File;
+
+            // dwReserved0 holds the reparse tag. Only symlinks and junctions point elsewhere,
+            // other tags (cloud placeholders, dedup, ...) are plain files and directories.
+            bool isLink = (data.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT) &&
+                (data.dwReserved0 == IO_REPARSE_TAG_SYMLINK || data.dwReserved0 == IO_REPARSE_TAG_MOUNT_POINT);
+
+            if (isLink)
+                type = Warhead::File::EntryType::Symlink;
+            else if (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+                type = Warhead::File::EntryType::Directory;
+            else if (data.dwFileAttributes & FILE_ATTRIBUTE_DEVICE)
+                type = Warhead::File::EntryType::Other;
+
+            name.clear();
+            Poco::UnicodeConverter::convert(fileName, name);
+
+            if (!onEntry(std::string_view(name), type))
+                break;
+
+        } while (FindNextFileW(handle, &data));
+
+        FindClose(handle);
+#else
+        DIR* handle = opendir(directory.c_str());
+        if (!handle)
+            return false;
+
+        while (dirent* entry = readdir(handle))
+        {
+            char const* fileName = entry->d_name;
+            if (fileName[0] == '.' && (!fileName[1] || (fileName[1] == '.' && !fileName[2])))
+                continue;
+
+            Warhead::File::EntryType type = Warhead::File::EntryType::Other;
+            unsigned char fileType = entry->d_type;
+
+            // Some filesystems do not fill d_type, only then pay for the stat
+            if (fileType == DT_UNKNOWN)
+            {
+                struct stat info;
+                std::string fullPath = directory + '/' + fileName;
+
+                if (!lstat(fullPath.c_str(), &info))
+                {
+                    if (S_ISREG(info.st_mode))
+                        fileType = DT_REG;
+                    else if (S_ISDIR(info.st_mode))
+                        fileType = DT_DIR;
+                    else if (S_ISLNK(info.st_mode))
+                        fileType = DT_LNK;
+                }
+            }
+
+            switch (fileType)
+            {
+                case DT_REG: type = Warhead::File::EntryType::File; break;
+                case DT_DIR: type = Warhead::File::EntryType::Directory; break;
+                case DT_LNK: type = Warhead::File::EntryType::Symlink; break;
+                default: break;
+            }
+
+            if (!onEntry(std::string_view(fileName), type))
+                break;
+        }
+
+        closedir(handle);
+#endif
+
+        return true;
+    }
+
+    /// Directories waiting to be listed, one queue per thread.
+    /// The owner works depth first from the back, idle threads steal from the front.
+    class ScanQueue
+    {
+    public:
+        void Push(std::string&& directory)
+        {
+            std::lock_guard<std::mutex> guard(_lock);
+            _directories.emplace_back(std::move(directory));
+        }
+
+        std::optional<std::string> Pop()
+        {
+            std::lock_guard<std::mutex> guard(_lock);
+            if (_directories.empty())
+                return std::nullopt;
+
+            std::string directory = std::move(_directories.back());
+            _directories.pop_back();
+            return directory;
+        }
+
+        std::optional<std::string> Steal()
+        {
+            std::lock_guard<std::mutex> guard(_lock);
+            if (_directories.empty())
+                return std::nullopt;
+
+            std::string directory = std::move(_directories.front());
+            _directories.pop_front();
+            return directory;
+        }
+
+    private:
+        std::mutex _lock;
+        std::deque<std::string> _directories;
+    };
+
+    class Scanner
+    {
+    public:
+        Scanner(Warhead::File::ScanCallback const& callback, Warhead::File::ScanOptions const& options, uint32 threads) :
+            _callback(callback), _options(options), _queues(threads) { }
+
+        /// Returns false only if the root itself could not be listed
+        bool ScanRoot(std::string const& root)
+        {
+            std::unique_ptr<Poco::Glob> glob = MakeGlob();
+
+            if (!ScanOne(0, root, glob))
+                return false;
+
+            if (_pending == 0 || _queues.size() == 1)
+            {
+                // Single threaded or nothing to descend into, drain on this thread
+                Work(0);
+                return true;
+            }
+
+            std::vector<std::thread> workers;
+            workers.reserve(_queues.size() - 1);
+
+            for (std::size_t i = 1; i < _queues.size(); ++i)
+                workers.emplace_back(&Scanner::Work, this, i);
+
+            Work(0);
+
+            for (auto& worker : workers)
+                worker.join();
+
+            return true;
+        }
+
+        bool IsStopped() const { return _stop; }
+
+    private:
+        std::unique_ptr<Poco::Glob> MakeGlob() const
+        {
+            // Poco::Glob::match is not const, every thread gets its own
+            if (_options.Pattern.empty())
+                return nullptr;
+
+            return std::make_unique<Poco::Glob>(_options.Pattern);
+        }
+
+        bool ScanOne(std::size_t index, std::string const& directory, std::unique_ptr<Poco::Glob>& glob)
+        {
+            std::string path = directory;
+            if (path.back() != '/')
+                path.push_back('/');
+            std::size_t const prefixSize = path.size();
+
+            return ListDirectory(directory, [&](std::string_view name, Warhead::File::EntryType type)
+            {
+                if (_stop)
+                    return false;
+
+                path.resize(prefixSize);
+                path.append(name);
+
+                bool isDirectory = type == Warhead::File::EntryType::Directory;
+
+                if (isDirectory && _options.Recursive)
+                {
+                    ++_pending;
+                    _queues[index].Push(std::string(path));
+                    _idle.notify_one();
+                }
+
+                if (isDirectory && !_options.IncludeDirectories)
+                    return true;
+
+                if (glob && !glob->match(std::string(name)))
+                    return true;
+
+                if (!_callback({ path, std::string_view(path).substr(prefixSize), type }))
+                    _stop = true;
+
+                return !_stop;
+            });
+        }
+
+        std::optional<std::string> Next(std::size_t index)
+        {
+            if (auto directory = _queues[index].Pop())
+                return directory;
+
+            for (std::size_t i = 1; i < _queues.size(); ++i)
+                if (auto directory = _queues[(index + i) % _queues.size()].Steal())
+                    return directory;
+
+            return std::nullopt;
+        }
+
+        void Work(std::size_t index)
+        {
+            std::unique_ptr<Poco::Glob> glob = MakeGlob();
+
+            while (!_stop)
+            {
+                if (auto directory = Next(index))
+                {
+                    // Unreadable subdirectories are skipped, same as permission denied entries
+                    ScanOne(index, *directory, glob);
+
+                    if (--_pending == 0)
+                        _idle.notify_all();
+
+                    continue;
+                }
+
+                if (_pending == 0)
+                    break;
+
+                // Another thread is still listing and may push more work.
+                // The timeout covers a push racing with going to sleep.
+                std::unique_lock<std::mutex> lock(_idleLock);
+                _idle.wait_for(lock, std::chrono::milliseconds(1));
+            }
+        }
+
+        Warhead::File::ScanCallback const& _callback;
+        Warhead::File::ScanOptions const& _options;
+        std::vector<ScanQueue> _queues;
+        std::atomic<std::size_t> _pending{ 0 }; // Queued or being listed
+        std::atomic<bool> _stop{ false };
+        std::mutex _idleLock;
+        std::condition_variable _idle;
+    };
+}
+
+bool Warhead::File::ScanDirectory(std::string const& path, ScanCallback const& callback, ScanOptions const& options /*= {}*/)
+{
+    // ScanOne reads the last character of the root, and "" is not a directory anyway
+    if (path.empty())
+    {
+        LOG_ERROR("> ScanDirectory: Empty directory path");
+        return false;
+    }
+
+    std::string root = path;
+
+    // Keep "/" and "C:/" intact, the scanner adds its own separator
+    while (root.size() > 1 && (root.back() == '/' || root.back() == '\\') && root[root.size() - 2] != ':')
+        root.pop_back();
+
+    uint32 threads = options.Threads;
+    if (!threads)
+        threads = std::clamp<uint32>(std::thread::hardware_concurrency(), 1, MAX_SCAN_THREADS);
+
+    if (!options.Recursive)
+        threads = 1;
+
+    Scanner scanner(callback, options, threads);
+
+    if (!scanner.ScanRoot(root))
+    {
+        LOG_ERROR("> ScanDirectory: Failed to open directory (%s)", root.c_str());
+        return false;
+    }
+
+    return !scanner.IsStopped();
+}
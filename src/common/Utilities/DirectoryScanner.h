@@ -0,0 +1,62 @@
+/*
+ * This file is part of the WarheadApp Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef _WARHEAD_DIRECTORY_SCANNER_H_
+#define _WARHEAD_DIRECTORY_SCANNER_H_
+
+#include "Define.h"
+#include <functional>
+#include <string>
+#include <string_view>
+
+namespace Warhead::File
+{
+    enum class EntryType : uint8
+    {
+        File,
+        Directory,
+        Symlink,    // Symlink or junction, reported but never followed
+        Other
+    };
+
+    struct ScanEntry
+    {
+        std::string_view Path;  // Full path, '/' separated
+        std::string_view Name;
+        EntryType Type;
+    };
+
+    struct ScanOptions
+    {
+        bool Recursive = true;
+        bool IncludeDirectories = false;
+        uint32 Threads = 0;     // 0 = hardware concurrency, max 8
+        std::string Pattern;    // Poco::Glob pattern matched against the entry name, empty = everything
+    };
+
+    /// Return false to stop the scan. Called concurrently from the scanner threads,
+    /// the entry is only valid for the duration of the call.
+    using ScanCallback = std::function<bool(ScanEntry const&)>;
+
+    /// Walks a directory tree without a stat per entry, the entry type comes from the listing itself.
+    /// Subdirectories are spread over the scanner threads with work stealing.
+    /// Returns false if the root is empty or could not be opened, or the callback stopped the scan.
+    WH_COMMON_API bool ScanDirectory(std::string const& path, ScanCallback const& callback, ScanOptions const& options = {});
+}
+
+#endif
@@ -0,0 +1,601 @@
+/*
+ * This file is part of the WarheadApp Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "Encoding.h"
+#include "CpuInfo.h"
+#include <cstring>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#  define WH_ENCODING_SIMD
+#  if WH_COMPILER == WH_COMPILER_MICROSOFT
+#    include <intrin.h>
+#    define WH_TARGET_SSSE3
+#    define WH_TARGET_AVX2
+#  else
+#    include <immintrin.h>
+#    define WH_TARGET_SSSE3 __attribute__((target("ssse3")))
+#    define WH_TARGET_AVX2 __attribute__((target("avx2")))
+#  endif
+#endif
+
+namespace
+{
+    constexpr uint8 INVALID = 0xFF;
+
+    constexpr char Base64Alphabets[2][65] =
+    {
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/",
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_"
+    };
+
+    constexpr char HexDigits[2][17] = { "0123456789abcdef", "0123456789ABCDEF" };
+
+    struct DecodeTable
+    {
+        uint8 Values[256];
+    };
+
+    constexpr DecodeTable MakeBase64DecodeTable(char const* alphabet)
+    {
+        DecodeTable table{};
+
+        for (auto& value : table.Values)
+            value = INVALID;
+
+        for (uint8 i = 0; i < 64; ++i)
+            table.Values[uint8(alphabet[i])] = i;
+
+        return table;
+    }
+
+    constexpr DecodeTable MakeHexDecodeTable()
+    {
+        DecodeTable table{};
+
+        for (auto& value : table.Values)
+            value = INVALID;
+
+        for (uint8 i = 0; i < 16; ++i)
+        {
+            table.Values[uint8(HexDigits[0][i])] = i;
+            table.Values[uint8(HexDigits[1][i])] = i;
+        }
+
+        return table;
+    }
+
+    constexpr DecodeTable Base64DecodeTables[2] = { MakeBase64DecodeTable(Base64Alphabets[0]), MakeBase64DecodeTable(Base64Alphabets[1]) };
+    constexpr DecodeTable HexDecodeTable = MakeHexDecodeTable();
+
+    // Block functions handle whole groups only (3 bytes or 4 characters for Base64, 2 characters for hex decoding).
+    // The decoders stop at the first invalid group and return how much they consumed.
+    using Base64EncodeFunc = std::size_t(uint8 const* data, std::size_t size, char* out, bool url);
+    using Base64DecodeFunc = std::size_t(char const* text, std::size_t size, uint8* out, bool url);
+    using HexEncodeFunc = void(uint8 const* data, std::size_t size, char* out, bool uppercase);
+    using HexDecodeFunc = std::size_t(char const* text, std::size_t size, uint8* out);
+
+    std::size_t Base64EncodeScalar(uint8 const* data, std::size_t size, char* out, bool url)
+    {
+        char const* alphabet = Base64Alphabets[url];
+        std::size_t i = 0;
+
+        for (; i + 3 <= size; i += 3, out += 4)
+        {
+            uint32 value = uint32(data[i]) << 16 | uint32(data[i + 1]) << 8 | data[i + 2];
+
+            out[0] = alphabet[value >> 18];
+            out[1] = alphabet[(value >> 12) & 0x3F];
+            out[2] = alphabet[(value >> 6) & 0x3F];
+            out[3] = alphabet[value & 0x3F];
+        }
+
+        return i;
+    }
+
+    std::size_t Base64DecodeScalar(char const* text, std::size_t size, uint8* out, bool url)
+    {
+        uint8 const* table = Base64DecodeTables[url].Values;
+        std::size_t i = 0;
+
+        for (; i + 4 <= size; i += 4, out += 3)
+        {
+            uint32 a = table[uint8(text[i])];
+            uint32 b = table[uint8(text[i + 1])];
+            uint32 c = table[uint8(text[i + 2])];
+            uint32 d = table[uint8(text[i + 3])];
+
+            if ((a | b | c | d) == INVALID)
+                break;
+
+            uint32 value = a << 18 | b << 12 | c << 6 | d;
+
+            out[0] = uint8(value >> 16);
+            out[1] = uint8(value >> 8);
+            out[2] = uint8(value);
+        }
+
+        return i;
+    }
+
+    void HexEncodeScalar(uint8 const* data, std::size_t size, char* out, bool uppercase)
+    {
+        char const* digits = HexDigits[uppercase];
+
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            out[i * 2] = digits[data[i] >> 4];
+            out[i * 2 + 1] = digits[data[i] & 0xF];
+        }
+    }
+
+    std::size_t HexDecodeScalar(char const* text, std::size_t size, uint8* out)
+    {
+        std::size_t i = 0;
+
+        for (; i + 2 <= size; i += 2, ++out)
+        {
+            uint8 high = HexDecodeTable.Values[uint8(text[i])];
+            uint8 low = HexDecodeTable.Values[uint8(text[i + 1])];
+
+            if ((high | low) == INVALID)
+                break;
+
+            *out = uint8(high << 4 | low);
+        }
+
+        return i;
+    }
+
+#ifdef WH_ENCODING_SIMD
+    // Base64 after Muła and Lemire: 3 bytes are spread over 4 lanes with a shuffle and two
+    // multiplications, indices are turned into characters by adding a per range offset.
+    // Decoding validates and maps characters with lookups on their high and low nibbles.
+
+    WH_TARGET_SSSE3 std::size_t Base64EncodeSsse3(uint8 const* data, std::size_t size, char* out, bool url)
+    {
+        __m128i const spread = _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1);
+        __m128i const offsets = url ?
+            _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '-' - 62, '_' - 63, 'A', 0, 0) :
+            _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0);
+
+        std::size_t i = 0;
+
+        // 16 byte loads of which 12 are encoded
+        for (; i + 16 <= size; i += 12, out += 16)
+        {
+            __m128i in = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<__m128i const*>(data + i)), spread);
+
+            __m128i ac = _mm_mulhi_epu16(_mm_and_si128(in, _mm_set1_epi32(0x0FC0FC00)), _mm_set1_epi32(0x04000040));
+            __m128i bd = _mm_mullo_epi16(_mm_and_si128(in, _mm_set1_epi32(0x003F03F0)), _mm_set1_epi32(0x01000010));
+            __m128i indices = _mm_or_si128(ac, bd);
+
+            // 0 for a-z, 1-10 for 0-9, 11 and 12 for the last two characters, 13 for A-Z
+            __m128i range = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+            range = _mm_or_si128(range, _mm_and_si128(_mm_cmpgt_epi8(_mm_set1_epi8(26), indices), _mm_set1_epi8(13)));
+
+            __m128i result = _mm_add_epi8(_mm_shuffle_epi8(offsets, range), indices);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out), result);
+        }
+
+        return i + Base64EncodeScalar(data + i, size - i, out, url);
+    }
+
+    WH_TARGET_AVX2 std::size_t Base64EncodeAvx2(uint8 const* data, std::size_t size, char* out, bool url)
+    {
+        __m256i const spread = _mm256_broadcastsi128_si256(_mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+        __m256i const offsets = _mm256_broadcastsi128_si256(url ?
+            _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '-' - 62, '_' - 63, 'A', 0, 0) :
+            _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0));
+
+        std::size_t i = 0;
+
+        // Two 16 byte loads 12 bytes apart, one per lane
+        for (; i + 28 <= size; i += 24, out += 32)
+        {
+            __m256i in = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<__m128i const*>(data + i))),
+                _mm_loadu_si128(reinterpret_cast<__m128i const*>(data + i + 12)), 1);
+            in = _mm256_shuffle_epi8(in, spread);
+
+            __m256i ac = _mm256_mulhi_epu16(_mm256_and_si256(in, _mm256_set1_epi32(0x0FC0FC00)), _mm256_set1_epi32(0x04000040));
+            __m256i bd = _mm256_mullo_epi16(_mm256_and_si256(in, _mm256_set1_epi32(0x003F03F0)), _mm256_set1_epi32(0x01000010));
+            __m256i indices = _mm256_or_si256(ac, bd);
+
+            __m256i range = _mm256_subs_epu8(indices, _mm256_set1_epi8(51));
+            range = _mm256_or_si256(range, _mm256_and_si256(_mm256_cmpgt_epi8(_mm256_set1_epi8(26), indices), _mm256_set1_epi8(13)));
+
+            __m256i result = _mm256_add_epi8(_mm256_shuffle_epi8(offsets, range), indices);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), result);
+        }
+
+        return i + Base64EncodeSsse3(data + i, size - i, out, url);
+    }
+
+    WH_TARGET_SSSE3 std::size_t Base64DecodeSsse3(char const* text, std::size_t size, uint8* out, bool url)
+    {
+        // A character is valid when its low and high nibble flags share no bit
+        __m128i const lowFlags = _mm_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+        __m128i const highFlags = _mm_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+        __m128i const offsets = _mm_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+        __m128i const pack = _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+        __m128i const zero = _mm_setzero_si128();
+
+        std::size_t i = 0;
+
+        for (; i + 16 <= size; i += 16, out += 12)
+        {
+            __m128i in = _mm_loadu_si128(reinterpret_cast<__m128i const*>(text + i));
+
+            if (url)
+            {
+                // Reject '+' and '/', then map '-' and '_' onto them
+                if (_mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(in, _mm_set1_epi8('+')), _mm_cmpeq_epi8(in, _mm_set1_epi8('/')))))
+                    break;
+
+                in = _mm_add_epi8(in, _mm_and_si128(_mm_cmpeq_epi8(in, _mm_set1_epi8('-')), _mm_set1_epi8('+' - '-')));
+                in = _mm_add_epi8(in, _mm_and_si128(_mm_cmpeq_epi8(in, _mm_set1_epi8('_')), _mm_set1_epi8('/' - '_')));
+            }
+
+            __m128i highNibbles = _mm_and_si128(_mm_srli_epi32(in, 4), _mm_set1_epi8(0x0F));
+            __m128i lowNibbles = _mm_and_si128(in, _mm_set1_epi8(0x0F));
+
+            __m128i flags = _mm_and_si128(_mm_shuffle_epi8(lowFlags, lowNibbles), _mm_shuffle_epi8(highFlags, highNibbles));
+            if (_mm_movemask_epi8(_mm_cmpeq_epi8(flags, zero)) != 0xFFFF)
+                break;
+
+            // '/' shares its high nibble with '+', it gets the next offset
+            __m128i slash = _mm_cmpeq_epi8(in, _mm_set1_epi8('/'));
+            __m128i values = _mm_add_epi8(in, _mm_shuffle_epi8(offsets, _mm_add_epi8(slash, highNibbles)));
+
+            // Four 6 bit values to 24 bits per 32 bit lane, then drop the fourth bytes
+            __m128i merged = _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+            merged = _mm_madd_epi16(merged, _mm_set1_epi32(0x00011000));
+            merged = _mm_shuffle_epi8(merged, pack);
+
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(out), merged);
+            uint32 last = uint32(_mm_cvtsi128_si32(_mm_srli_si128(merged, 8)));
+            std::memcpy(out + 8, &last, sizeof(last));
+        }
+
+        return i + Base64DecodeScalar(text + i, size - i, out, url);
+    }
+
+    WH_TARGET_AVX2 std::size_t Base64DecodeAvx2(char const* text, std::size_t size, uint8* out, bool url)
+    {
+        __m256i const lowFlags = _mm256_broadcastsi128_si256(_mm_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A));
+        __m256i const highFlags = _mm256_broadcastsi128_si256(_mm_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10));
+        __m256i const offsets = _mm256_broadcastsi128_si256(_mm_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0));
+        __m256i const pack = _mm256_broadcastsi128_si256(_mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+        __m256i const zero = _mm256_setzero_si256();
+
+        std::size_t i = 0;
+
+        for (; i + 32 <= size; i += 32, out += 24)
+        {
+            __m256i in = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(text + i));
+
+            if (url)
+            {
+                if (_mm256_movemask_epi8(_mm256_or_si256(_mm256_cmpeq_epi8(in, _mm256_set1_epi8('+')), _mm256_cmpeq_epi8(in, _mm256_set1_epi8('/')))))
+                    break;
+
+                in = _mm256_add_epi8(in, _mm256_and_si256(_mm256_cmpeq_epi8(in, _mm256_set1_epi8('-')), _mm256_set1_epi8('+' - '-')));
+                in = _mm256_add_epi8(in, _mm256_and_si256(_mm256_cmpeq_epi8(in, _mm256_set1_epi8('_')), _mm256_set1_epi8('/' - '_')));
+            }
+
+            __m256i highNibbles = _mm256_and_si256(_mm256_srli_epi32(in, 4), _mm256_set1_epi8(0x0F));
+            __m256i lowNibbles = _mm256_and_si256(in, _mm256_set1_epi8(0x0F));
+
+            __m256i flags = _mm256_and_si256(_mm256_shuffle_epi8(lowFlags, lowNibbles), _mm256_shuffle_epi8(highFlags, highNibbles));
+            if (uint32(_mm256_movemask_epi8(_mm256_cmpeq_epi8(flags, zero))) != 0xFFFFFFFF)
+                break;
+
+            __m256i slash = _mm256_cmpeq_epi8(in, _mm256_set1_epi8('/'));
+            __m256i values = _mm256_add_epi8(in, _mm256_shuffle_epi8(offsets, _mm256_add_epi8(slash, highNibbles)));
+
+            __m256i merged = _mm256_maddubs_epi16(values, _mm256_set1_epi32(0x01400140));
+            merged = _mm256_madd_epi16(merged, _mm256_set1_epi32(0x00011000));
+            merged = _mm256_shuffle_epi8(merged, pack);
+
+            // 12 bytes per lane, moved together into the low 24 bytes
+            merged = _mm256_permutevar8x32_epi32(merged, _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 7, 7));
+
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm256_castsi256_si128(merged));
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(out + 16), _mm256_extracti128_si256(merged, 1));
+        }
+
+        return i + Base64DecodeSsse3(text + i, size - i, out, url);
+    }
+
+    WH_TARGET_SSSE3 void HexEncodeSsse3(uint8 const* data, std::size_t size, char* out, bool uppercase)
+    {
+        __m128i const digits = _mm_loadu_si128(reinterpret_cast<__m128i const*>(HexDigits[uppercase]));
+        __m128i const mask = _mm_set1_epi8(0x0F);
+
+        std::size_t i = 0;
+
+        for (; i + 16 <= size; i += 16, out += 32)
+        {
+            __m128i in = _mm_loadu_si128(reinterpret_cast<__m128i const*>(data + i));
+            __m128i high = _mm_shuffle_epi8(digits, _mm_and_si128(_mm_srli_epi16(in, 4), mask));
+            __m128i low = _mm_shuffle_epi8(digits, _mm_and_si128(in, mask));
+
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_unpacklo_epi8(high, low));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 16), _mm_unpackhi_epi8(high, low));
+        }
+
+        HexEncodeScalar(data + i, size - i, out, uppercase);
+    }
+
+    WH_TARGET_AVX2 void HexEncodeAvx2(uint8 const* data, std::size_t size, char* out, bool uppercase)
+    {
+        __m256i const digits = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<__m128i const*>(HexDigits[uppercase])));
+        __m256i const mask = _mm256_set1_epi8(0x0F);
+
+        std::size_t i = 0;
+
+        for (; i + 32 <= size; i += 32, out += 64)
+        {
+            __m256i in = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(data + i));
+            __m256i high = _mm256_shuffle_epi8(digits, _mm256_and_si256(_mm256_srli_epi16(in, 4), mask));
+            __m256i low = _mm256_shuffle_epi8(digits, _mm256_and_si256(in, mask));
+
+            // Unpacking works per lane, put the halves back in order
+            __m256i first = _mm256_unpacklo_epi8(high, low);
+            __m256i second = _mm256_unpackhi_epi8(high, low);
+
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), _mm256_permute2x128_si256(first, second, 0x20));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + 32), _mm256_permute2x128_si256(first, second, 0x31));
+        }
+
+        HexEncodeSsse3(data + i, size - i, out, uppercase);
+    }
+
+    // Characters to nibble values, invalid characters get the high bit set
+    WH_TARGET_SSSE3 inline __m128i HexToNibblesSsse3(__m128i in)
+    {
+        __m128i digit = _mm_sub_epi8(in, _mm_set1_epi8('0'));
+        __m128i isDigit = _mm_cmpeq_epi8(_mm_min_epu8(digit, _mm_set1_epi8(9)), digit);
+
+        __m128i letter = _mm_sub_epi8(_mm_or_si128(in, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+        __m128i isLetter = _mm_cmpeq_epi8(_mm_min_epu8(letter, _mm_set1_epi8(5)), letter);
+
+        __m128i values = _mm_or_si128(_mm_and_si128(isDigit, digit), _mm_and_si128(isLetter, _mm_add_epi8(letter, _mm_set1_epi8(10))));
+        return _mm_or_si128(values, _mm_andnot_si128(_mm_or_si128(isDigit, isLetter), _mm_set1_epi8(char(0x80))));
+    }
+
+    WH_TARGET_AVX2 inline __m256i HexToNibblesAvx2(__m256i in)
+    {
+        __m256i digit = _mm256_sub_epi8(in, _mm256_set1_epi8('0'));
+        __m256i isDigit = _mm256_cmpeq_epi8(_mm256_min_epu8(digit, _mm256_set1_epi8(9)), digit);
+
+        __m256i letter = _mm256_sub_epi8(_mm256_or_si256(in, _mm256_set1_epi8(0x20)), _mm256_set1_epi8('a'));
+        __m256i isLetter = _mm256_cmpeq_epi8(_mm256_min_epu8(letter, _mm256_set1_epi8(5)), letter);
+
+        __m256i values = _mm256_or_si256(_mm256_and_si256(isDigit, digit), _mm256_and_si256(isLetter, _mm256_add_epi8(letter, _mm256_set1_epi8(10))));
+        return _mm256_or_si256(values, _mm256_andnot_si256(_mm256_or_si256(isDigit, isLetter), _mm256_set1_epi8(char(0x80))));
+    }
+
+    WH_TARGET_SSSE3 std::size_t HexDecodeSsse3(char const* text, std::size_t size, uint8* out)
+    {
+        // High nibble * 16 + low nibble for every pair
+        __m128i const weights = _mm_set1_epi16(0x0110);
+
+        std::size_t i = 0;
+
+        for (; i + 32 <= size; i += 32, out += 16)
+        {
+            __m128i first = HexToNibblesSsse3(_mm_loadu_si128(reinterpret_cast<__m128i const*>(text + i)));
+            __m128i second = HexToNibblesSsse3(_mm_loadu_si128(reinterpret_cast<__m128i const*>(text + i + 16)));
+
+            if (_mm_movemask_epi8(_mm_or_si128(first, second)))
+                break;
+
+            __m128i bytes = _mm_packus_epi16(_mm_maddubs_epi16(first, weights), _mm_maddubs_epi16(second, weights));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out), bytes);
+        }
+
+        return i + HexDecodeScalar(text + i, size - i, out);
+    }
+
+    WH_TARGET_AVX2 std::size_t HexDecodeAvx2(char const* text, std::size_t size, uint8* out)
+    {
+        __m256i const weights = _mm256_set1_epi16(0x0110);
+
+        std::size_t i = 0;
+
+        for (; i + 64 <= size; i += 64, out += 32)
+        {
+            __m256i first = HexToNibblesAvx2(_mm256_loadu_si256(reinterpret_cast<__m256i const*>(text + i)));
+            __m256i second = HexToNibblesAvx2(_mm256_loadu_si256(reinterpret_cast<__m256i const*>(text + i + 32)));
+
+            if (_mm256_movemask_epi8(_mm256_or_si256(first, second)))
+                break;
+
+            // Packing interleaves the lanes of both inputs
+            __m256i bytes = _mm256_packus_epi16(_mm256_maddubs_epi16(first, weights), _mm256_maddubs_epi16(second, weights));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), _mm256_permute4x64_epi64(bytes, 0xD8));
+        }
+
+        return i + HexDecodeSsse3(text + i, size - i, out);
+    }
+#endif
+
+    struct Codecs
+    {
+        Base64EncodeFunc* Base64Encode;
+        Base64DecodeFunc* Base64Decode;
+        HexEncodeFunc* HexEncode;
+        HexDecodeFunc* HexDecode;
+    };
+
+    Codecs const& GetCodecs()
+    {
+        static Codecs const codecs = []()
+        {
+#ifdef WH_ENCODING_SIMD
+            using Warhead::Cpu::Feature;
+            using Warhead::Cpu::Select;
+
+            return Codecs
+            {
+                Select<Base64EncodeFunc>({ { { Feature::AVX2 }, Base64EncodeAvx2 }, { { Feature::SSSE3 }, Base64EncodeSsse3 }, { {}, Base64EncodeScalar } }),
+                Select<Base64DecodeFunc>({ { { Feature::AVX2 }, Base64DecodeAvx2 }, { { Feature::SSSE3 }, Base64DecodeSsse3 }, { {}, Base64DecodeScalar } }),
+                Select<HexEncodeFunc>({ { { Feature::AVX2 }, HexEncodeAvx2 }, { { Feature::SSSE3 }, HexEncodeSsse3 }, { {}, HexEncodeScalar } }),
+                Select<HexDecodeFunc>({ { { Feature::AVX2 }, HexDecodeAvx2 }, { { Feature::SSSE3 }, HexDecodeSsse3 }, { {}, HexDecodeScalar } })
+            };
+#else
+            return Codecs{ Base64EncodeScalar, Base64DecodeScalar, HexEncodeScalar, HexDecodeScalar };
+#endif
+        }();
+
+        return codecs;
+    }
+}
+
+std::size_t Warhead::Encoding::Base64Encode(void const* data, std::size_t size, char* out, int options /*= 0*/)
+{
+    bool url = (options & Poco::BASE64_URL_ENCODING) != 0;
+    auto bytes = static_cast<uint8 const*>(data);
+
+    std::size_t done = GetCodecs().Base64Encode(bytes, size, out, url);
+    char* end = out + done / 3 * 4;
+
+    // Last one or two bytes
+    if (std::size_t remaining = size - done)
+    {
+        char const* alphabet = Base64Alphabets[url];
+        bool padding = !(options & Poco::BASE64_NO_PADDING);
+        uint32 value = uint32(bytes[done]) << 16 | (remaining == 2 ? uint32(bytes[done + 1]) << 8 : 0);
+
+        *end++ = alphabet[value >> 18];
+        *end++ = alphabet[(value >> 12) & 0x3F];
+
+        if (remaining == 2)
+            *end++ = alphabet[(value >> 6) & 0x3F];
+        else if (padding)
+            *end++ = '=';
+
+        if (padding)
+            *end++ = '=';
+    }
+
+    return std::size_t(end - out);
+}
+
+std::string Warhead::Encoding::Base64Encode(void const* data, std::size_t size, int options /*= 0*/)
+{
+    std::string result(GetBase64EncodedSize(size, options), '\0');
+    Base64Encode(data, size, result.data(), options);
+    return result;
+}
+
+std::optional<std::size_t> Warhead::Encoding::Base64Decode(char const* text, std::size_t size, void* out, int options /*= 0*/)
+{
+    bool url = (options & Poco::BASE64_URL_ENCODING) != 0;
+
+    // Padding only completes the last group
+    if (size && size % 4 == 0 && text[size - 1] == '=')
+    {
+        --size;
+
+        if (text[size - 1] == '=')
+            --size;
+    }
+
+    if (size % 4 == 1)
+        return {};
+
+    auto start = static_cast<uint8*>(out);
+
+    std::size_t done = GetCodecs().Base64Decode(text, size, start, url);
+    if (done != size / 4 * 4)
+        return {};
+
+    uint8* end = start + done / 4 * 3;
+
+    // Last two or three characters
+    if (std::size_t remaining = size - done)
+    {
+        uint8 const* table = Base64DecodeTables[url].Values;
+        uint32 value = 0;
+
+        for (std::size_t i = 0; i < remaining; ++i)
+        {
+            uint8 digit = table[uint8(text[done + i])];
+            if (digit == INVALID)
+                return {};
+
+            value = value << 6 | digit;
+        }
+
+        if (remaining == 2)
+            *end++ = uint8(value >> 4);
+        else
+        {
+            *end++ = uint8(value >> 10);
+            *end++ = uint8(value >> 2);
+        }
+    }
+
+    return std::size_t(end - start);
+}
+
+std::optional<std::vector<uint8>> Warhead::Encoding::Base64Decode(std::string_view text, int options /*= 0*/)
+{
+    std::vector<uint8> result(GetBase64DecodedMaxSize(text.size()));
+
+    auto size = Base64Decode(text.data(), text.size(), result.data(), options);
+    if (!size)
+        return {};
+
+    result.resize(*size);
+    return result;
+}
+
+void Warhead::Encoding::HexEncode(void const* data, std::size_t size, char* out, bool uppercase /*= false*/)
+{
+    GetCodecs().HexEncode(static_cast<uint8 const*>(data), size, out, uppercase);
+}
+
+std::string Warhead::Encoding::HexEncode(void const* data, std::size_t size, bool uppercase /*= false*/)
+{
+    std::string result(size * 2, '\0');
+    HexEncode(data, size, result.data(), uppercase);
+    return result;
+}
+
+std::optional<std::size_t> Warhead::Encoding::HexDecode(char const* text, std::size_t size, void* out)
+{
+    if (size % 2)
+        return {};
+
+    if (GetCodecs().HexDecode(text, size, static_cast<uint8*>(out)) != size)
+        return {};
+
+    return size / 2;
+}
+
+std::optional<std::vector<uint8>> Warhead::Encoding::HexDecode(std::string_view text)
+{
+    std::vector<uint8> result(text.size() / 2);
+
+    if (!HexDecode(text.data(), text.size(), result.data()))
+        return {};
+
+    return result;
+}
@@ -0,0 +1,70 @@
+/*
+ * This file is part of the WarheadApp Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef _WARHEAD_ENCODING_H_
+#define _WARHEAD_ENCODING_H_
+
+#include "Define.h"
+#include <Poco/Base64Encoder.h>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/// Buffer to buffer Base64 and hex codecs, the counterparts of Poco's
+/// Base64Encoder/Base64Decoder and HexBinaryEncoder/HexBinaryDecoder streams.
+/// Whole blocks go through AVX2 or SSSE3 when the CPU has them, the rest is scalar.
+///
+/// Unlike the Poco decoders these are strict: whitespace and line breaks are invalid input.
+namespace Warhead::Encoding
+{
+    /// Options are Poco::Base64EncodingOptions, BASE64_URL_ENCODING and BASE64_NO_PADDING
+    constexpr std::size_t GetBase64EncodedSize(std::size_t size, int options = 0)
+    {
+        if (options & Poco::BASE64_NO_PADDING)
+            return size / 3 * 4 + (size % 3 ? size % 3 + 1 : 0);
+
+        return (size + 2) / 3 * 4;
+    }
+
+    /// Upper bound, padding makes the actual size up to two bytes smaller
+    constexpr std::size_t GetBase64DecodedMaxSize(std::size_t size)
+    {
+        return size / 4 * 3 + (size % 4 ? size % 4 - 1 : 0);
+    }
+
+    /// Writes GetBase64EncodedSize(size, options) characters and returns that count
+    WH_COMMON_API std::size_t Base64Encode(void const* data, std::size_t size, char* out, int options = 0);
+    WH_COMMON_API std::string Base64Encode(void const* data, std::size_t size, int options = 0);
+
+    /// Padding is optional, only BASE64_URL_ENCODING matters. out needs GetBase64DecodedMaxSize(size) bytes.
+    /// Returns the decoded size, nothing on invalid input.
+    WH_COMMON_API std::optional<std::size_t> Base64Decode(char const* text, std::size_t size, void* out, int options = 0);
+    WH_COMMON_API std::optional<std::vector<uint8>> Base64Decode(std::string_view text, int options = 0);
+
+    /// Writes size * 2 characters
+    WH_COMMON_API void HexEncode(void const* data, std::size_t size, char* out, bool uppercase = false);
+    WH_COMMON_API std::string HexEncode(void const* data, std::size_t size, bool uppercase = false);
+
+    /// Accepts both cases. out needs size / 2 bytes.
+    /// Returns the decoded size, nothing on an odd size or a non hex character.
+    WH_COMMON_API std::optional<std::size_t> HexDecode(char const* text, std::size_t size, void* out);
+    WH_COMMON_API std::optional<std::vector<uint8>> HexDecode(std::string_view text);
+}
+
+#endif // _WARHEAD_ENCODING_H_
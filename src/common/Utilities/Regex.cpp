@@ -0,0 +1,123 @@
+/*
+ * This file is part of the WarheadApp Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "Regex.h"
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+namespace
+{
+    struct RegexKey
+    {
+        std::string Pattern;
+        int Options;
+
+        bool operator==(RegexKey const& right) const
+        {
+            return Options == right.Options && Pattern == right.Pattern;
+        }
+    };
+
+    struct RegexKeyHash
+    {
+        std::size_t operator()(RegexKey const& key) const
+        {
+            return std::hash<std::string>()(key.Pattern) ^ (std::hash<int>()(key.Options) << 1);
+        }
+    };
+
+    using RegexPtr = std::shared_ptr<Poco::RegularExpression const>;
+    using RegexList = std::list<std::pair<RegexKey, RegexPtr>>;
+
+    // Front of the list is the most recently used pattern
+    RegexList _regexList;
+    std::unordered_map<RegexKey, RegexList::iterator, RegexKeyHash> _regexMap;
+    std::size_t _capacity = Warhead::RegexCache::DEFAULT_CAPACITY;
+    std::mutex _regexLock;
+
+    void EvictOverflow()
+    {
+        while (_regexList.size() > _capacity)
+        {
+            _regexMap.erase(_regexList.back().first);
+            _regexList.pop_back();
+        }
+    }
+}
+
+Warhead::Regex::Regex(std::string const& pattern, int options /*= DEFAULT_OPTIONS*/) :
+    _regex(RegexCache::Get(pattern, options)) { }
+
+uint32 Warhead::Regex::Replace(std::string& subject, std::string const& replacement, int options /*= Poco::RegularExpression::RE_GLOBAL*/) const
+{
+    return _regex->subst(subject, replacement, options);
+}
+
+bool Warhead::Regex::Match(std::string const& subject, std::size_t offset /*= 0*/) const
+{
+    return _regex->match(subject, offset);
+}
+
+std::shared_ptr<Poco::RegularExpression const> Warhead::RegexCache::Get(std::string const& pattern, int options)
+{
+    RegexKey key{ pattern, options };
+
+    {
+        std::lock_guard<std::mutex> lock(_regexLock);
+
+        auto const& itr = _regexMap.find(key);
+        if (itr != _regexMap.end())
+        {
+            _regexList.splice(_regexList.begin(), _regexList, itr->second);
+            return itr->second->second;
+        }
+    }
+
+    // Compile outside of the lock, a concurrent miss on the same pattern only costs one extra compile
+    auto regex = std::make_shared<Poco::RegularExpression const>(pattern, options, true);
+
+    std::lock_guard<std::mutex> lock(_regexLock);
+
+    auto const& itr = _regexMap.find(key);
+    if (itr != _regexMap.end())
+    {
+        _regexList.splice(_regexList.begin(), _regexList, itr->second);
+        return itr->second->second;
+    }
+
+    _regexList.emplace_front(key, regex);
+    _regexMap.emplace(std::move(key), _regexList.begin());
+    EvictOverflow();
+
+    return regex;
+}
+
+void Warhead::RegexCache::SetCapacity(std::size_t capacity)
+{
+    std::lock_guard<std::mutex> lock(_regexLock);
+    _capacity = capacity ? capacity : 1;
+    EvictOverflow();
+}
+
+void Warhead::RegexCache::Clear()
+{
+    std::lock_guard<std::mutex> lock(_regexLock);
+    _regexMap.clear();
+    _regexList.clear();
+}
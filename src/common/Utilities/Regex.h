@@ -0,0 +1,65 @@
+/*
+ * This file is part of the WarheadApp Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef _WARHEAD_REGEX_H_
+#define _WARHEAD_REGEX_H_
+
+#include "Define.h"
+#include <Poco/RegularExpression.h>
+#include <memory>
+#include <string>
+
+namespace Warhead
+{
+    /// Precompiled regular expression handle.
+    /// Patterns are compiled and studied once and shared through the process wide regex cache,
+    /// so constructing a handle for an already used pattern does not recompile it.
+    class WH_COMMON_API Regex
+    {
+    public:
+        static constexpr int DEFAULT_OPTIONS = Poco::RegularExpression::RE_MULTILINE;
+
+        explicit Regex(std::string const& pattern, int options = DEFAULT_OPTIONS);
+
+        /// Replaces all matches in subject. Returns the number of replaced substrings.
+        uint32 Replace(std::string& subject, std::string const& replacement, int options = Poco::RegularExpression::RE_GLOBAL) const;
+
+        /// Returns true if the whole subject, starting at offset, matches the pattern
+        bool Match(std::string const& subject, std::size_t offset = 0) const;
+
+        Poco::RegularExpression const& GetRegularExpression() const { return *_regex; }
+
+    private:
+        std::shared_ptr<Poco::RegularExpression const> _regex;
+    };
+}
+
+namespace Warhead::RegexCache
+{
+    constexpr std::size_t DEFAULT_CAPACITY = 128;
+
+    /// Returns the compiled pattern from the cache, compiles and adds it if missing.
+    /// Thread-safe, the least recently used pattern is evicted when the cache is full.
+    /// Throws Poco::RegularExpressionException if the pattern is invalid.
+    WH_COMMON_API std::shared_ptr<Poco::RegularExpression const> Get(std::string const& pattern, int options);
+
+    WH_COMMON_API void SetCapacity(std::size_t capacity);
+    WH_COMMON_API void Clear();
+}
+
+#endif // _WARHEAD_REGEX_H_
@@ -0,0 +1,114 @@
+/*
+ * This file is part of the WarheadApp Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "StopWatch.h"
+#include "StringFormat.h"
+#include <algorithm>
+
+#if WH_COMPILER == WH_COMPILER_MICROSOFT
+#include <intrin.h>
+#endif
+
+namespace
+{
+    std::size_t GetBucketIndex(uint64 value)
+    {
+        if (!value)
+            return 0;
+
+#if WH_COMPILER == WH_COMPILER_MICROSOFT && defined(_M_X64)
+        unsigned long index;
+        _BitScanReverse64(&index, value);
+        return std::size_t(index) + 1;
+#elif WH_COMPILER == WH_COMPILER_GNU
+        return std::size_t(64 - __builtin_clzll(value));
+#else
+        std::size_t index = 0;
+
+        while (value)
+        {
+            value >>= 1;
+            ++index;
+        }
+
+        return index;
+#endif
+    }
+
+    uint64 GetBucketUpperBound(std::size_t index)
+    {
+        if (!index)
+            return 0;
+
+        return index >= 64 ? UINT64_MAX : (UI64LIT(1) << index) - 1;
+    }
+}
+
+void Warhead::Time::Histogram::Record(uint64 value)
+{
+    _buckets[GetBucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+    _count.fetch_add(1, std::memory_order_relaxed);
+    _total.fetch_add(value, std::memory_order_relaxed);
+
+    uint64 max = _max.load(std::memory_order_relaxed);
+    while (value > max && !_max.compare_exchange_weak(max, value, std::memory_order_relaxed)) { }
+}
+
+void Warhead::Time::Histogram::Reset()
+{
+    for (auto& bucket : _buckets)
+        bucket.store(0, std::memory_order_relaxed);
+
+    _count.store(0, std::memory_order_relaxed);
+    _total.store(0, std::memory_order_relaxed);
+    _max.store(0, std::memory_order_relaxed);
+}
+
+uint64 Warhead::Time::Histogram::GetMean() const
+{
+    uint64 count = GetCount();
+    return count ? GetTotal() / count : 0;
+}
+
+uint64 Warhead::Time::Histogram::GetPercentile(double percentile) const
+{
+    uint64 count = GetCount();
+    if (!count)
+        return 0;
+
+    uint64 target = uint64(double(count) * percentile / 100.0);
+    if (!target)
+        target = 1;
+
+    uint64 seen = 0;
+
+    for (std::size_t i = 0; i < BUCKET_COUNT; ++i)
+    {
+        seen += GetBucket(i);
+        if (seen >= target)
+            return std::min(GetBucketUpperBound(i), GetMax());
+    }
+
+    return GetMax();
+}
+
+std::string Warhead::Time::Histogram::ToString() const
+{
+    return Warhead::StringFormat("count: " UI64FMTD " mean: " UI64FMTD "ns p50: " UI64FMTD "ns p99: " UI64FMTD "ns max: " UI64FMTD "ns",
+        GetCount(), GetMean(), GetPercentile(50.0), GetPercentile(99.0), GetMax());
+}
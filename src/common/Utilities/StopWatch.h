@@ -0,0 +1,86 @@
+/*
+ * This file is part of the WarheadApp Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef _WARHEAD_STOPWATCH_H_
+#define _WARHEAD_STOPWATCH_H_
+
+#include "Define.h"
+#include "Timer.h"
+#include <array>
+#include <atomic>
+
+namespace Warhead::Time
+{
+    /// Lock-free latency histogram with power of two buckets, values in nanoseconds.
+    /// Bucket N holds values in range [2^(N-1), 2^N), bucket 0 holds zero.
+    class WH_COMMON_API Histogram
+    {
+    public:
+        static constexpr std::size_t BUCKET_COUNT = 65;
+
+        Histogram() = default;
+        Histogram(Histogram const&) = delete;
+        Histogram& operator=(Histogram const&) = delete;
+
+        void Record(uint64 value);
+        void Reset();
+
+        uint64 GetCount() const { return _count.load(std::memory_order_relaxed); }
+        uint64 GetTotal() const { return _total.load(std::memory_order_relaxed); }
+        uint64 GetMax() const { return _max.load(std::memory_order_relaxed); }
+        uint64 GetMean() const;
+        uint64 GetBucket(std::size_t index) const { return _buckets[index].load(std::memory_order_relaxed); }
+
+        /// Upper bound of the bucket holding the given percentile (0-100), capped at the max
+        uint64 GetPercentile(double percentile) const;
+
+        /// Example: "count: 10 mean: 120ns p50: 128ns p99: 250ns max: 250ns"
+        std::string ToString() const;
+
+    private:
+        std::array<std::atomic<uint64>, BUCKET_COUNT> _buckets{};
+        std::atomic<uint64> _count{ 0 };
+        std::atomic<uint64> _total{ 0 };
+        std::atomic<uint64> _max{ 0 };
+    };
+
+    /// Scoped timer, records the time elapsed since construction into the histogram on destruction.
+    ///
+    /// static Warhead::Time::Histogram parseTime;
+    /// {
+    ///     Warhead::Time::StopWatch sw(parseTime);
+    ///     Parse();
+    /// }
+    class StopWatch
+    {
+    public:
+        explicit StopWatch(Histogram& histogram) : _histogram(histogram), _start(Now()) { }
+        ~StopWatch() { _histogram.Record(Now() - _start); }
+
+        StopWatch(StopWatch const&) = delete;
+        StopWatch& operator=(StopWatch const&) = delete;
+
+        uint64 GetElapsed() const { return Now() - _start; }
+
+    private:
+        Histogram& _histogram;
+        uint64 _start;
+    };
+}
+
+#endif // _WARHEAD_STOPWATCH_H_
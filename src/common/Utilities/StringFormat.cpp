@@ -17,14 +17,22 @@
 
 #include "StringFormat.h"
 #include "Log.h"
+#include "Regex.h"
 #include <Poco/Exception.h>
-#include <Poco/RegularExpression.h>
 #include <Poco/String.h>
 #include <locale>
 
+namespace
+{
+    constexpr bool IsSpace(char c)
+    {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f' || c == '\r';
+    }
+}
+
 std::string Warhead::String::Trim(std::string& str)
 {
-    return Poco::trim(str);
+    return std::string(TrimView(str));
 }
 
 template<class Str>
@@ -53,7 +61,7 @@ WH_COMMON_API Str Warhead::String::Trim(const Str& s, const std::locale& loc /*=
 
 std::string Warhead::String::TrimLeft(std::string& str)
 {
-    return Poco::trimLeft(str);
+    return std::string(TrimLeftView(str));
 }
 
 std::string Warhead::String::TrimLeftInPlace(std::string& str)
@@ -63,7 +71,7 @@ std::string Warhead::String::TrimLeftInPlace(std::string& str)
 
 std::string Warhead::String::TrimRight(std::string& str)
 {
-    return Poco::trimRight(str);
+    return std::string(TrimRightView(str));
 }
 
 std::string Warhead::String::TrimRightInPlace(std::string& str)
@@ -73,20 +81,68 @@ std::string Warhead::String::TrimRightInPlace(std::string& str)
 
 std::string Warhead::String::Replace(std::string& str, std::string const& from, std::string const& to)
 {
-    return Poco::replace(str, from, to);
+    return ReplaceAll(str, from, to);
 }
 
 std::string Warhead::String::ReplaceInPlace(std::string& str, std::string const& from, std::string const& to)
 {
-    return Poco::replaceInPlace(str, from, to);
+    str = ReplaceAll(str, from, to);
+    return str;
+}
+
+std::string_view Warhead::String::TrimView(std::string_view str)
+{
+    return TrimRightView(TrimLeftView(str));
+}
+
+std::string_view Warhead::String::TrimLeftView(std::string_view str)
+{
+    size_t first = 0;
+
+    while (first < str.size() && IsSpace(str[first]))
+        ++first;
+
+    return str.substr(first);
+}
+
+std::string_view Warhead::String::TrimRightView(std::string_view str)
+{
+    size_t last = str.size();
+
+    while (last > 0 && IsSpace(str[last - 1]))
+        --last;
+
+    return str.substr(0, last);
+}
+
+std::string Warhead::String::ReplaceAll(std::string_view str, std::string_view from, std::string_view to)
+{
+    size_t pos = from.empty() ? std::string_view::npos : str.find(from);
+    if (pos == std::string_view::npos)
+        return std::string(str);
+
+    // Enough unless 'to' is longer than 'from', then append grows it geometrically
+    std::string result;
+    result.reserve(str.size());
+
+    size_t start = 0;
+
+    for (; pos != std::string_view::npos; pos = str.find(from, start))
+    {
+        result.append(str.data() + start, pos - start);
+        result.append(to.data(), to.size());
+        start = pos + from.size();
+    }
+
+    result.append(str.data() + start, str.size() - start);
+    return result;
 }
 
 uint32 Warhead::String::PatternReplace(std::string& subject, const std::string& pattern, const std::string& replacement)
 {
     try
     {
-        Poco::RegularExpression re(pattern, Poco::RegularExpression::RE_MULTILINE);
-        return re.subst(subject, replacement, Poco::RegularExpression::RE_GLOBAL);
+        return Warhead::Regex(pattern).Replace(subject, replacement);
     }
     catch (const Poco::Exception& e)
     {
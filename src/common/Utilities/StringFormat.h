@@ -18,8 +18,10 @@
 #ifndef _STRING_FORMAT_H_
 #define _STRING_FORMAT_H_
 
+#include "Arena.h"
 #include "Define.h"
 #include <fmt/printf.h>
+#include <string_view>
 
 namespace Warhead
 {
@@ -38,6 +40,27 @@ namespace Warhead
         }
     }
 
+    /// StringFormat into the arena, for messages only needed until the arena is reset or rewound.
+    /// Formatted on the stack and copied once, no heap allocation while the arena has room.
+    template<typename Format, typename... Args>
+    inline std::string_view StringFormat(Arena& arena, Format&& fmt, Args&&... args)
+    {
+        fmt::memory_buffer buffer;
+
+        try
+        {
+            using context = fmt::basic_printf_context_t<char>;
+            fmt::vprintf(buffer, fmt::to_string_view(fmt), fmt::basic_format_args<context>(fmt::make_format_args<context>(args...)));
+        }
+        catch (const fmt::format_error& formatError)
+        {
+            std::string error = "An error occurred formatting string \"" + std::string(fmt) + "\" : " + std::string(formatError.what());
+            return arena.CopyString(error);
+        }
+
+        return arena.CopyString(std::string_view(buffer.data(), buffer.size()));
+    }
+
     /// Returns true if the given char pointer is null.
     inline bool IsFormatEmptyOrNull(char const* fmt)
     {
@@ -64,7 +87,26 @@ namespace Warhead::String
     WH_COMMON_API std::string Replace(std::string& str, std::string const& from, std::string const& to);
     WH_COMMON_API std::string ReplaceInPlace(std::string& str, std::string const& from, std::string const& to);
 
-    // RegularExpression
+    /// Non-allocating trim functions. Return a view into the given string with ASCII whitespace removed.
+    WH_COMMON_API std::string_view TrimView(std::string_view str);
+    WH_COMMON_API std::string_view TrimLeftView(std::string_view str);
+    WH_COMMON_API std::string_view TrimRightView(std::string_view str);
+
+    /* this would return string_view into temporary otherwise */
+    std::string_view TrimView(std::string&&) = delete;
+    std::string_view TrimLeftView(std::string&&) = delete;
+    std::string_view TrimRightView(std::string&&) = delete;
+
+    /* the delete overload means we need to make this explicit */
+    inline std::string_view TrimView(char const* str) { return TrimView(std::string_view(str ? str : "")); }
+    inline std::string_view TrimLeftView(char const* str) { return TrimLeftView(std::string_view(str ? str : "")); }
+    inline std::string_view TrimRightView(char const* str) { return TrimRightView(std::string_view(str ? str : "")); }
+
+    /// Replaces all occurrences of 'from' with 'to' in one scan, Replace and ReplaceInPlace use it.
+    /// An empty 'from' leaves the string as it is.
+    WH_COMMON_API std::string ReplaceAll(std::string_view str, std::string_view from, std::string_view to);
+
+    // RegularExpression, compiled patterns are reused through Warhead::RegexCache
     WH_COMMON_API uint32 PatternReplace(std::string& subject, const std::string& pattern, const std::string& replacement);
 }
 
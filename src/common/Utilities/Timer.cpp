@@ -16,13 +16,20 @@
  */
 
 #include "Timer.h"
-#include "StringFormat.h"
+#include "CpuInfo.h"
+#include "TimestampFormatter.h"
 #include <Poco/DateTime.h>
 #include <Poco/DateTimeFormat.h>
 #include <Poco/DateTimeFormatter.h>
-#include <Poco/Timespan.h>
-#include <sstream>
-#include <iomanip>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#  define WH_TIMER_TSC
+#  if WH_COMPILER == WH_COMPILER_MICROSOFT
+#    include <intrin.h>
+#  else
+#    include <x86intrin.h>
+#  endif
+#endif
 
 #if (defined(WIN32) || defined(_WIN32) || defined(__WIN32__))
 struct tm* localtime_r(time_t const* time, struct tm* result)
@@ -32,6 +39,79 @@ struct tm* localtime_r(time_t const* time, struct tm* result)
 }
 #endif
 
+namespace
+{
+    uint64 SteadyNow()
+    {
+        using namespace std::chrono;
+        return uint64(duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count());
+    }
+
+    struct TscClock
+    {
+        TscClock()
+        {
+#ifdef WH_TIMER_TSC
+            Invariant = Warhead::Cpu::Has(Warhead::Cpu::Feature::InvariantTsc);
+            if (!Invariant)
+                return;
+
+            // Calibrate against steady_clock over ~10ms
+            uint64 startNs = SteadyNow();
+            uint64 startTicks = __rdtsc();
+            uint64 endNs = startNs;
+
+            while (endNs - startNs < 10000000)
+                endNs = SteadyNow();
+
+            uint64 endTicks = __rdtsc();
+
+            if (endTicks <= startTicks)
+            {
+                Invariant = false;
+                return;
+            }
+
+            NsPerTick = double(endNs - startNs) / double(endTicks - startTicks);
+            BaseNs = endNs;
+            BaseTicks = endTicks;
+#endif
+        }
+
+        bool Invariant = false;
+        double NsPerTick = 0.0;
+        uint64 BaseNs = 0;
+        uint64 BaseTicks = 0;
+    };
+
+    TscClock const& GetTscClock()
+    {
+        static TscClock const clock;
+        return clock;
+    }
+}
+
+uint64 Warhead::Time::Now()
+{
+    TscClock const& clock = GetTscClock();
+
+#ifdef WH_TIMER_TSC
+    if (clock.Invariant)
+    {
+        // Signed, another core may read a counter slightly behind the calibrating one
+        int64 ticks = int64(__rdtsc() - clock.BaseTicks);
+        return clock.BaseNs + uint64(int64(double(ticks) * clock.NsPerTick));
+    }
+#endif
+
+    return SteadyNow();
+}
+
+bool Warhead::Time::IsTscClock()
+{
+    return GetTscClock().Invariant;
+}
+
 template<>
 WH_COMMON_API uint32 Warhead::Time::TimeStringTo<Seconds>(std::string_view timestring)
 {
@@ -75,107 +155,111 @@ WH_COMMON_API uint32 Warhead::Time::TimeStringTo<Seconds>(std::string_view times
     return secs;
 }
 
-template<>
-WH_COMMON_API std::string Warhead::Time::ToTimeString<Microseconds>(uint64 durationTime, TimeOutput timeOutput /*= TimeOutput::Seconds*/, TimeFormat timeFormat /*= TimeFormat::ShortText*/)
+void Warhead::Time::AppendTimeString(fmt::memory_buffer& buffer, uint64 durationTime, TimeOutput timeOutput /*= TimeOutput::Seconds*/, TimeFormat timeFormat /*= TimeFormat::ShortText*/)
 {
-    Poco::Timespan span(durationTime);
-
-    uint32 microsecs = span.microseconds();
-    uint32 millisecs = span.milliseconds();
-    uint32 secs = span.seconds();
-    uint32 minutes = span.minutes();
-    uint32 hours = span.hours();
-    uint32 days = span.days();
+    uint32 microsecs = uint32(durationTime % 1000);
+    uint32 millisecs = uint32(durationTime / 1000 % 1000);
+    uint32 secs = uint32(durationTime / 1000000 % MINUTE);
+    uint32 minutes = uint32(durationTime / (1000000ull * MINUTE) % 60);
+    uint32 hours = uint32(durationTime / (1000000ull * HOUR) % 24);
+    uint32 days = uint32(durationTime / (1000000ull * DAY));
 
     if (timeFormat == TimeFormat::Numeric)
     {
         if (days)
-            return Warhead::StringFormat("%u:%02u:%02u:%02u:%02u", days, hours, minutes, secs, millisecs);
+            fmt::format_to(buffer, "{}:{:02}:{:02}:{:02}:{:02}", days, hours, minutes, secs, millisecs);
         else if (hours)
-            return Warhead::StringFormat("%u:%02u:%02u:%02u", hours, minutes, secs, millisecs);
+            fmt::format_to(buffer, "{}:{:02}:{:02}:{:02}", hours, minutes, secs, millisecs);
         else if (minutes)
-            return Warhead::StringFormat("%u:%02u:%02u", minutes, secs, millisecs);
+            fmt::format_to(buffer, "{}:{:02}:{:02}", minutes, secs, millisecs);
         else if (secs)
-            return Warhead::StringFormat("%u:%02u", secs, millisecs);
+            fmt::format_to(buffer, "{}:{:02}", secs, millisecs);
         else // millisecs
-            return Warhead::StringFormat("%u", millisecs);
-    }
+            fmt::format_to(buffer, "{}", millisecs);
 
-    std::ostringstream ss;
-    std::string stringTime;
+        return;
+    }
 
-    auto GetStringFormat = [&](uint32 timeType, std::string_view shortText, std::string_view fullText1, std::string_view fullText)
+    struct TimeUnit
     {
-        ss << timeType;
-
-        switch (timeFormat)
-        {
-            case TimeFormat::ShortText:
-                ss << shortText;
-                break;
-            case TimeFormat::FullText:
-                ss << (timeType == 1 ? fullText1 : fullText);
-                break;
-            default:
-                ss << "<Unknown time format>";
-        }
+        uint32 Value;
+        TimeOutput Output;
+        std::string_view ShortText;
+        std::string_view FullText1;
+        std::string_view FullText;
     };
 
-    if (days || timeOutput == TimeOutput::Days)
-        GetStringFormat(days, "d ", " Day ", " Days ");
-
-    if (timeOutput == TimeOutput::Days)
-        stringTime = ss.str();
-
-    if (hours || timeOutput == TimeOutput::Hours)
-        GetStringFormat(hours, "h ", " Hour ", " Hours ");
+    TimeUnit const units[] =
+    {
+        { days,      TimeOutput::Days,         "d",  " Day",         " Days"         },
+        { hours,     TimeOutput::Hours,        "h",  " Hour",        " Hours"        },
+        { minutes,   TimeOutput::Minutes,      "m",  " Minute",      " Minutes"      },
+        { secs,      TimeOutput::Seconds,      "s",  " Second",      " Seconds"      },
+        { millisecs, TimeOutput::Milliseconds, "ms", " Millisecond", " Milliseconds" },
+        { microsecs, TimeOutput::Microseconds, "us", " Microsecond", " Microseconds" }
+    };
 
-    if (timeOutput == TimeOutput::Hours)
-        stringTime = ss.str();
+    bool first = true;
 
-    if (minutes || timeOutput == TimeOutput::Minutes)
-        GetStringFormat(minutes, "m ", " Minute ", " Minutes ");
+    // Print all non zero units up to timeOutput, timeOutput itself is printed even if zero
+    for (TimeUnit const& unit : units)
+    {
+        if (unit.Output > timeOutput)
+            break;
 
-    if (timeOutput == TimeOutput::Minutes)
-        stringTime = ss.str();
+        if (!unit.Value && unit.Output != timeOutput)
+            continue;
 
-    if (secs || timeOutput == TimeOutput::Seconds)
-        GetStringFormat(secs, "s ", " Second ", " Seconds ");
+        if (!first)
+            buffer.push_back(' ');
 
-    if (timeOutput == TimeOutput::Seconds)
-        stringTime = ss.str();
+        first = false;
 
-    if (millisecs || timeOutput == TimeOutput::Milliseconds)
-        GetStringFormat(millisecs, "ms ", " Millisecond ", " Milliseconds ");
+        fmt::format_to(buffer, "{}", unit.Value);
 
-    if (timeOutput == TimeOutput::Milliseconds)
-        stringTime = ss.str();
+        std::string_view text;
 
-    if (millisecs || timeOutput == TimeOutput::Milliseconds)
-        GetStringFormat(microsecs, "us ", " Microsecond ", " Microseconds ");
+        switch (timeFormat)
+        {
+            case TimeFormat::ShortText:
+                text = unit.ShortText;
+                break;
+            case TimeFormat::FullText:
+                text = unit.Value == 1 ? unit.FullText1 : unit.FullText;
+                break;
+            default:
+                text = "<Unknown time format>";
+                break;
+        }
 
-    if (timeOutput == TimeOutput::Microseconds)
-        stringTime = ss.str();
+        buffer.append(text.data(), text.data() + text.size());
+    }
+}
 
-    return Warhead::String::TrimRightInPlace(stringTime);
+template<>
+WH_COMMON_API std::string Warhead::Time::ToTimeString<Microseconds>(uint64 durationTime, TimeOutput timeOutput /*= TimeOutput::Seconds*/, TimeFormat timeFormat /*= TimeFormat::ShortText*/)
+{
+    fmt::memory_buffer buffer;
+    AppendTimeString(buffer, durationTime, timeOutput, timeFormat);
+    return fmt::to_string(buffer);
 }
 
 template<>
 WH_COMMON_API std::string Warhead::Time::ToTimeString<Milliseconds>(uint64 durationTime, TimeOutput timeOutput /*= TimeOutput::Seconds*/, TimeFormat timeFormat /*= TimeFormat::ShortText*/)
 {
-    return ToTimeString<Microseconds>(durationTime * Poco::Timespan::MILLISECONDS, timeOutput, timeFormat);
+    return ToTimeString<Microseconds>(durationTime * 1000, timeOutput, timeFormat);
 }
 
 template<>
 WH_COMMON_API std::string Warhead::Time::ToTimeString<Seconds>(uint64 durationTime, TimeOutput timeOutput /*= TimeOutput::Seconds*/, TimeFormat timeFormat /*= TimeFormat::ShortText*/)
 {
-    return ToTimeString<Microseconds>(durationTime * Poco::Timespan::SECONDS, timeOutput, timeFormat);
+    return ToTimeString<Microseconds>(durationTime * 1000000, timeOutput, timeFormat);
 }
 
 template<>
 WH_COMMON_API std::string Warhead::Time::ToTimeString<Minutes>(uint64 durationTime, TimeOutput timeOutput /*= TimeOutput::Seconds*/, TimeFormat timeFormat /*= TimeFormat::ShortText*/)
 {
-    return ToTimeString<Microseconds>(durationTime * Poco::Timespan::MINUTES, timeOutput, timeFormat);
+    return ToTimeString<Microseconds>(durationTime * 1000000 * MINUTE, timeOutput, timeFormat);
 }
 
 template<>
@@ -189,6 +273,11 @@ std::string Warhead::Time::ToTimeString(Microseconds durationTime, TimeOutput ti
     return ToTimeString<Microseconds>(durationTime.count(), timeOutput, timeFormat);
 }
 
+void Warhead::Time::AppendTimeString(fmt::memory_buffer& buffer, Microseconds durationTime, TimeOutput timeOutput /*= TimeOutput::Seconds*/, TimeFormat timeFormat /*= TimeFormat::ShortText*/)
+{
+    AppendTimeString(buffer, uint64(durationTime.count()), timeOutput, timeFormat);
+}
+
 std::string Warhead::Time::TimeToTimestampStr(time_t t)
 {
     return Poco::DateTimeFormatter::format(Poco::Timestamp::fromEpochTime(t), Poco::DateTimeFormat::RFC1123_FORMAT);
@@ -196,9 +285,8 @@ std::string Warhead::Time::TimeToTimestampStr(time_t t)
 
 std::string Warhead::Time::TimeToHumanReadable(time_t t)
 {
-    std::stringstream ss;
-    ss << std::put_time(std::localtime(&t), "%Y-%m-%d %X");
-    return ss.str();
+    thread_local TimestampFormatter formatter("%Y-%m-%d %X");
+    return std::string(formatter.Format(t));
 }
 
 tm Warhead::Time::TimeBreakdown(time_t time)
@@ -20,6 +20,7 @@
 
 #include "Common.h"
 #include "Duration.h"
+#include <fmt/format.h>
 #include <string_view>
 
 enum class TimeFormat : uint8
@@ -52,11 +53,23 @@ namespace Warhead::Time
 
     WH_COMMON_API std::string ToTimeString(Microseconds durationTime, TimeOutput timeOutput = TimeOutput::Seconds, TimeFormat timeFormat = TimeFormat::ShortText);
 
+    /// Same output as ToTimeString<Microseconds>, appended to the given buffer without intermediate strings
+    WH_COMMON_API void AppendTimeString(fmt::memory_buffer& buffer, uint64 durationTime, TimeOutput timeOutput = TimeOutput::Seconds, TimeFormat timeFormat = TimeFormat::ShortText);
+    WH_COMMON_API void AppendTimeString(fmt::memory_buffer& buffer, Microseconds durationTime, TimeOutput timeOutput = TimeOutput::Seconds, TimeFormat timeFormat = TimeFormat::ShortText);
+
     WH_COMMON_API time_t LocalTimeToUTCTime(time_t time);
     WH_COMMON_API time_t GetLocalHourTimestamp(time_t time, uint8 hour, bool onlyAfterTime = true);
     WH_COMMON_API tm TimeBreakdown(time_t t);
     WH_COMMON_API std::string TimeToTimestampStr(time_t t);
     WH_COMMON_API std::string TimeToHumanReadable(time_t t);
+
+    /// Monotonic time in nanoseconds.
+    /// Reads the invariant TSC scaled by a startup calibration against steady_clock,
+    /// falls back to steady_clock if the CPU has no invariant TSC.
+    WH_COMMON_API uint64 Now();
+
+    /// Returns true if Now() is backed by the TSC
+    WH_COMMON_API bool IsTscClock();
 }
 
 inline TimePoint GetApplicationStartTime()
@@ -68,9 +81,9 @@ inline TimePoint GetApplicationStartTime()
 
 inline uint32 getMSTime()
 {
-    using namespace std::chrono;
+    static const uint64 ApplicationStartNs = Warhead::Time::Now();
 
-    return uint32(duration_cast<milliseconds>(steady_clock::now() - GetApplicationStartTime()).count());
+    return uint32((Warhead::Time::Now() - ApplicationStartNs) / 1000000);
 }
 
 inline uint32 getMSTimeDiff(uint32 oldMSTime, uint32 newMSTime)
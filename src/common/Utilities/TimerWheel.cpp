@@ -0,0 +1,408 @@
+/*
+ * This file is part of the WarheadApp Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "TimerWheel.h"
+#include "Log.h"
+#include "Timer.h"
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+namespace
+{
+    constexpr uint32 INVALID_NODE = UINT32_MAX;
+
+    // Farthest tick the top level can hold relative to the current one
+    constexpr uint64 MAX_TICKS = (uint64(1) << (Warhead::Time::TimerWheel::LEVELS * Warhead::Time::TimerWheel::SLOT_BITS)) - 1;
+
+    constexpr uint32 GetSlotIndex(uint32 level, uint32 slot)
+    {
+        return level * Warhead::Time::TimerWheel::SLOTS + slot;
+    }
+}
+
+Warhead::Time::TimerWheel::TimerWheel(Milliseconds resolution /*= 1ms*/, uint64 now /*= 0*/) :
+    _resolution(uint64(std::max<int64>(resolution.count(), 1)) * 1000000),
+    _start(now ? now : Now()),
+    _freeHead(INVALID_NODE),
+    _slots(new uint32[LEVELS * SLOTS])
+{
+    std::fill_n(_slots.get(), LEVELS * SLOTS, INVALID_NODE);
+}
+
+void Warhead::Time::TimerWheel::Reserve(std::size_t timers)
+{
+    _nodes.reserve(timers);
+}
+
+uint32 Warhead::Time::TimerWheel::AllocateNode()
+{
+    if (_freeHead != INVALID_NODE)
+    {
+        uint32 index = _freeHead;
+        _freeHead = _nodes[index].Next;
+        return index;
+    }
+
+    _nodes.emplace_back();
+    return uint32(_nodes.size() - 1);
+}
+
+void Warhead::Time::TimerWheel::FreeNode(uint32 index)
+{
+    Node& node = _nodes[index];
+    node.Callback = nullptr;
+    node.State = NodeState::Free;
+    ++node.Generation; // Invalidates outstanding ids
+    node.Next = _freeHead;
+    _freeHead = index;
+    --_active;
+}
+
+void Warhead::Time::TimerWheel::Insert(uint32 index)
+{
+    Node& node = _nodes[index];
+
+    if (node.Expiry < _currentTick)
+        node.Expiry = _currentTick;
+
+    // The level is the highest digit where the expiry differs from the current tick,
+    // the slot is the expiry's digit on that level
+    uint64 difference = node.Expiry ^ _currentTick;
+    uint32 level = 0;
+
+    while (level < LEVELS - 1 && (difference >> (SLOT_BITS * (level + 1))))
+        ++level;
+
+    uint32 slot = uint32(node.Expiry >> (SLOT_BITS * level)) & (SLOTS - 1);
+    uint32& head = _slots[GetSlotIndex(level, slot)];
+
+    node.Level = uint8(level);
+    node.Slot = uint16(slot);
+    node.Previous = INVALID_NODE;
+    node.Next = head;
+
+    if (head != INVALID_NODE)
+        _nodes[head].Previous = index;
+
+    head = index;
+}
+
+void Warhead::Time::TimerWheel::Unlink(uint32 index)
+{
+    Node& node = _nodes[index];
+
+    if (node.Previous != INVALID_NODE)
+        _nodes[node.Previous].Next = node.Next;
+    else
+        _slots[GetSlotIndex(node.Level, node.Slot)] = node.Next;
+
+    if (node.Next != INVALID_NODE)
+        _nodes[node.Next].Previous = node.Previous;
+}
+
+Warhead::Time::TimerId Warhead::Time::TimerWheel::Schedule(Milliseconds delay, TimerCallback callback, Milliseconds interval /*= 0ms*/)
+{
+    uint64 offset = uint64(std::max<int64>(delay.count(), 0)) * 1000000;
+    return ScheduleAt(_start + _currentTick * _resolution + offset, std::move(callback), interval);
+}
+
+Warhead::Time::TimerId Warhead::Time::TimerWheel::ScheduleAt(uint64 when, TimerCallback callback, Milliseconds interval /*= 0ms*/)
+{
+    uint64 tick = when > _start ? (when - _start + _resolution - 1) / _resolution : 0;
+    tick = std::clamp(tick, _currentTick + 1, _currentTick + MAX_TICKS);
+
+    uint32 index = AllocateNode();
+    Node& node = _nodes[index];
+
+    node.Callback = std::move(callback);
+    node.Expiry = tick;
+    node.Interval = interval.count() > 0 ? std::max<uint64>((uint64(interval.count()) * 1000000) / _resolution, 1) : 0;
+    node.State = NodeState::Scheduled;
+
+    Insert(index);
+    ++_active;
+
+    return (uint64(node.Generation) << 32) | (index + 1);
+}
+
+bool Warhead::Time::TimerWheel::Cancel(TimerId id)
+{
+    uint32 index = uint32(id & 0xFFFFFFFF) - 1;
+
+    if (!id || index >= _nodes.size())
+        return false;
+
+    Node& node = _nodes[index];
+
+    if (node.Generation != uint32(id >> 32))
+        return false;
+
+    switch (node.State)
+    {
+        case NodeState::Scheduled:
+            Unlink(index);
+            FreeNode(index);
+            return true;
+        case NodeState::Firing:
+            // Fire() frees it once the callback returned
+            node.State = NodeState::Cancelled;
+            return true;
+        default:
+            return false;
+    }
+}
+
+void Warhead::Time::TimerWheel::Cascade(uint32 level, uint64 tick)
+{
+    uint32& head = _slots[GetSlotIndex(level, uint32(tick >> (SLOT_BITS * level)) & (SLOTS - 1))];
+    uint32 index = head;
+    head = INVALID_NODE;
+
+    // Everything in the slot is due within this level's span now and moves further down
+    while (index != INVALID_NODE)
+    {
+        uint32 next = _nodes[index].Next;
+        Insert(index);
+        index = next;
+    }
+}
+
+std::size_t Warhead::Time::TimerWheel::Fire(uint64 tick)
+{
+    std::size_t fired = 0;
+    uint32& head = _slots[GetSlotIndex(0, uint32(tick) & (SLOTS - 1))];
+
+    // Taken one at a time, a callback may cancel the others in this slot
+    while (head != INVALID_NODE)
+    {
+        uint32 index = head;
+        Unlink(index);
+
+        // The callback is moved out, nodes may be reallocated when it schedules new timers
+        TimerCallback callback = std::move(_nodes[index].Callback);
+        _nodes[index].State = NodeState::Firing;
+
+        try
+        {
+            callback();
+        }
+        catch (std::exception const& e)
+        {
+            LOG_ERROR("> TimerWheel: timer callback failed with %s", e.what());
+        }
+        catch (...)
+        {
+            LOG_ERROR("> TimerWheel: timer callback failed with an unknown exception");
+        }
+
+        ++fired;
+
+        Node& node = _nodes[index];
+
+        if (node.Interval && node.State == NodeState::Firing)
+        {
+            node.Callback = std::move(callback);
+            node.Expiry = tick + node.Interval;
+            node.State = NodeState::Scheduled;
+            Insert(index);
+        }
+        else
+            FreeNode(index);
+    }
+
+    return fired;
+}
+
+std::size_t Warhead::Time::TimerWheel::Advance(uint64 now)
+{
+    uint64 target = now > _start ? (now - _start) / _resolution : 0;
+    std::size_t fired = 0;
+
+    while (_currentTick < target)
+    {
+        // Nothing can fire, skip the idle ticks
+        if (!_active)
+        {
+            _currentTick = target;
+            break;
+        }
+
+        uint64 tick = ++_currentTick;
+
+        // Highest level whose lower digits just wrapped, cascade top down so
+        // timers can drop more than one level in the same tick
+        uint32 level = 0;
+
+        while (level < LEVELS - 1 && !(tick & ((uint64(1) << (SLOT_BITS * (level + 1))) - 1)))
+            ++level;
+
+        for (; level > 0; --level)
+            Cascade(level, tick);
+
+        fired += Fire(tick);
+    }
+
+    return fired;
+}
+
+struct Warhead::Time::TimerService::Shard
+{
+    struct Command
+    {
+        TimerId Id;
+        uint64 When;
+        TimerCallback Callback; // Empty = cancel
+        Milliseconds Interval;
+    };
+
+    explicit Shard(Milliseconds resolution) :
+        Resolution(resolution), Wheel(resolution)
+    {
+        Thread = std::thread([this]() { Run(); });
+    }
+
+    ~Shard()
+    {
+        {
+            std::lock_guard<std::mutex> guard(Lock);
+            Stop = true;
+        }
+
+        Condition.notify_one();
+        Thread.join();
+    }
+
+    void Push(Command&& command)
+    {
+        bool idle;
+
+        {
+            std::lock_guard<std::mutex> guard(Lock);
+            Commands.emplace_back(std::move(command));
+            idle = Idle;
+        }
+
+        // A busy shard picks the command up on its next tick
+        if (idle)
+            Condition.notify_one();
+    }
+
+    void Apply(Command& command)
+    {
+        if (!command.Callback)
+        {
+            auto itr = Timers.find(command.Id);
+            if (itr == Timers.end())
+                return;
+
+            Wheel.Cancel(itr->second);
+            Timers.erase(itr);
+            return;
+        }
+
+        TimerCallback callback = std::move(command.Callback);
+
+        if (command.Interval == 0ms)
+        {
+            callback = [this, id = command.Id, function = std::move(callback)]()
+            {
+                Timers.erase(id);
+                function();
+            };
+        }
+
+        Timers.emplace(command.Id, Wheel.ScheduleAt(command.When, std::move(callback), command.Interval));
+    }
+
+    void Run()
+    {
+        std::vector<Command> commands;
+
+        for (;;)
+        {
+            {
+                std::unique_lock<std::mutex> lock(Lock);
+
+                if (Commands.empty() && !Stop)
+                {
+                    if (Wheel.Empty())
+                    {
+                        Idle = true;
+                        Condition.wait(lock, [this]() { return Stop || !Commands.empty(); });
+                        Idle = false;
+                    }
+                    else
+                        Condition.wait_for(lock, Resolution);
+                }
+
+                if (Stop)
+                    return;
+
+                commands.swap(Commands);
+            }
+
+            for (Command& command : commands)
+                Apply(command);
+
+            commands.clear();
+            Wheel.Advance(Now());
+        }
+    }
+
+    Milliseconds Resolution;
+
+    std::mutex Lock;
+    std::condition_variable Condition;
+    std::vector<Command> Commands;
+    bool Idle = false;
+    bool Stop = false;
+
+    // Owned by the shard thread
+    TimerWheel Wheel;
+    std::unordered_map<TimerId, TimerId> Timers; // Service id -> wheel id
+
+    std::thread Thread;
+};
+
+Warhead::Time::TimerService::TimerService(uint32 threads /*= 1*/, Milliseconds resolution /*= 1ms*/)
+{
+    for (uint32 i = 0; i < std::max<uint32>(threads, 1); ++i)
+        _shards.emplace_back(std::make_unique<Shard>(resolution));
+}
+
+Warhead::Time::TimerService::~TimerService() = default;
+
+Warhead::Time::TimerId Warhead::Time::TimerService::Schedule(Milliseconds delay, TimerCallback callback, Milliseconds interval /*= 0ms*/)
+{
+    TimerId id = _nextId.fetch_add(1, std::memory_order_relaxed) + 1;
+    uint64 when = Now() + uint64(std::max<int64>(delay.count(), 0)) * 1000000;
+
+    _shards[id % _shards.size()]->Push({ id, when, std::move(callback), interval });
+    return id;
+}
+
+void Warhead::Time::TimerService::Cancel(TimerId id)
+{
+    if (!id)
+        return;
+
+    _shards[id % _shards.size()]->Push({ id, 0, nullptr, 0ms });
+}
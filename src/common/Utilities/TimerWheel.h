@@ -0,0 +1,138 @@
+/*
+ * This file is part of the WarheadApp Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef _WARHEAD_TIMER_WHEEL_H_
+#define _WARHEAD_TIMER_WHEEL_H_
+
+#include "Define.h"
+#include "Duration.h"
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace Warhead::Time
+{
+    /// 0 is never a valid timer
+    using TimerId = uint64;
+
+    using TimerCallback = std::function<void()>;
+
+    /// Hierarchical hashed timer wheel: 5 levels of 256 slots, so with 1ms ticks timers may be
+    /// up to 34 years away. Schedule and cancel are O(1), every tick fires one slot as a batch and
+    /// a slot of the next level is spread over the lower levels when a level wraps.
+    ///
+    /// Not thread safe. A thread that owns its timers keeps a wheel and calls Advance() from its own loop,
+    /// callbacks then run on that thread and need no locking. See TimerService for timers shared between threads.
+    class WH_COMMON_API TimerWheel
+    {
+    public:
+        static constexpr uint32 LEVELS = 5;
+        static constexpr uint32 SLOT_BITS = 8;
+        static constexpr uint32 SLOTS = 1 << SLOT_BITS;
+
+        /// now: Warhead::Time::Now() value the wheel starts at, 0 = current time
+        explicit TimerWheel(Milliseconds resolution = 1ms, uint64 now = 0);
+
+        TimerWheel(TimerWheel const&) = delete;
+        TimerWheel& operator=(TimerWheel const&) = delete;
+
+        /// Relative to the time of the last Advance(). A non zero interval repeats the timer until it is cancelled.
+        TimerId Schedule(Milliseconds delay, TimerCallback callback, Milliseconds interval = 0ms);
+
+        /// At a Warhead::Time::Now() value, rounded up to the next tick
+        TimerId ScheduleAt(uint64 when, TimerCallback callback, Milliseconds interval = 0ms);
+
+        /// False if the timer already fired or was cancelled. Cancelling from inside the timer's own callback stops a repeating timer.
+        bool Cancel(TimerId id);
+
+        /// Fires everything due up to now (Warhead::Time::Now() value), returns the number of callbacks run.
+        /// Callbacks may schedule and cancel timers on this wheel.
+        std::size_t Advance(uint64 now);
+
+        std::size_t GetActiveCount() const { return _active; }
+        bool Empty() const { return !_active; }
+
+        /// Preallocates room for the given number of timers
+        void Reserve(std::size_t timers);
+
+    private:
+        enum class NodeState : uint8
+        {
+            Free,
+            Scheduled,
+            Firing,
+            Cancelled   // Cancelled while firing
+        };
+
+        struct Node
+        {
+            TimerCallback Callback;
+            uint64 Expiry = 0;          // Tick
+            uint64 Interval = 0;        // Ticks, 0 = one shot
+            uint32 Previous = 0;
+            uint32 Next = 0;
+            uint32 Generation = 0;
+            uint16 Slot = 0;
+            uint8 Level = 0;
+            NodeState State = NodeState::Free;
+        };
+
+        uint32 AllocateNode();
+        void FreeNode(uint32 index);
+        void Insert(uint32 index);
+        void Unlink(uint32 index);
+        void Cascade(uint32 level, uint64 tick);
+        std::size_t Fire(uint64 tick);
+
+        uint64 _resolution;         // Nanoseconds per tick
+        uint64 _start;
+        uint64 _currentTick = 0;    // Last processed tick
+        std::size_t _active = 0;
+
+        std::vector<Node> _nodes;
+        uint32 _freeHead;
+        std::unique_ptr<uint32[]> _slots; // LEVELS * SLOTS list heads
+    };
+
+    /// Thread safe timers on top of TimerWheel, callbacks run on the service threads.
+    /// With several threads every timer belongs to one shard (wheel, thread, lock), which keeps
+    /// producers of many timers, like connection timeouts, from contending on a single lock.
+    class WH_COMMON_API TimerService
+    {
+    public:
+        explicit TimerService(uint32 threads = 1, Milliseconds resolution = 1ms);
+        ~TimerService();
+
+        TimerService(TimerService const&) = delete;
+        TimerService& operator=(TimerService const&) = delete;
+
+        TimerId Schedule(Milliseconds delay, TimerCallback callback, Milliseconds interval = 0ms);
+
+        /// Asynchronous, a callback that is already running finishes
+        void Cancel(TimerId id);
+
+    private:
+        struct Shard;
+
+        std::vector<std::unique_ptr<Shard>> _shards;
+        std::atomic<TimerId> _nextId{ 0 };
+    };
+}
+
+#endif // _WARHEAD_TIMER_WHEEL_H_
@@ -0,0 +1,64 @@
+/*
+ * This file is part of the WarheadApp Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "TimestampFormatter.h"
+#include "Timer.h"
+
+Warhead::Time::TimestampFormatter::TimestampFormatter(std::string format, TimestampPrecision precision /*= TimestampPrecision::Seconds*/) :
+    _format(std::move(format)), _precision(precision), _prefixSize(0), _cachedSecond(0), _hasCache(false) { }
+
+std::string_view Warhead::Time::TimestampFormatter::Format(time_t seconds, uint32 microseconds /*= 0*/)
+{
+    if (!_hasCache || seconds != _cachedSecond)
+    {
+        tm timeLocal = TimeBreakdown(seconds);
+
+        char prefix[128];
+        _prefixSize = std::strftime(prefix, sizeof(prefix), _format.c_str(), &timeLocal);
+        _buffer.assign(prefix, _prefixSize);
+
+        switch (_precision)
+        {
+            case TimestampPrecision::Milliseconds:
+                _buffer.append(".000");
+                break;
+            case TimestampPrecision::Microseconds:
+                _buffer.append(".000000");
+                break;
+            default:
+                break;
+        }
+
+        _cachedSecond = seconds;
+        _hasCache = true;
+    }
+
+    if (_precision == TimestampPrecision::Seconds)
+        return _buffer;
+
+    uint32 fraction = _precision == TimestampPrecision::Milliseconds ? microseconds / 1000 : microseconds;
+
+    // Rewrite only the sub-second digits, from the last one
+    for (std::size_t i = _buffer.size(); i > _prefixSize + 1; --i)
+    {
+        _buffer[i - 1] = char('0' + fraction % 10);
+        fraction /= 10;
+    }
+
+    return _buffer;
+}
@@ -0,0 +1,58 @@
+/*
+ * This file is part of the WarheadApp Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef _WARHEAD_TIMESTAMP_FORMATTER_H_
+#define _WARHEAD_TIMESTAMP_FORMATTER_H_
+
+#include "Define.h"
+#include <ctime>
+#include <string>
+#include <string_view>
+
+namespace Warhead::Time
+{
+    enum class TimestampPrecision : uint8
+    {
+        Seconds,        // 12:30:45
+        Milliseconds,   // 12:30:45.123
+        Microseconds    // 12:30:45.123456
+    };
+
+    /// Formats local time with a strftime pattern plus optional sub-second digits.
+    /// The broken-down local time and the formatted text are cached for the current second,
+    /// further timestamps in the same second only rewrite the sub-second digits.
+    /// Not thread-safe, intended to be used as a thread_local instance.
+    class WH_COMMON_API TimestampFormatter
+    {
+    public:
+        explicit TimestampFormatter(std::string format, TimestampPrecision precision = TimestampPrecision::Seconds);
+
+        /// Returned view is valid until the next call
+        std::string_view Format(time_t seconds, uint32 microseconds = 0);
+
+    private:
+        std::string _format;
+        TimestampPrecision _precision;
+        std::string _buffer;
+        std::size_t _prefixSize;
+        time_t _cachedSecond;
+        bool _hasCache;
+    };
+}
+
+#endif // _WARHEAD_TIMESTAMP_FORMATTER_H_
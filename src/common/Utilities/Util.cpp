@@ -16,29 +16,46 @@
  */
 
 #include "Util.h"
+#include "AsyncIO.h"
 #include "Common.h"
+#include "DirectoryScanner.h"
 #include "Log.h"
 #include <Poco/Path.h>
 #include <Poco/File.h>
+#include <atomic>
 #include <filesystem>
-#include <fstream>
+#include <mutex>
 
-std::vector<std::string_view> Warhead::Tokenize(std::string_view str, char sep, bool keepEmpty)
+namespace
 {
-    std::vector<std::string_view> tokens;
-
-    size_t start = 0;
-    for (size_t end = str.find(sep); end != std::string_view::npos; end = str.find(sep, start))
+    template<class Vector>
+    void TokenizeTo(Vector& tokens, std::string_view str, char sep, bool keepEmpty)
     {
-        if (keepEmpty || (start < end))
-            tokens.push_back(str.substr(start, end - start));
+        size_t start = 0;
+        for (size_t end = str.find(sep); end != std::string_view::npos; end = str.find(sep, start))
+        {
+            if (keepEmpty || (start < end))
+                tokens.push_back(str.substr(start, end - start));
 
-        start = end + 1;
+            start = end + 1;
+        }
+
+        if (keepEmpty || (start < str.length()))
+            tokens.push_back(str.substr(start));
     }
+}
 
-    if (keepEmpty || (start < str.length()))
-        tokens.push_back(str.substr(start));
+std::vector<std::string_view> Warhead::Tokenize(std::string_view str, char sep, bool keepEmpty)
+{
+    std::vector<std::string_view> tokens;
+    TokenizeTo(tokens, str, sep, keepEmpty);
+    return tokens;
+}
 
+std::pmr::vector<std::string_view> Warhead::Tokenize(std::string_view str, char sep, bool keepEmpty, std::pmr::memory_resource* resource)
+{
+    std::pmr::vector<std::string_view> tokens(resource);
+    TokenizeTo(tokens, str, sep, keepEmpty);
     return tokens;
 }
 
@@ -49,84 +66,98 @@ bool StringEqualI(std::string_view a, std::string_view b)
 
 std::string Warhead::File::GetFileText(std::string const& path, bool openBinary /*= false*/)
 {
-    std::filesystem::path _path(path);
-
-    int openMode = std::ios_base::in;
-
-    if (openBinary)
-        openMode |= std::ios_base::binary;
-
-    std::ifstream in(_path, openMode);
+    std::optional<std::string> text = Warhead::IO::ReadFile(path);
 
-    if (!in.is_open())
+    if (!text)
     {
-        LOG_FATAL("> Failed to open file (%s)", _path.generic_string().c_str());
+        LOG_FATAL("> Failed to open file (%s)", path.c_str());
         return "";
     }
 
-    auto text = [&in]
+    // Same result as a text mode stream on Windows, CRLF becomes LF
+    std::size_t size = openBinary ? std::string::npos : text->find('\r');
+
+    if (size != std::string::npos)
     {
-        std::ostringstream ss;
-        ss << in.rdbuf();
-        return ss.str();
-    }();
+        std::string& data = *text;
+
+        // Everything before the first CR stays in place
+        for (std::size_t i = size; i < data.size(); ++i)
+            if (data[i] != '\r' || i + 1 == data.size() || data[i + 1] != '\n')
+                data[size++] = data[i];
+
+        data.resize(size);
+    }
 
-    in.close();
-    return text;
+    return std::move(*text);
 }
 
-bool Warhead::File::FindFile(std::string_view findName, std::string const& pathFind, bool recursive /*= false*/)
+namespace
 {
-    Poco::Path currPath(pathFind);
-
-    for (auto const& dirEntry : std::filesystem::directory_iterator(currPath.absolute().toString()))
+    // UTF-8 in and out, as ScanDirectory expects
+    std::string GetAbsolutePath(std::string const& path)
     {
-        auto const& path = dirEntry.path();
+        std::error_code error;
+        std::filesystem::path absolutePath = std::filesystem::absolute(std::filesystem::u8path(path), error);
+        return error ? path : absolutePath.generic_u8string();
+    }
+}
 
-        if (std::filesystem::is_directory(path) && recursive)
-            FindFile(findName, pathFind, true);
+bool Warhead::File::FindFile(std::string_view findName, std::string const& pathFind, bool recursive /*= false*/)
+{
+    // Directories match by name too, as they always did
+    ScanOptions options;
+    options.Recursive = recursive;
+    options.IncludeDirectories = true;
+
+    std::atomic<bool> found{ false };
 
-        if (path.filename().generic_string() == findName)
+    ScanDirectory(GetAbsolutePath(pathFind), [&found, findName](ScanEntry const& entry)
+    {
+        if (entry.Name != findName)
             return true;
-    }
 
-    return false;
+        found = true;
+        return false;
+    }, options);
+
+    return found;
 }
 
 bool Warhead::File::FindDirectory(std::string_view findName, std::string const& pathFind, bool recursive /*= false*/)
 {
-    Poco::Path currPath(pathFind);
-
-    for (auto const& dirEntry : std::filesystem::directory_iterator(currPath.absolute().toString()))
-    {
-        auto const& path = dirEntry.path();
+    ScanOptions options;
+    options.Recursive = recursive;
+    options.IncludeDirectories = true;
 
-        if (!std::filesystem::is_directory(path))
-            continue;
+    std::atomic<bool> found{ false };
 
-        if (path.filename() == findName)
+    ScanDirectory(GetAbsolutePath(pathFind), [&found, findName](ScanEntry const& entry)
+    {
+        if (entry.Type != EntryType::Directory || entry.Name != findName)
             return true;
 
-        if (recursive)
-            FindDirectory(findName, pathFind, true);
-    }
+        found = true;
+        return false;
+    }, options);
 
-    return false;
+    return found;
 }
 
 void Warhead::File::FillFileList(std::vector<std::string>& pathList, std::string const& pathFill, bool recursive /*= false*/)
 {
-    Poco::Path currPath(pathFill);
+    ScanOptions options;
+    options.Recursive = recursive;
+    options.IncludeDirectories = true;
 
-    for (auto const& dirEntry : std::filesystem::directory_iterator(currPath.absolute().toString()))
-    {
-        auto const& path = dirEntry.path();
-
-        if (std::filesystem::is_directory(path) && recursive)
-            FillFileList(pathList, pathFill, true);
+    std::mutex lock;
 
-        pathList.emplace_back(path.generic_string());
-    }
+    ScanDirectory(GetAbsolutePath(pathFill), [&pathList, &lock](ScanEntry const& entry)
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        pathList.emplace_back(entry.Path);
+        return true;
+    }, options);
 }
 
 std::string Warhead::File::GetFileName(std::string const& filePath)
@@ -19,6 +19,7 @@
 #define _UTIL_H
 
 #include "Define.h"
+#include <memory_resource>
 #include <sstream>
 #include <string>
 #include <utility>
@@ -34,13 +35,24 @@ namespace Warhead
 
     /* the delete overload means we need to make this explicit */
     inline std::vector<std::string_view> Tokenize(char const* str, char sep, bool keepEmpty) { return Tokenize(std::string_view(str ? str : ""), sep, keepEmpty); }
+
+    /// Same, the vector lives in the resource, e.g. Warhead::Arena::GetResource() of the current request
+    WH_COMMON_API std::pmr::vector<std::string_view> Tokenize(std::string_view str, char sep, bool keepEmpty, std::pmr::memory_resource* resource);
+
+    std::pmr::vector<std::string_view> Tokenize(std::string&&, char, bool, std::pmr::memory_resource*) = delete;
+    std::pmr::vector<std::string_view> Tokenize(std::string const&&, char, bool, std::pmr::memory_resource*) = delete;
+
+    inline std::pmr::vector<std::string_view> Tokenize(char const* str, char sep, bool keepEmpty, std::pmr::memory_resource* resource) { return Tokenize(std::string_view(str ? str : ""), sep, keepEmpty, resource); }
 }
 
 WH_COMMON_API bool StringEqualI(std::string_view str1, std::string_view str2);
 
 namespace Warhead::File
 {
+    /// One read of the exact file size, openBinary = false only turns CRLF into LF.
+    /// Warhead::IO::FileView gives a read-only view of large files without the copy.
     WH_COMMON_API std::string GetFileText(std::string const& path, bool openBinary = false);
+    /// Any entry named findName counts, directories included. Paths are UTF-8.
     WH_COMMON_API bool FindFile(std::string_view findName, std::string const& pathFind, bool recursive = false);
     WH_COMMON_API bool FindDirectory(std::string_view findName, std::string const& pathFind, bool recursive = false);
     WH_COMMON_API void FillFileList(std::vector<std::string>& pathList, std::string const& pathFill, bool recursive = false);